@@ -0,0 +1,162 @@
+// xmath_fft_check.cpp
+// created by agent on 19-Oct-2026
+// accuracy and timing of the FFT-based XMath::gaussianSmoothing and
+// XMath::trigonResampling against the former direct implementations
+//
+// not part of the solver build; compile and run from SOLVER/develop with
+// the FFTW used by the solver, e.g.
+//   g++ -std=c++11 -O3 -DNDEBUG -D_NPOL=4 -D_PROJECT_DIR=\"..\" \
+//       -D_FFTW_WISDOM_DIR=\".\" -I../src -I../src/core -I../src/preloop \
+//       -I../src/preloop/utilities -I<eigen> -I<boost> -I<fftw>/include \
+//       xmath_fft_check.cpp ../src/preloop/utilities/XMath.cpp \
+//       ../src/preloop/utilities/PreloopFFTW.cpp -L<fftw>/lib -lfftw3 \
+//       -o xmath_fft_check && ./xmath_fft_check
+// exits with 1 if any deviation exceeds the tolerance
+
+#include "XMath.h"
+#include "PreloopFFTW.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+namespace {
+    // former XMath::gaussianSmoothing, direct convolution
+    void gaussianSmoothingDirect(RDColX &data, int order, double dev, bool period) {
+        if (order <= 0) return;
+        order = std::min(order, (int)((data.size() + 1) / 2 - 1));
+        dev *= order;
+        RDColX gaussian(order * 2 + 1);
+        for (int i = 0; i <= order; i++) {
+            gaussian(order + i) = exp(- .5 * i * i / (dev * dev));
+            gaussian(order - i) = gaussian(order + i);
+        }
+        gaussian /= gaussian.sum();
+        RDColX result = RDColX::Zero(data.size());
+        for (int i = 0; i < data.size(); i++) {
+            for (int j = -order; j <= order; j++) {
+                int k = i + j;
+                if (period) {
+                    while (k < 0) k += data.size();
+                    while (k > data.size() - 1) k -= data.size();
+                } else {
+                    if (k < 0) k = 0;
+                    if (k > data.size() - 1) k = data.size() - 1;
+                }
+                result(i) += gaussian(j + order) * data(k);
+            }
+        }
+        data = result;
+    }
+
+    // former XMath::trigonResampling, direct synthesis
+    RDColX trigonResamplingDirect(int newSize, const RDColX &original) {
+        int nslices = original.rows();
+        if (newSize == nslices) return original;
+        if (XMath::equalRows(original)) return RDColX::Constant(newSize, original(0));
+        PreloopFFTW::getR2C_RMat(nslices) = original;
+        PreloopFFTW::computeR2C(nslices);
+        CDColX fourier = PreloopFFTW::getR2C_CMat(nslices);
+        double dphi = 2. * pi / newSize;
+        RDColX densed(newSize);
+        for (int islice = 0; islice < newSize; islice++) {
+            double phi = islice * dphi;
+            double value_phi = fourier(0).real();
+            for (int alpha = 1; alpha < fourier.size(); alpha++) {
+                double factor = (nslices % 2 == 0 && alpha == fourier.size() - 1) ? 1. : 2.;
+                value_phi += factor * (fourier(alpha) * exp(alpha * phi * iid)).real();
+            }
+            densed(islice) = value_phi;
+        }
+        return densed;
+    }
+
+    // relative max deviation
+    double deviation(const RDColX &a, const RDColX &b) {
+        return (a - b).array().abs().maxCoeff() / std::max(b.array().abs().maxCoeff(), tinyDouble);
+    }
+
+    // average walltime of a call in microseconds
+    template<typename Func>
+    double timing(Func func, int nrepeat) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nrepeat; i++) func();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / nrepeat;
+    }
+}
+
+int main() {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    auto random = [&](int n) {
+        RDColX v(n);
+        for (int i = 0; i < n; i++) v(i) = dist(gen);
+        return v;
+    };
+    const double tolerance = 1e-12;
+    double maxDevSmooth = 0., maxDevResample = 0.;
+
+    ////////// accuracy //////////
+    // gaussian smoothing, both padding modes and all admissible orders
+    for (int nsize: {3, 4, 7, 16, 31, 90, 180, 360, 721}) {
+        for (bool period: {true, false}) {
+            for (int order = 1; order <= (nsize + 1) / 2; order++) {
+                for (double dev: {.25, .5, 1.}) {
+                    RDColX data = random(nsize);
+                    RDColX ref = data;
+                    gaussianSmoothingDirect(ref, order, dev, period);
+                    XMath::gaussianSmoothing(data, order, dev, period);
+                    maxDevSmooth = std::max(maxDevSmooth, deviation(data, ref));
+                }
+            }
+        }
+    }
+    // trigonometric resampling, up and down, odd and even
+    for (int nslices: {2, 3, 4, 5, 8, 15, 16, 63, 64, 200}) {
+        for (int newSize: {1, 2, 3, 7, 8, 16, 33, 64, 101, 256, 1000}) {
+            RDColX data = random(nslices);
+            maxDevResample = std::max(maxDevResample, deviation(
+                XMath::trigonResampling(newSize, data), trigonResamplingDirect(newSize, data)));
+        }
+    }
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "max relative deviation, gaussianSmoothing: " << maxDevSmooth << std::endl;
+    std::cout << "max relative deviation, trigonResampling:  " << maxDevResample << std::endl;
+
+    ////////// timing //////////
+    std::cout << std::fixed << std::setprecision(2) << std::endl;
+    std::cout << "gaussianSmoothing (us per call)" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(8) << "order" << std::setw(8) << "period"
+        << std::setw(12) << "direct" << std::setw(12) << "fft" << std::setw(10) << "speedup" << std::endl;
+    // crust1 grids (180 x 360) with typical and wide kernels
+    for (int nsize: {180, 360, 720}) {
+        for (int order: {3, 10, 40}) {
+            for (bool period: {true, false}) {
+                RDColX data = random(nsize);
+                int nrepeat = std::max(10, 2000000 / (nsize * order));
+                double tDirect = timing([&]() {RDColX d = data; gaussianSmoothingDirect(d, order, 1., period);}, nrepeat);
+                double tFFT = timing([&]() {RDColX d = data; XMath::gaussianSmoothing(d, order, 1., period);}, nrepeat);
+                std::cout << std::setw(8) << nsize << std::setw(8) << order << std::setw(8) << period
+                    << std::setw(12) << tDirect << std::setw(12) << tFFT << std::setw(10) << tDirect / tFFT << std::endl;
+            }
+        }
+    }
+    std::cout << std::endl << "trigonResampling (us per call)" << std::endl;
+    std::cout << std::setw(8) << "Nr" << std::setw(8) << "newSize"
+        << std::setw(12) << "direct" << std::setw(12) << "fft" << std::setw(10) << "speedup" << std::endl;
+    // relabelling: Nr -> 5 Nr (hmin check) and Nr -> Nr - 1 -> Nr (dZ)
+    for (int nr: {20, 100, 500, 2000}) {
+        for (int newSize: {5 * nr, nr - 1}) {
+            RDColX data = random(nr);
+            int nrepeat = std::max(10, 20000000 / (nr * newSize));
+            double tDirect = timing([&]() {trigonResamplingDirect(newSize, data);}, nrepeat);
+            double tFFT = timing([&]() {XMath::trigonResampling(newSize, data);}, nrepeat);
+            std::cout << std::setw(8) << nr << std::setw(8) << newSize
+                << std::setw(12) << tDirect << std::setw(12) << tFFT << std::setw(10) << tDirect / tFFT << std::endl;
+        }
+    }
+
+    PreloopFFTW::finalize();
+    return (maxDevSmooth < tolerance && maxDevResample < tolerance) ? 0 : 1;
+}
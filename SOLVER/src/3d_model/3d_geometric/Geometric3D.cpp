@@ -71,6 +71,29 @@ void Geometric3D::buildInparam(std::vector<Geometric3D *> &models,
     }
 }
 
+void Geometric3D::getDeltaRBatch(const RDMatX3 &rtp, const RDColX &rElemCenter, RDColX &deltaR) const {
+    deltaR = RDColX(rtp.rows());
+    for (int i = 0; i < rtp.rows(); i++) 
+        deltaR(i) = getDeltaR(rtp(i, 0), rtp(i, 1), rtp(i, 2), rElemCenter(i));
+}
+
+double Geometric3D::getDeltaR(double r, double theta, double phi, double rElemCenter, 
+    double &deltaR_r) const {
+    // rElemCenter is fixed, so the same layer is sampled on both sides
+    double dr = 1.;
+    deltaR_r = (getDeltaR(r + dr, theta, phi, rElemCenter) - 
+        getDeltaR(r - dr, theta, phi, rElemCenter)) / (2. * dr);
+    return getDeltaR(r, theta, phi, rElemCenter);
+}
+
+void Geometric3D::getDeltaRBatch(const RDMatX3 &rtp, const RDColX &rElemCenter, 
+    RDColX &deltaR, RDColX &deltaR_r) const {
+    deltaR = RDColX(rtp.rows());
+    deltaR_r = RDColX(rtp.rows());
+    for (int i = 0; i < rtp.rows(); i++) 
+        deltaR(i) = getDeltaR(rtp(i, 0), rtp(i, 1), rtp(i, 2), rElemCenter(i), deltaR_r(i));
+}
+
 // bool Geometric3D::getNablaDeltaR(double r, double theta, double phi, double rElemCenter,
 //     double &deltaR_r, double &deltaR_theta, double &deltaR_phi) const {
 //     // original value
@@ -5,6 +5,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "eigenp.h"
 
 class Parameters;
 
@@ -28,6 +29,21 @@ public:
     // the conversions internally
     virtual double getDeltaR(double r, double theta, double phi, double rElemCenter) const = 0;
     
+    // batch version of getDeltaR, one location (r, theta, phi) per row
+    // the default loops over getDeltaR
+    virtual void getDeltaRBatch(const RDMatX3 &rtp, const RDColX &rElemCenter, RDColX &deltaR) const;
+    
+    // get deltaR and its radial derivative deltaR_r = d(deltaR)/d(r) at fixed rElemCenter
+    // used by Newton iterations in locating source and receivers
+    // the default uses central difference, analytic versions are preferred
+    virtual double getDeltaR(double r, double theta, double phi, double rElemCenter, 
+        double &deltaR_r) const;
+    
+    // batch version of getDeltaR with radial derivative
+    // the default loops over getDeltaR with radial derivative
+    virtual void getDeltaRBatch(const RDMatX3 &rtp, const RDColX &rElemCenter, 
+        RDColX &deltaR, RDColX &deltaR_r) const;
+    
     // // get gradient of deltaR
     // // deltaR_r     = d(deltaR)/d(r)
     // // deltaR_theta = d(deltaR)/d(theta) / r
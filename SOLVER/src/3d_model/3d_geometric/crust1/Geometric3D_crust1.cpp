@@ -9,26 +9,51 @@
 #include <fstream>
 #include "XMPI.h"
 #include "XMath.h"
+#include "ModelCache.h"
 
 const int Geometric3D_crust1::sNLayer = 9;
 const int Geometric3D_crust1::sNLat = 180;
 const int Geometric3D_crust1::sNLon = 360;
 
+Geometric3D_crust1::~Geometric3D_crust1() {
+    delete mCache;
+}
+
 void Geometric3D_crust1::initialize() {
+    if (mIncludeIce) mIncludeSediment = true;
+    
+    // smoothed undulations are cached on disk, keyed by all options
+    // that affect them; raw data are only read and processed on root
+    // when the cache misses
+    mCache = new ModelCache("crust1_geometric");
+    mCache->addToKey(mRSurf);
+    mCache->addToKey(mRMoho);
+    mCache->addToKey(mIncludeIce);
+    mCache->addToKey(mIncludeSediment);
+    mCache->addToKey(mSurfFactor);
+    mCache->addToKey(mMohoFactor);
+    mCache->addToKey(mGaussianOrder);
+    mCache->addToKey(mGaussianDev);
+    mCache->addFileToKey(projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds");
+    if (!mCache->load()) {
+        if (XMPI::root()) processRawData();
+        mCache->store();
+    }
+    mCache->mapArray("delta_r_surf", mDeltaRSurf);
+    mCache->mapArray("delta_r_moho", mDeltaRMoho);
+}
+
+void Geometric3D_crust1::processRawData() {
     // read raw data
     int nrow = sNLat * sNLon;
     RDMatXX elevation = RDMatXX::Zero(nrow, sNLayer);
-    if (XMPI::root()) {
-        std::string fname = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds";
-        std::fstream fs(fname, std::fstream::in);
-        if (!fs) throw std::runtime_error("Geometric3D_crust1::initialize || "
-            "Error opening crust1.0 data file: ||" + fname);
-        for (int i = 0; i < nrow; i++)
-            for (int j = 0; j < sNLayer; j++) fs >> elevation(i, j);    
-        fs.close();
-    }
-    // broadcast
-    XMPI::bcastEigen(elevation);
+    std::string fname = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds";
+    std::fstream fs(fname, std::fstream::in);
+    if (!fs) throw std::runtime_error("Geometric3D_crust1::processRawData || "
+        "Error opening crust1.0 data file: ||" + fname);
+    for (int i = 0; i < nrow; i++)
+        for (int j = 0; j < sNLayer; j++) fs >> elevation(i, j);    
+    fs.close();
     
     // surface and moho undulations
     // NOTE: ellipticity should not be considered here because all geometric 
@@ -36,7 +61,6 @@ void Geometric3D_crust1::initialize() {
     int colSurf = 5; // no ice, no sediment
     if (mIncludeIce) {
         colSurf = 1; // ice
-        mIncludeSediment = true;
     } else if (mIncludeSediment) {
         colSurf = 2; // sediment
     }
@@ -75,22 +99,26 @@ void Geometric3D_crust1::initialize() {
     XMath::gaussianSmoothing(deltaRMoho, orderRow, devRow, true, orderCol, devCol, false);
     
     // cast to integer theta with unique polar values
-    mDeltaRSurf = RDMatXX::Zero(sNLat + 1, sNLon);
-    mDeltaRMoho = RDMatXX::Zero(sNLat + 1, sNLon);
+    RDMatXX deltaRSurfInt = RDMatXX::Zero(sNLat + 1, sNLon);
+    RDMatXX deltaRMohoInt = RDMatXX::Zero(sNLat + 1, sNLon);
     // fill north and south pole
-    mDeltaRSurf.row(0).fill(deltaRSurf.row(0).sum() / sNLon);
-    mDeltaRMoho.row(0).fill(deltaRMoho.row(0).sum() / sNLon);
-    mDeltaRSurf.row(sNLat).fill(deltaRSurf.row(sNLat - 1).sum() / sNLon);
-    mDeltaRMoho.row(sNLat).fill(deltaRMoho.row(sNLat - 1).sum() / sNLon);
+    deltaRSurfInt.row(0).fill(deltaRSurf.row(0).sum() / sNLon);
+    deltaRMohoInt.row(0).fill(deltaRMoho.row(0).sum() / sNLon);
+    deltaRSurfInt.row(sNLat).fill(deltaRSurf.row(sNLat - 1).sum() / sNLon);
+    deltaRMohoInt.row(sNLat).fill(deltaRMoho.row(sNLat - 1).sum() / sNLon);
     // interp at integer theta
     for (int i = 1; i < sNLat; i++) {
-        mDeltaRSurf.row(i) = (deltaRSurf.row(i - 1) + deltaRSurf.row(i)) * .5;
-        mDeltaRMoho.row(i) = (deltaRMoho.row(i - 1) + deltaRMoho.row(i)) * .5; 
+        deltaRSurfInt.row(i) = (deltaRSurf.row(i - 1) + deltaRSurf.row(i)) * .5;
+        deltaRMohoInt.row(i) = (deltaRMoho.row(i - 1) + deltaRMoho.row(i)) * .5; 
     }
     
     // apply factor
-    mDeltaRSurf *= mSurfFactor;
-    mDeltaRMoho *= mMohoFactor;
+    deltaRSurfInt *= mSurfFactor;
+    deltaRMohoInt *= mMohoFactor;
+    
+    // to cache
+    mCache->addArray("delta_r_surf", deltaRSurfInt);
+    mCache->addArray("delta_r_moho", deltaRMohoInt);
     
     // compute polar values in Cartesian
     // computePolar();
@@ -160,6 +188,13 @@ void Geometric3D_crust1::initialize(const std::vector<std::string> &params) {
 }
 
 double Geometric3D_crust1::getDeltaR(double r, double theta, double phi, double rElemCenter) const {
+    double deltaR_r;
+    return getDeltaR(r, theta, phi, rElemCenter, deltaR_r);
+}
+
+double Geometric3D_crust1::getDeltaR(double r, double theta, double phi, double rElemCenter, 
+    double &deltaR_r) const {
+    deltaR_r = 0.;
     if (rElemCenter > mRSurf || rElemCenter < mRBase) { 
         return 0.;
     }    
@@ -180,10 +215,14 @@ double Geometric3D_crust1::getDeltaR(double r, double theta, double phi, double
     }
 
     // interpolation along radius    
-    if (rElemCenter < mRMoho)
-        return drMoho / (mRMoho - mRBase) * (r - mRBase);
-    else 
-        return (drSurf - drMoho) / (mRSurf - mRMoho) * (r - mRMoho) + drMoho;
+    // the weak dependence of geographic latitude on depth is ignored in deltaR_r
+    if (rElemCenter < mRMoho) {
+        deltaR_r = drMoho / (mRMoho - mRBase);
+        return deltaR_r * (r - mRBase);
+    } else {
+        deltaR_r = (drSurf - drMoho) / (mRSurf - mRMoho);
+        return deltaR_r * (r - mRMoho) + drMoho;
+    }
 }
 
 // bool Geometric3D_crust1::getNablaDeltaR(double r, double theta, double phi, double rElemCenter,
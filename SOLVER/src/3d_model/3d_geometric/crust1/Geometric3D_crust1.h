@@ -9,13 +9,19 @@
 #include "Geometric3D.h"
 #include "eigenp.h"
 
+class ModelCache;
+
 class Geometric3D_crust1: public Geometric3D {
 public:
 
+    ~Geometric3D_crust1();
+
     void initialize();
     void initialize(const std::vector<std::string> &params);
     
     double getDeltaR(double r, double theta, double phi, double rElemCenter) const;
+    double getDeltaR(double r, double theta, double phi, double rElemCenter, 
+        double &deltaR_r) const;
     
     // bool getNablaDeltaR(double r, double theta, double phi, double rElemCenter,
     //     double &deltaR_r, double &deltaR_theta, double &deltaR_phi) const;
@@ -27,6 +33,9 @@ public:
     
 private:
     
+    // read raw data and form smoothed undulations, on root only
+    void processRawData();
+    
     // model constants
     static const int sNLayer;
     static const int sNLat;
@@ -54,9 +63,10 @@ private:
     // use geocentric or geographic
     bool mGeographic = true;
     
-    // deltaR at surface and moho 
-    RDMatXX mDeltaRSurf;
-    RDMatXX mDeltaRMoho;
+    // deltaR at surface and moho, viewed from the model cache
+    Eigen::Map<const RDMatXX> mDeltaRSurf = Eigen::Map<const RDMatXX>(0, 0, 0);
+    Eigen::Map<const RDMatXX> mDeltaRMoho = Eigen::Map<const RDMatXX>(0, 0, 0);
+    ModelCache *mCache = 0;
     
     // precomputed polar values
     // void computePolar();
@@ -17,6 +17,27 @@ double Ellipticity::getDeltaR(double r, double theta, double phi, double rElemCe
     return a * b / sqrt(tmp) - r;
 }
 
+double Ellipticity::getDeltaR(double r, double theta, double phi, double rElemCenter, 
+    double &deltaR_r) const {
+    if (r < tinyDouble) {
+        deltaR_r = 0.;
+        return 0.;
+    }
+    // deltaR = r * (g(f(r), theta) - 1), with u = 1 - f and
+    // g = u^(1/3) / sqrt(u^(-2/3) cos^2 + u^(4/3) sin^2)
+    double dfdr;
+    double f = XMath::getFlattening(r, dfdr);
+    double u = 1. - f;
+    double c2 = pow(cos(theta), 2.);
+    double s2 = pow(sin(theta), 2.);
+    double tmp = pow(u, -2. / 3.) * c2 + pow(u, 4. / 3.) * s2;
+    double g = pow(u, 1. / 3.) / sqrt(tmp);
+    double dtmpdu = -2. / 3. * pow(u, -5. / 3.) * c2 + 4. / 3. * pow(u, 1. / 3.) * s2;
+    double dgdu = g * (1. / (3. * u) - .5 * dtmpdu / tmp);
+    deltaR_r = g - 1. - r * dgdu * dfdr;
+    return r * (g - 1.);
+}
+
 // bool Ellipticity::getNablaDeltaR(double r, double theta, double phi, double rElemCenter,
 //     double &deltaR_r, double &deltaR_theta, double &deltaR_phi) const {
 //     double tmp = pow(mA * cos(theta), 2.) + pow(mB * sin(theta), 2.);    
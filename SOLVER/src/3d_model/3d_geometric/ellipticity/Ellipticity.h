@@ -10,6 +10,8 @@ class Ellipticity: public Geometric3D {
 public:
 
     double getDeltaR(double r, double theta, double phi, double rElemCenter) const;
+    double getDeltaR(double r, double theta, double phi, double rElemCenter, 
+        double &deltaR_r) const;
     
     // bool getNablaDeltaR(double r, double theta, double phi, double rElemCenter,
     //     double &deltaR_r, double &deltaR_theta, double &deltaR_phi) const;
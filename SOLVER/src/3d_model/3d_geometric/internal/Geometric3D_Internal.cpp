@@ -88,6 +88,13 @@ void Geometric3D_Internal::initialize(const std::vector<std::string> &params) {
 }
 
 double Geometric3D_Internal::getDeltaR(double r, double theta, double phi, double rElemCenter) const {
+    double deltaR_r;
+    return getDeltaR(r, theta, phi, rElemCenter, deltaR_r);
+}
+
+double Geometric3D_Internal::getDeltaR(double r, double theta, double phi, double rElemCenter, 
+    double &deltaR_r) const {
+    deltaR_r = 0.;
     if (rElemCenter > mRUpper || rElemCenter < mRLower) { 
         return 0.;
     }
@@ -122,10 +129,13 @@ double Geometric3D_Internal::getDeltaR(double r, double theta, double phi, doubl
     dr += mData(ilat1, ilon1) * flat1 * flon1;
     
     // interpolation along radius    
-    if (rElemCenter < mRLayer)
-        return dr / (mRLayer - mRLower) * (r - mRLower);
-    else 
-        return dr / (mRUpper - mRLayer) * (mRUpper - r);
+    if (rElemCenter < mRLayer) {
+        deltaR_r = dr / (mRLayer - mRLower);
+        return deltaR_r * (r - mRLower);
+    } else {
+        deltaR_r = -dr / (mRUpper - mRLayer);
+        return -deltaR_r * (mRUpper - r);
+    }
 }
 
 std::string Geometric3D_Internal::verbose() const {
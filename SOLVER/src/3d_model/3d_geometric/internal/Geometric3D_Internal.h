@@ -14,6 +14,8 @@ public:
     void initialize(const std::vector<std::string> &params);
     
     double getDeltaR(double r, double theta, double phi, double rElemCenter) const;
+    double getDeltaR(double r, double theta, double phi, double rElemCenter, 
+        double &deltaR_r) const;
     
     std::string verbose() const;
     
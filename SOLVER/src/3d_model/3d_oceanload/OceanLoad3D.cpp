@@ -51,3 +51,9 @@ void OceanLoad3D::buildInparam(OceanLoad3D *&model,
         if (verbose) XMPI::cout << model->verbose();
     }
 }
+
+void OceanLoad3D::getOceanDepthBatch(const RDMatX3 &rtp, RDColX &depth) const {
+    depth = RDColX(rtp.rows());
+    for (int i = 0; i < rtp.rows(); i++) 
+        depth(i) = getOceanDepth(rtp(i, 1), rtp(i, 2));
+}
@@ -5,6 +5,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "eigenp.h"
 
 class Parameters;
 class ExodusModel;
@@ -24,6 +25,10 @@ public:
     // get water depth at location theta/phi 
     virtual double getOceanDepth(double theta, double phi) const = 0;
     
+    // batch version of getOceanDepth, one location (r, theta, phi) per row
+    // the default loops over getOceanDepth
+    virtual void getOceanDepthBatch(const RDMatX3 &rtp, RDColX &depth) const;
+    
     // verbose 
     virtual std::string verbose() const = 0;
     
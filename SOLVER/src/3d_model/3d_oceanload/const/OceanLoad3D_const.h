@@ -11,6 +11,8 @@ public:
     void initialize(const std::vector<std::string> &params);
     
     double getOceanDepth(double theta, double phi) const {return mDepth;};
+    void getOceanDepthBatch(const RDMatX3 &rtp, RDColX &depth) const {
+        depth = RDColX::Constant(rtp.rows(), mDepth);};
     
     std::string verbose() const;
     
@@ -9,26 +9,52 @@
 #include <fstream>
 #include "XMPI.h"
 #include "XMath.h"
+#include "ModelCache.h"
 
 const int OceanLoad3D_crust1::sNLayer = 9;
 const int OceanLoad3D_crust1::sNLat = 180;
 const int OceanLoad3D_crust1::sNLon = 360;
 
+OceanLoad3D_crust1::~OceanLoad3D_crust1() {
+    delete mCache;
+}
+
 void OceanLoad3D_crust1::initialize() {
+    if (mBenchmarkSPECFEM) {
+        // determine ocean depth ONLY by elevation 
+        mGaussianOrder = 0;
+        mNPointInterp = 2;
+        mIncludeIceAsWater = false;
+        mGeographic = false;
+    }
+    
+    // smoothed depth is cached on disk, keyed by all options
+    // that affect it; raw data are only read and processed on root
+    // when the cache misses
+    mCache = new ModelCache("crust1_oceanload");
+    mCache->addToKey(mIncludeIceAsWater);
+    mCache->addToKey(mBenchmarkSPECFEM);
+    mCache->addToKey(mGaussianOrder);
+    mCache->addToKey(mGaussianDev);
+    mCache->addFileToKey(projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds");
+    if (!mCache->load()) {
+        if (XMPI::root()) processRawData();
+        mCache->store();
+    }
+    mCache->mapArray("depth", mDepth);
+}
+
+void OceanLoad3D_crust1::processRawData() {
     // read raw data
     int nrow = sNLat * sNLon;
     RDMatXX elevation = RDMatXX::Zero(nrow, sNLayer);
-    if (XMPI::root()) {
-        std::string fname = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds";
-        std::fstream fs(fname, std::fstream::in);
-        if (!fs) throw std::runtime_error("OceanLoad3D_crust1::initialize || "
-            "Error opening crust1.0 data file: ||" + fname);
-        for (int i = 0; i < nrow; i++)
-            for (int j = 0; j < sNLayer; j++) fs >> elevation(i, j);    
-        fs.close();
-    }
-    // broadcast
-    XMPI::bcastEigen(elevation);
+    std::string fname = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data/crust1.bnds";
+    std::fstream fs(fname, std::fstream::in);
+    if (!fs) throw std::runtime_error("OceanLoad3D_crust1::processRawData || "
+        "Error opening crust1.0 data file: ||" + fname);
+    for (int i = 0; i < nrow; i++)
+        for (int j = 0; j < sNLayer; j++) fs >> elevation(i, j);    
+    fs.close();
     
     // water depth
     int colWaterBot = 1;
@@ -37,10 +63,6 @@ void OceanLoad3D_crust1::initialize() {
     if (mBenchmarkSPECFEM) {
         // determine ocean depth ONLY by elevation 
         depthVec = elevation.col(2) * 1e3;
-        mGaussianOrder = 0;
-        mNPointInterp = 2;
-        mIncludeIceAsWater = false;
-        mGeographic = false;
     }
     
     RDMatXX depth(sNLat, sNLon);
@@ -62,13 +84,16 @@ void OceanLoad3D_crust1::initialize() {
     XMath::gaussianSmoothing(depth, orderRow, devRow, true, orderCol, devCol, false);
     
     // cast to integer theta with unique polar values
-    mDepth = RDMatXX::Zero(sNLat + 1, sNLon);
+    RDMatXX depthInt = RDMatXX::Zero(sNLat + 1, sNLon);
     // fill north and south pole
-    mDepth.row(0).fill(depth.row(0).sum() / sNLon);
-    mDepth.row(sNLat).fill(depth.row(sNLat - 1).sum() / sNLon);
+    depthInt.row(0).fill(depth.row(0).sum() / sNLon);
+    depthInt.row(sNLat).fill(depth.row(sNLat - 1).sum() / sNLon);
     // interp at integer theta
     for (int i = 1; i < sNLat; i++) 
-        mDepth.row(i) = (depth.row(i - 1) + depth.row(i)) * .5;
+        depthInt.row(i) = (depth.row(i - 1) + depth.row(i)) * .5;
+    
+    // to cache
+    mCache->addArray("depth", depthInt);
     
     //////////// plot raw data ////////////  
     // std::fstream fs;
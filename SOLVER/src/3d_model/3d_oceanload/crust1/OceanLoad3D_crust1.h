@@ -8,9 +8,13 @@
 #include "OceanLoad3D.h"
 #include "eigenp.h"
 
+class ModelCache;
+
 class OceanLoad3D_crust1: public OceanLoad3D {
 public:
 
+    ~OceanLoad3D_crust1();
+
     void initialize();
     void initialize(const std::vector<std::string> &params);
     
@@ -20,6 +24,9 @@ public:
     
 private:
     
+    // read raw data and form smoothed depth, on root only
+    void processRawData();
+    
     // model constants
     static const int sNLayer;
     static const int sNLat;
@@ -40,7 +47,8 @@ private:
     // flag to benchmark with specfem
     bool mBenchmarkSPECFEM = false; 
     
-    // depth at grid points 
-    RDMatXX mDepth;
+    // depth at grid points, viewed from the model cache
+    Eigen::Map<const RDMatXX> mDepth = Eigen::Map<const RDMatXX>(0, 0, 0);
+    ModelCache *mCache = 0;
 };
 
@@ -17,6 +17,8 @@
 #include "Volumetric3D_crust1.h"
 #include "Volumetric3D_bubble.h"
 #include "Volumetric3D_cylinder.h"
+#include "Volumetric3D_harmonics.h"
+#include "Volumetric3D_grid.h"
 /////////////////////////////// user-defined models here
 
 void Volumetric3D::buildInparam(std::vector<Volumetric3D *> &models, 
@@ -53,6 +55,10 @@ void Volumetric3D::buildInparam(std::vector<Volumetric3D *> &models,
             m = new Volumetric3D_bubble(); 
         } else if (boost::iequals(name, "cylinder")) {
             m = new Volumetric3D_cylinder();        
+        } else if (boost::iequals(name, "harmonics")) {
+            m = new Volumetric3D_harmonics();
+        } else if (boost::iequals(name, "grid")) {
+            m = new Volumetric3D_grid();
             
         /////////////////////////////// 
         // user-defined models here
@@ -72,3 +78,18 @@ void Volumetric3D::buildInparam(std::vector<Volumetric3D *> &models,
         models.push_back(m);
     }
 }
+
+void Volumetric3D::get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+    RDMatX5 &properties, IColX &inRange) const {
+    int n = rtp.rows();
+    properties = RDMatX5::Zero(n, 5);
+    inRange = IColX::Zero(n);
+    for (int i = 0; i < n; i++) {
+        double vpv, vph, vsv, vsh, rho;
+        if (get3dProperties(rtp(i, 0), rtp(i, 1), rtp(i, 2), rElemCenter(i), 
+            vpv, vph, vsv, vsh, rho)) {
+            properties.row(i) << vpv, vph, vsv, vsh, rho;
+            inRange(i) = 1;
+        }
+    }
+}
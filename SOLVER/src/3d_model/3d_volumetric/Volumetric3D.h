@@ -6,6 +6,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "eigenp.h"
 
 class Parameters;
 class ExodusModel;
@@ -37,6 +38,21 @@ public:
     virtual bool get3dProperties(double r, double theta, double phi, double rElemCenter,
         double &vpv, double &vph, double &vsv, double &vsh, double &rho) const = 0;
     
+    // batch version of get3dProperties, one location per row
+    // rtp: (r, theta, phi); properties: (vpv, vph, vsv, vsh, rho)
+    // inRange: 0 for locations out of model range
+    // the default loops over get3dProperties; override it if the model 
+    // can share work among locations
+    virtual void get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const;
+    
+    // ring version: nr locations at r/theta in the SOURCE-CENTERED frame,
+    // with phi = 2 pi i / nr, i = 0, ..., nr - 1 
+    // RETURN: a "false" return means ring synthesis is not available, 
+    // and the caller should use get3dPropertiesBatch instead
+    virtual bool get3dPropertiesRing(double r, double theta, int nr, double rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const {return false;};
+    
     // reference type
     virtual ReferenceTypes getReferenceType() const = 0;
     
@@ -50,6 +66,11 @@ public:
     // obtain more mesh information from ExodusModel
     virtual void setupExodusModel(const ExodusModel *exModel) {};
     
+    // spatial range of the local mesh in the source-centered frame, 
+    // called on all procs before each local build so that a model can 
+    // load only the data needed by the local elements
+    virtual void setupLocalRange(double sMin, double sMax, double zMin, double zMax) {};
+    
     // build from input parameters
     static void buildInparam(std::vector<Volumetric3D *> &models, 
         const Parameters &par, const ExodusModel *exModel, 
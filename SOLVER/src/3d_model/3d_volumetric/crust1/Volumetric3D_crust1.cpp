@@ -11,82 +11,108 @@
 #include "SpectralConstants.h"
 #include <algorithm>
 #include "ExodusModel.h"
+#include "ModelCache.h"
 
 const int Volumetric3D_crust1::sNLayer = 9;
 const int Volumetric3D_crust1::sNLat = 180;
 const int Volumetric3D_crust1::sNLon = 360;
 
+Volumetric3D_crust1::~Volumetric3D_crust1() {
+    delete mCache;
+}
+
 void Volumetric3D_crust1::initialize() {
+    if (mIncludeIce) mIncludeSediment = true;
+    
+    // post-processed data are cached on disk, keyed by all options
+    // that affect them; raw data are only read and processed on root
+    // when the cache misses
+    mCache = new ModelCache("crust1_volumetric");
+    mCache->addToKey(mRSurf);
+    mCache->addToKey(mRMoho);
+    mCache->addToKey(mIncludeIce);
+    mCache->addToKey(mIncludeSediment);
+    mCache->addToKey(mElementBoundaries.data(), mElementBoundaries.size() * sizeof(double));
+    mCache->addToKey(nPol);
+    std::string path = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data";
+    for (const std::string &ext: {"bnds", "vp", "vs", "rho"}) 
+        mCache->addFileToKey(path + "/crust1." + ext);
+    if (!mCache->load()) {
+        if (XMPI::root()) processRawData();
+        mCache->store();
+    }
+    Eigen::Map<const RDMatXX> rlGLL(0, 0, 0);
+    mCache->mapArray("rl_gll", rlGLL);
+    mRlGLL = rlGLL.col(0);
+    mCache->mapArray("vp_gll", mVpGLL);
+    mCache->mapArray("vs_gll", mVsGLL);
+    mCache->mapArray("rh_gll", mRhGLL);
+}
+
+void Volumetric3D_crust1::processRawData() {
     // read raw data
     int nrow = sNLat * sNLon;
     RDMatXX bnd, vp_, vs_, rho;
     bnd = vp_ = vs_ = rho = RDMatXX::Zero(nrow, sNLayer);
-    if (XMPI::root()) {
-        std::string path = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data";
-        std::fstream fsbnd, fsvp_, fsvs_, fsrho;
-        fsbnd.open(path + "/crust1.bnds", std::fstream::in);
-        fsvp_.open(path + "/crust1.vp", std::fstream::in);
-        fsvs_.open(path + "/crust1.vs", std::fstream::in);
-        fsrho.open(path + "/crust1.rho", std::fstream::in);
-        if (!fsbnd || !fsvp_ || !fsvs_ || !fsrho) 
-            throw std::runtime_error("Volumetric3D_crust1::initialize || "
-                "Error opening crust1.0 data files at directory: ||" + path);
-        for (int i = 0; i < nrow; i++) {
-            for (int j = 0; j < sNLayer; j++) {
-                fsbnd >> bnd(i, j);
-                fsvp_ >> vp_(i, j);
-                fsvs_ >> vs_(i, j);
-                fsrho >> rho(i, j);
-            }
+    std::string path = projectDirectory + "/src/3d_model/3d_volumetric/crust1/data";
+    std::fstream fsbnd, fsvp_, fsvs_, fsrho;
+    fsbnd.open(path + "/crust1.bnds", std::fstream::in);
+    fsvp_.open(path + "/crust1.vp", std::fstream::in);
+    fsvs_.open(path + "/crust1.vs", std::fstream::in);
+    fsrho.open(path + "/crust1.rho", std::fstream::in);
+    if (!fsbnd || !fsvp_ || !fsvs_ || !fsrho) 
+        throw std::runtime_error("Volumetric3D_crust1::processRawData || "
+            "Error opening crust1.0 data files at directory: ||" + path);
+    for (int i = 0; i < nrow; i++) {
+        for (int j = 0; j < sNLayer; j++) {
+            fsbnd >> bnd(i, j);
+            fsvp_ >> vp_(i, j);
+            fsvs_ >> vs_(i, j);
+            fsrho >> rho(i, j);
         }
-        fsbnd.close();
-        fsvp_.close();
-        fsvs_.close();
-        fsrho.close();    
     }
-    // broadcast
-    XMPI::bcastEigen(bnd);
-    XMPI::bcastEigen(vp_);
-    XMPI::bcastEigen(vs_);
-    XMPI::bcastEigen(rho);
+    fsbnd.close();
+    fsvp_.close();
+    fsvs_.close();
+    fsrho.close();    
     
     // cast to integer theta
-    mRl = mVp = mVs = mRh = RDMatXX::Zero(nrow + sNLon, sNLayer);
+    RDMatXX rl, vp, vs, rh;
+    rl = vp = vs = rh = RDMatXX::Zero(nrow + sNLon, sNLayer);
     for (int col = 0; col < sNLayer; col++) {
-        mRl.block(0, col, sNLon, 1).fill(bnd.block(0, col, sNLon, 1).sum() / sNLon);
-        mVp.block(0, col, sNLon, 1).fill(vp_.block(0, col, sNLon, 1).sum() / sNLon);
-        mVs.block(0, col, sNLon, 1).fill(vs_.block(0, col, sNLon, 1).sum() / sNLon);
-        mRh.block(0, col, sNLon, 1).fill(rho.block(0, col, sNLon, 1).sum() / sNLon);
-        mRl.block(nrow, col, sNLon, 1).fill(bnd.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
-        mVp.block(nrow, col, sNLon, 1).fill(vp_.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
-        mVs.block(nrow, col, sNLon, 1).fill(vs_.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
-        mRh.block(nrow, col, sNLon, 1).fill(rho.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
+        rl.block(0, col, sNLon, 1).fill(bnd.block(0, col, sNLon, 1).sum() / sNLon);
+        vp.block(0, col, sNLon, 1).fill(vp_.block(0, col, sNLon, 1).sum() / sNLon);
+        vs.block(0, col, sNLon, 1).fill(vs_.block(0, col, sNLon, 1).sum() / sNLon);
+        rh.block(0, col, sNLon, 1).fill(rho.block(0, col, sNLon, 1).sum() / sNLon);
+        rl.block(nrow, col, sNLon, 1).fill(bnd.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
+        vp.block(nrow, col, sNLon, 1).fill(vp_.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
+        vs.block(nrow, col, sNLon, 1).fill(vs_.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
+        rh.block(nrow, col, sNLon, 1).fill(rho.block(nrow - sNLon, col, sNLon, 1).sum() / sNLon);
     }
     for (int i = 1; i < sNLat; i++) {
-        mRl.block(i * sNLon, 0, sNLon, sNLayer) = (bnd.block(i * sNLon, 0, sNLon, sNLayer) + bnd.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
-        mVp.block(i * sNLon, 0, sNLon, sNLayer) = (vp_.block(i * sNLon, 0, sNLon, sNLayer) + vp_.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
-        mVs.block(i * sNLon, 0, sNLon, sNLayer) = (vs_.block(i * sNLon, 0, sNLon, sNLayer) + vs_.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
-        mRh.block(i * sNLon, 0, sNLon, sNLayer) = (rho.block(i * sNLon, 0, sNLon, sNLayer) + rho.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
+        rl.block(i * sNLon, 0, sNLon, sNLayer) = (bnd.block(i * sNLon, 0, sNLon, sNLayer) + bnd.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
+        vp.block(i * sNLon, 0, sNLon, sNLayer) = (vp_.block(i * sNLon, 0, sNLon, sNLayer) + vp_.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
+        vs.block(i * sNLon, 0, sNLon, sNLayer) = (vs_.block(i * sNLon, 0, sNLon, sNLayer) + vs_.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
+        rh.block(i * sNLon, 0, sNLon, sNLayer) = (rho.block(i * sNLon, 0, sNLon, sNLayer) + rho.block((i - 1) * sNLon, 0, sNLon, sNLayer)) * .5;
     } 
     
     // convert to SI
-    mVp *= 1e3;
-    mVs *= 1e3;
-    mRh *= 1e3;
-    mRl *= 1e3;
+    vp *= 1e3;
+    vs *= 1e3;
+    rh *= 1e3;
+    rl *= 1e3;
     
     // layers
-    if (mIncludeIce) mIncludeSediment = true;
     int colSurf = columnSurf();
     int colMoho = 8;
 
     // linear mapping to sphere
     const RDColX &rmoho = RDColX::Constant(nrow + sNLon, mRMoho);
     const RDColX &rdiff = (RDColX::Constant(nrow + sNLon, mRSurf - mRMoho).array() 
-        / (mRl.col(colSurf) - mRl.col(colMoho)).array()).matrix();
-    RDMatXX copyRl = mRl;    
+        / (rl.col(colSurf) - rl.col(colMoho)).array()).matrix();
+    RDMatXX copyRl = rl;    
     for (int i = 0; i < sNLayer; i++) {
-        mRl.col(i).array() = rdiff.array() * (copyRl.col(i) - copyRl.col(colMoho)).array() + rmoho.array();
+        rl.col(i).array() = rdiff.array() * (copyRl.col(i) - copyRl.col(colMoho)).array() + rmoho.array();
     }
     
     // above: physical layers
@@ -97,8 +123,8 @@ void Volumetric3D_crust1::initialize() {
     int nEleCrust = mElementBoundaries.size() - 1;
     const RDColP &eta = SpectralConstants::getP_GLL();
     int numGll = 1 + nPol * nEleCrust;
-    mRlGLL = RDColX(numGll);
-    mRlGLL(0) = mRSurf; // surface
+    RDColX rlGLL(numGll);
+    rlGLL(0) = mRSurf; // surface
     int index = 1;
     for (int iele = 0; iele < nEleCrust; iele++) {
         double eBoundTop = mElementBoundaries[iele];
@@ -106,12 +132,13 @@ void Volumetric3D_crust1::initialize() {
         double eHeight = eBoundTop - eBoundBot;
         for (int jpol = 1; jpol <= nPol; jpol++) {
             double z = eBoundTop - (eta(jpol) - eta(0)) / (eta(nPol) - eta(0)) * eHeight;
-            mRlGLL(index++) = z;
+            rlGLL(index++) = z;
         }
     }
     
     // zero properties
-    mVpGLL = mVsGLL = mRhGLL = RDMatXX::Zero(nrow + sNLon, numGll);
+    RDMatXX vpGLL, vsGLL, rhGLL;
+    vpGLL = vsGLL = rhGLL = RDMatXX::Zero(nrow + sNLon, numGll);
     
     // form values at GLL boundaries
     for (int igll = 0; igll < numGll; igll++) {
@@ -120,15 +147,15 @@ void Volumetric3D_crust1::initialize() {
         int ibot = igll + 1;
         if (itop < 0) itop = 0;
         if (ibot > numGll - 1) ibot = numGll - 1;
-        double gll_top = mRlGLL(itop);
-        double gll_mid = mRlGLL(imid);
-        double gll_bot = mRlGLL(ibot);
+        double gll_top = rlGLL(itop);
+        double gll_mid = rlGLL(imid);
+        double gll_bot = rlGLL(ibot);
         double gll_mid_value = 2. / (gll_top - gll_bot);
-        for (int row = 0; row < mRl.rows(); row++) {
+        for (int row = 0; row < rl.rows(); row++) {
             // integrate
             for (int ilayer = colSurf; ilayer < colMoho; ilayer++) {
-                double phy_top = mRl(row, ilayer);
-                double phy_bot = mRl(row, ilayer + 1);
+                double phy_top = rl(row, ilayer);
+                double phy_bot = rl(row, ilayer + 1);
                 // top to mid
                 double top = std::min(phy_top, gll_top);
                 double bot = std::max(phy_bot, gll_mid);
@@ -136,9 +163,9 @@ void Volumetric3D_crust1::initialize() {
                     double gllt = gll_mid_value / (gll_top - gll_mid) * (gll_top - top);
                     double gllb = gll_mid_value / (gll_top - gll_mid) * (gll_top - bot);
                     double area = .5 * (gllt + gllb) * (top - bot);
-                    mVpGLL(row, igll) += mVp(row, ilayer) * area;
-                    mVsGLL(row, igll) += mVs(row, ilayer) * area;
-                    mRhGLL(row, igll) += mRh(row, ilayer) * area; 
+                    vpGLL(row, igll) += vp(row, ilayer) * area;
+                    vsGLL(row, igll) += vs(row, ilayer) * area;
+                    rhGLL(row, igll) += rh(row, ilayer) * area; 
                 }
                 // mid to bot
                 top = std::min(phy_top, gll_mid);
@@ -147,9 +174,9 @@ void Volumetric3D_crust1::initialize() {
                     double gllt = gll_mid_value / (gll_mid - gll_bot) * (top - gll_bot);
                     double gllb = gll_mid_value / (gll_mid - gll_bot) * (bot - gll_bot);
                     double area = .5 * (gllt + gllb) * (top - bot);
-                    mVpGLL(row, igll) += mVp(row, ilayer) * area;
-                    mVsGLL(row, igll) += mVs(row, ilayer) * area;
-                    mRhGLL(row, igll) += mRh(row, ilayer) * area; 
+                    vpGLL(row, igll) += vp(row, ilayer) * area;
+                    vsGLL(row, igll) += vs(row, ilayer) * area;
+                    rhGLL(row, igll) += rh(row, ilayer) * area; 
                 } 
             }
         }
@@ -159,8 +186,8 @@ void Volumetric3D_crust1::initialize() {
     // int rmax = -1;
     // double xmin = 1e100;
     // int rmin = -1;
-    // for (int row = 0; row < mRl.rows(); row++) {
-    //     double xdiff = mRhGLL(row, 0);
+    // for (int row = 0; row < rl.rows(); row++) {
+    //     double xdiff = rhGLL(row, 0);
     //     if (xdiff > xmax) {
     //         xmax = xdiff;
     //         rmax = row;
@@ -175,36 +202,42 @@ void Volumetric3D_crust1::initialize() {
     // 
     // exit(0);
     // std::fstream fs;
-    // for (int row = 0; row < mRl.rows(); row++) {
+    // for (int row = 0; row < rl.rows(); row++) {
     //     std::stringstream ss;
     //     ss << "x/vp/" << row << ".txt";
     //     fs.open(ss.str(), std::fstream::out);
-    //     fs << mRl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mVp.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mRlGLL.transpose() << std::endl;
-    //     fs << mVpGLL.row(row) << std::endl << std::endl;
+    //     fs << rl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << vp.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << rlGLL.transpose() << std::endl;
+    //     fs << vpGLL.row(row) << std::endl << std::endl;
     //     fs.close();
     // }
-    // for (int row = 0; row < mRl.rows(); row++) {
+    // for (int row = 0; row < rl.rows(); row++) {
     //     std::stringstream ss;
     //     ss << "x/vs/" << row << ".txt";
     //     fs.open(ss.str(), std::fstream::out);
-    //     fs << mRl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mVs.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mRlGLL.transpose() << std::endl;
-    //     fs << mVsGLL.row(row) << std::endl << std::endl;
+    //     fs << rl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << vs.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << rlGLL.transpose() << std::endl;
+    //     fs << vsGLL.row(row) << std::endl << std::endl;
     //     fs.close();
     // }
-    // for (int row = 0; row < mRl.rows(); row++) {
+    // for (int row = 0; row < rl.rows(); row++) {
     //     std::stringstream ss;
     //     ss << "x/rho/" << row << ".txt";
     //     fs.open(ss.str(), std::fstream::out);
-    //     fs << mRl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mRh.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
-    //     fs << mRlGLL.transpose() << std::endl;
-    //     fs << mRhGLL.row(row) << std::endl << std::endl;
+    //     fs << rl.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << rh.row(row).block(0, colSurf, 1, colMoho - colSurf + 1) << std::endl;
+    //     fs << rlGLL.transpose() << std::endl;
+    //     fs << rhGLL.row(row) << std::endl << std::endl;
     //     fs.close();
     // }
+    
+    // to cache
+    mCache->addArray("rl_gll", rlGLL);
+    mCache->addArray("vp_gll", vpGLL);
+    mCache->addArray("vs_gll", vsGLL);
+    mCache->addArray("rh_gll", rhGLL);
 }
 
 bool Volumetric3D_crust1::get3dProperties(double r, double theta, double phi, double rElemCenter,
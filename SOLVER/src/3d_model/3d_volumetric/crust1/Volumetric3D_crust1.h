@@ -7,12 +7,16 @@
 #include "Volumetric3D.h"
 #include "eigenp.h"
 
+class ModelCache;
+
 class Volumetric3D_crust1: public Volumetric3D {
     friend class Geometric3D_crust1;
     friend class OceanLoad3D_crust1;
     
 public:
     
+    ~Volumetric3D_crust1();
+    
     void initialize();
     void initialize(const std::vector<std::string> &params);
     
@@ -31,6 +35,9 @@ public:
     
 private:
     
+    // read raw data and form thickness weighted data, on root only
+    void processRawData();
+    
     int columnSurf() const {
         int colSurf = 5; // no ice, no sediment
         if (mIncludeIce) {
@@ -68,15 +75,11 @@ private:
     // element boundaries in mesh
     std::vector<double> mElementBoundaries;
     
-    // original data mapped onto reference sphere
-    RDMatXX mRl;
-    RDMatXX mVp;
-    RDMatXX mVs;
-    RDMatXX mRh;
-    
     // thickness weighted data mapped onto reference sphere
+    // viewed from the model cache
     RDColX mRlGLL;
-    RDMatXX mVpGLL;
-    RDMatXX mVsGLL;
-    RDMatXX mRhGLL;
+    Eigen::Map<const RDMatXX> mVpGLL = Eigen::Map<const RDMatXX>(0, 0, 0);
+    Eigen::Map<const RDMatXX> mVsGLL = Eigen::Map<const RDMatXX>(0, 0, 0);
+    Eigen::Map<const RDMatXX> mRhGLL = Eigen::Map<const RDMatXX>(0, 0, 0);
+    ModelCache *mCache = 0;
 };
@@ -0,0 +1,279 @@
+// Volumetric3D_grid.cpp
+// created by agent on 19-Oct-2026
+// volumetric model on a (lat, lon, depth) grid stored in HDF5
+// each proc reads only the part of the grid covering its local mesh
+
+#include "Volumetric3D_grid.h"
+#include <sstream>
+#include <algorithm>
+#include "XMPI.h"
+#include "XMath.h"
+#include "Parameters.h"
+#include "H5Reader.h"
+#include "hdf5.h"
+#include <boost/algorithm/string.hpp>
+
+void Volumetric3D_grid::initialize() {
+    // file format:
+    // 1D datasets "latitude" (deg), "longitude" (deg) and "depth" (km), strictly increasing, 
+    // which can be irregularly spaced; a global grid must include both lon0 and lon0 + 360
+    // 3D datasets of shape (nlat, nlon, ndepth), any of "vpv", "vph", "vsv", "vsh", "rho", 
+    // with "vp" and "vs" for isotropic models; absolute values in SI units 
+    const std::string allFields[7] = {"vpv", "vph", "vsv", "vsh", "rho", "vp", "vs"};
+    std::vector<int> present(7, 0);
+    RDColX axes[3];
+    if (XMPI::root()) {
+        std::string fname = Parameters::sInputDirectory + "/" + mFileName;
+        hid_t fid = H5Fopen(fname.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (fid < 0) throw std::runtime_error("Volumetric3D_grid::initialize || "
+            "Error opening grid data file: ||" + fname);
+        const char *axisNames[3] = {"latitude", "longitude", "depth"};
+        for (int i = 0; i < 3; i++) {
+            double *data = 0;
+            int row, col;
+            H5Reader::getDoubleData(fid, axisNames[i], row, col, data);
+            axes[i] = Eigen::Map<RDColX>(data, row * col);
+            delete [] data;
+        }
+        for (int i = 0; i < 7; i++) {
+            if (!H5Reader::hasDataset(fid, allFields[i].c_str())) continue;
+            int dims[3];
+            H5Reader::getDimensions(fid, allFields[i].c_str(), 3, dims);
+            for (int j = 0; j < 3; j++) 
+                if (dims[j] != axes[j].rows()) throw std::runtime_error("Volumetric3D_grid::initialize || "
+                    "Inconsistent dimensions of dataset " + allFields[i] + " in grid data file: ||" + fname);
+            present[i] = 1;
+        }
+        H5Reader::hdf5Error(H5Fclose(fid), "H5Fclose");
+    }
+    for (int i = 0; i < 3; i++) XMPI::bcastEigen(axes[i]);
+    XMPI::bcast(present.data(), 7);
+    mLat = axes[0];
+    mLon = axes[1];
+    mDepth = axes[2] * 1e3;
+    for (int i = 0; i < 3; i++) {
+        if (axes[i].rows() < 2) throw std::runtime_error("Volumetric3D_grid::initialize || "
+            "Each grid axis requires at least two points.");
+        for (int j = 1; j < axes[i].rows(); j++) 
+            if (axes[i](j) <= axes[i](j - 1)) throw std::runtime_error("Volumetric3D_grid::initialize || "
+                "Grid axes must be strictly increasing.");
+    }
+    if (mLon(mLon.rows() - 1) - mLon(0) > 360. + tinySingle) throw std::runtime_error("Volumetric3D_grid::initialize || "
+        "Longitude range exceeds 360 degrees.");
+    
+    // map properties to fields
+    mFields.clear();
+    for (int i = 0; i < 7; i++) if (present[i]) mFields.push_back(allFields[i]);
+    for (int ip = 0; ip < 5; ip++) {
+        // vp for vpv and vph, vs for vsv and vsh
+        std::string name = allFields[ip];
+        if (!present[ip] && ip < 2) name = "vp";
+        if (!present[ip] && ip >= 2 && ip < 4) name = "vs";
+        auto it = std::find(mFields.begin(), mFields.end(), name);
+        mFieldOfProperty[ip] = it == mFields.end() ? -1 : it - mFields.begin();
+        if (mFieldOfProperty[ip] < 0 && mReferenceType == ReferenceTypes::Absolute) 
+            throw std::runtime_error("Volumetric3D_grid::initialize || "
+            "Missing " + allFields[ip] + " in grid data file for an absolute model.");
+    }
+}
+
+void Volumetric3D_grid::initialize(const std::vector<std::string> &params) {
+    if (params.size() < 2) throw std::runtime_error("Volumetric3D_grid::initialize || "
+        "Not enough parameters to initialize a Volumetric3D_grid object.");
+    const std::string source = "Volumetric3D_grid::initialize";
+    XMath::castValue(mFileName, params[0], source);
+    
+    // reference type
+    if (boost::iequals(params[1], "Absolute") || boost::iequals(params[1], "Abs")) 
+        mReferenceType = ReferenceTypes::Absolute;
+    else if (boost::iequals(params[1], "Reference1D") || boost::iequals(params[1], "Ref1D") || boost::iequals(params[1], "1D")) 
+        mReferenceType = ReferenceTypes::Reference1D;
+    else if (boost::iequals(params[1], "Reference3D") || boost::iequals(params[1], "Ref3D") || boost::iequals(params[1], "3D")) 
+        mReferenceType = ReferenceTypes::Reference3D;
+    else if (boost::iequals(params[1], "ReferencePerturb") || boost::iequals(params[1], "RefPerturb") || boost::iequals(params[1], "Perturb")) 
+        mReferenceType = ReferenceTypes::ReferencePerturb;        
+    else 
+        throw std::runtime_error("Volumetric3D_grid::initialize || Unknown reference type: " + params[1] + ".");
+    
+    try {
+        int ipar = 2;
+        XMath::castValue(mGeographic, params.at(ipar++), source);
+    } catch (std::out_of_range) {
+        // nothing
+    }
+    initialize();
+}
+
+void Volumetric3D_grid::setupLocalRange(double sMin, double sMax, double zMin, double zMax) {
+    // release previous tile
+    mTile.resize(0, 0);
+    for (int i = 0; i < 3; i++) mTileStart[i] = mTileCount[i] = 0;
+    if (sMin > sMax || zMin > zMax) return;
+    
+    // r and theta in the source-centered frame
+    double zClosest = std::min(std::max(0., zMin), zMax);
+    double rMin = sqrt(sMin * sMin + zClosest * zClosest);
+    double rMax = 0., thetaMin = pi, thetaMax = 0.;
+    for (double s: {sMin, sMax}) {
+        for (double z: {zMin, zMax}) {
+            rMax = std::max(rMax, sqrt(s * s + z * z));
+            double theta = atan2(s, z);
+            thetaMin = std::min(thetaMin, theta);
+            thetaMax = std::max(thetaMax, theta);
+        }
+    }
+    if (sMin < tinyDouble && zMin <= 0. && zMax >= 0.) {
+        thetaMin = 0.;
+        thetaMax = pi;
+    }
+    
+    // geocentric colatitude and longitude of the band [thetaMin, thetaMax] around the source
+    double thetaSrc = XMath::lat2Theta(mSrcLat, mSrcDep);
+    double colatMin = (thetaMin <= thetaSrc && thetaSrc <= thetaMax) ? 0. : 
+        std::min(std::abs(thetaSrc - thetaMin), std::abs(thetaSrc - thetaMax));
+    double colatMax = (thetaMin <= pi - thetaSrc && pi - thetaSrc <= thetaMax) ? pi : 
+        pi - std::min(std::abs(pi - thetaSrc - thetaMin), std::abs(pi - thetaSrc - thetaMax));
+    bool fullLon = thetaMax >= std::min(thetaSrc, pi - thetaSrc);
+    double halfLon = fullLon ? pi : asin(sin(thetaMax) / sin(thetaSrc));
+    
+    // to grid coordinates, with a margin for geographic latitude 
+    double margin = .5;
+    double latMin = 90. - colatMax / degree - margin;
+    double latMax = 90. - colatMin / degree + margin;
+    indexRange(mLat, latMin, latMax, mTileStart[0], mTileCount[0]);
+    double lonLo = XMath::phi2Lon(XMath::lon2Phi(mSrcLon)) - halfLon / degree - margin;
+    while (lonLo < mLon(0)) lonLo += 360.;
+    while (lonLo >= mLon(0) + 360.) lonLo -= 360.;
+    double lonHi = lonLo + 2. * halfLon / degree + 2. * margin;
+    if (fullLon || lonHi > mLon(0) + 360.) {
+        // read all longitudes if the range wraps around the grid
+        mTileStart[1] = 0;
+        mTileCount[1] = mLon.rows();
+    } else {
+        indexRange(mLon, lonLo, lonHi, mTileStart[1], mTileCount[1]);
+    }
+    indexRange(mDepth, mROuter - rMax, mROuter - rMin, mTileStart[2], mTileCount[2]);
+    int npoint = mTileCount[0] * mTileCount[1] * mTileCount[2];
+    if (npoint == 0) return;
+    
+    // read tile, independently on each proc
+    mTile = RDMatXX(mFields.size(), npoint);
+    std::string fname = Parameters::sInputDirectory + "/" + mFileName;
+    hid_t fid = H5Fopen(fname.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (fid < 0) throw std::runtime_error("Volumetric3D_grid::setupLocalRange || "
+        "Error opening grid data file: ||" + fname);
+    RDColX buffer(npoint);
+    for (int ifield = 0; ifield < mFields.size(); ifield++) {
+        H5Reader::getDoubleSlab(fid, mFields[ifield].c_str(), 3, mTileStart, mTileCount, buffer.data());
+        mTile.row(ifield) = buffer.transpose();
+    }
+    H5Reader::hdf5Error(H5Fclose(fid), "H5Fclose");
+}
+
+bool Volumetric3D_grid::get3dProperties(double r, double theta, double phi, double rElemCenter,
+    double &vpv, double &vph, double &vsv, double &vsh, double &rho) const {
+    Eigen::Matrix<double, 1, 5> values;
+    if (!interpolate(r, theta, phi, rElemCenter, values)) return false;
+    vpv = values(0);
+    vph = values(1);
+    vsv = values(2);
+    vsh = values(3);
+    rho = values(4);
+    return true;
+}
+
+void Volumetric3D_grid::get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+    RDMatX5 &properties, IColX &inRange) const {
+    int n = rtp.rows();
+    properties = RDMatX5::Zero(n, 5);
+    inRange = IColX::Zero(n);
+    Eigen::Matrix<double, 1, 5> values;
+    for (int i = 0; i < n; i++) {
+        if (interpolate(rtp(i, 0), rtp(i, 1), rtp(i, 2), rElemCenter(i), values)) {
+            properties.row(i) = values;
+            inRange(i) = 1;
+        }
+    }
+}
+
+bool Volumetric3D_grid::interpolate(double r, double theta, double phi, double rElemCenter, 
+    Eigen::Matrix<double, 1, 5> &values) const {
+    // depth, decided by element center
+    int ndep = mDepth.rows();
+    double depthCenter = mROuter - rElemCenter;
+    if (depthCenter < mDepth(0) || depthCenter > mDepth(ndep - 1)) return false;
+    double depth = std::min(std::max(mROuter - r, mDepth(0)), mDepth(ndep - 1));
+    
+    // lat and lon in grid
+    double lat = mGeographic ? XMath::theta2Lat(theta, depth) : 90. - theta / degree;
+    double lon = phi / degree;
+    while (lon < mLon(0)) lon += 360.;
+    while (lon >= mLon(0) + 360.) lon -= 360.;
+    
+    // cell
+    int index[3];
+    double weight[3];
+    if (!locate(mLat, lat, index[0], weight[0])) return false;
+    if (!locate(mLon, lon, index[1], weight[1])) return false;
+    locate(mDepth, depth, index[2], weight[2]);
+    for (int i = 0; i < 3; i++) {
+        index[i] -= mTileStart[i];
+        if (index[i] < 0 || index[i] + 1 >= mTileCount[i]) 
+            throw std::runtime_error("Volumetric3D_grid::interpolate || "
+            "Location outside the range of the local mesh.");
+    }
+    
+    // trilinear, all fields at once
+    RDColX fields = RDColX::Zero(mFields.size());
+    for (int a = 0; a < 2; a++) {
+        for (int b = 0; b < 2; b++) {
+            for (int c = 0; c < 2; c++) {
+                double w = (a ? weight[0] : 1. - weight[0]) * 
+                    (b ? weight[1] : 1. - weight[1]) * (c ? weight[2] : 1. - weight[2]);
+                int col = ((index[0] + a) * mTileCount[1] + index[1] + b) * mTileCount[2] + index[2] + c;
+                fields += w * mTile.col(col);
+            }
+        }
+    }
+    for (int ip = 0; ip < 5; ip++) 
+        values(ip) = mFieldOfProperty[ip] < 0 ? 0. : fields(mFieldOfProperty[ip]);
+    return true;
+}
+
+bool Volumetric3D_grid::locate(const RDColX &axis, double x, int &i, double &weight) {
+    int n = axis.rows();
+    if (x < axis(0) || x > axis(n - 1)) return false;
+    i = std::upper_bound(axis.data(), axis.data() + n, x) - axis.data() - 1;
+    i = std::min(std::max(i, 0), n - 2);
+    weight = (x - axis(i)) / (axis(i + 1) - axis(i));
+    return true;
+}
+
+void Volumetric3D_grid::indexRange(const RDColX &axis, double lo, double hi, int &start, int &count) {
+    int n = axis.rows();
+    if (lo > axis(n - 1) || hi < axis(0)) {
+        start = count = 0;
+        return;
+    }
+    start = std::upper_bound(axis.data(), axis.data() + n, lo) - axis.data() - 2;
+    int end = std::lower_bound(axis.data(), axis.data() + n, hi) - axis.data() + 1;
+    start = std::max(start, 0);
+    end = std::min(end, n - 1);
+    count = end - start + 1;
+}
+
+std::string Volumetric3D_grid::verbose() const {
+    std::stringstream ss;
+    ss << "\n======================= 3D Volumetric ======================" << std::endl;
+    ss << "  Model Name           =   grid" << std::endl;
+    ss << "  Data File            =   " << mFileName << std::endl;
+    ss << "  Grid Size            =   " << mLat.rows() << " x " << mLon.rows() << " x " << mDepth.rows() << std::endl;
+    ss << "  Latitude (deg)       =   [" << mLat(0) << ", " << mLat(mLat.rows() - 1) << "]" << std::endl;
+    ss << "  Longitude (deg)      =   [" << mLon(0) << ", " << mLon(mLon.rows() - 1) << "]" << std::endl;
+    ss << "  Depth (km)           =   [" << mDepth(0) / 1e3 << ", " << mDepth(mDepth.rows() - 1) / 1e3 << "]" << std::endl;
+    ss << "  Use Geographic       =   " << (mGeographic ? "YES" : "NO") << std::endl;
+    ss << "  Reference Type       =   " << ReferenceTypesString[mReferenceType] << std::endl;
+    ss << "  Properties           =   " << boost::algorithm::join(mFields, ", ") << std::endl;
+    ss << "======================= 3D Volumetric ======================\n" << std::endl;
+    return ss.str();
+}
@@ -0,0 +1,72 @@
+// Volumetric3D_grid.h
+// created by agent on 19-Oct-2026
+// volumetric model on a (lat, lon, depth) grid stored in HDF5
+// each proc reads only the part of the grid covering its local mesh
+
+#pragma once
+#include "Volumetric3D.h"
+
+class Volumetric3D_grid: public Volumetric3D {
+public:
+    
+    void initialize();
+    void initialize(const std::vector<std::string> &params);
+    
+    bool get3dProperties(double r, double theta, double phi, double rElemCenter,
+        double &vpv, double &vph, double &vsv, double &vsh, double &rho) const;
+    
+    void get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const;
+    
+    ReferenceTypes getReferenceType() const {return mReferenceType;};
+    
+    std::string verbose() const;
+    
+    void setROuter(double router) {mROuter = router;};
+    
+    void setSource(double srcLat, double srcLon, double srcDep) {
+        mSrcLat = srcLat;
+        mSrcLon = srcLon;
+        mSrcDep = srcDep;
+    }
+    
+    void setupLocalRange(double sMin, double sMax, double zMin, double zMax);
+    
+private:
+    // trilinear interpolation of all properties (vpv, vph, vsv, vsh, rho)
+    bool interpolate(double r, double theta, double phi, double rElemCenter, 
+        Eigen::Matrix<double, 1, 5> &values) const;
+    
+    // locate x in axis, axis(i) <= x <= axis(i + 1)
+    static bool locate(const RDColX &axis, double x, int &i, double &weight);
+    
+    // index range on axis covering [lo, hi], padded by one cell
+    static void indexRange(const RDColX &axis, double lo, double hi, int &start, int &count);
+    
+    // file
+    std::string mFileName;
+    ReferenceTypes mReferenceType;
+    bool mGeographic = false;
+    
+    // geometry
+    double mROuter = 6371e3;
+    double mSrcLat = 0.;
+    double mSrcLon = 0.;
+    double mSrcDep = 0.;
+    
+    // grid axes, lat and lon in degrees, depth in meters
+    RDColX mLat;
+    RDColX mLon;
+    RDColX mDepth;
+    
+    // datasets in file
+    std::vector<std::string> mFields;
+    // field of each property (vpv, vph, vsv, vsh, rho), -1 if absent
+    int mFieldOfProperty[5];
+    
+    // local tile: start and count on (lat, lon, depth)
+    int mTileStart[3] = {0, 0, 0};
+    int mTileCount[3] = {0, 0, 0};
+    // one column per grid point, one row per field
+    RDMatXX mTile;
+};
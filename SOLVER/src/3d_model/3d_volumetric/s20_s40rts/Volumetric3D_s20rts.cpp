@@ -8,6 +8,7 @@
 #include <fstream>
 #include "XMPI.h"
 #include "XMath.h"
+#include "SphericalHarmonics.h"
 
 extern "C" {
     void __s20rts_MOD_initialize_s20rts(double *rcmb, double *rmoho, double *rearth, 
@@ -15,6 +16,7 @@ extern "C" {
     void __s20rts_MOD_finalize_s20rts();
     bool __s20rts_MOD_perturb_s20rts(double *r, double *theta, double *phi, double *r_center,
         double *vp, double *vs);
+    bool __s20rts_MOD_radial_basis_s20rts(double *r, double *r_center, double radial_basis[]);
 };
 
 
@@ -39,6 +41,14 @@ void Volumetric3D_s20rts::initialize() {
     XMPI::bcast(meta_data_p12, np12);
     XMPI::bcast(meta_data_s20, ns20);
     __s20rts_MOD_initialize_s20rts(&mRCMB, &mRMoho, &mRSurf, meta_data_p12, meta_data_s20);
+    
+    // same expansion rotated to the source-centered frame, in which 
+    // each ring of the mesh is synthesized by a single FFT
+    // dvs: degree 20; dvp: degree 12
+    mSH = new SphericalHarmonics(20, 21, 2);
+    mSH->setCoefficientsPacked(0, 20, meta_data_s20);
+    mSH->setCoefficientsPacked(1, 12, meta_data_p12);
+    mSH->rotate(XMath::rotationMatrix(XMath::lat2Theta(mSrcLat, mSrcDep), XMath::lon2Phi(mSrcLon)));
 }
 
 void Volumetric3D_s20rts::initialize(const std::vector<std::string> &params) {
@@ -56,6 +66,8 @@ void Volumetric3D_s20rts::initialize(const std::vector<std::string> &params) {
 
 void Volumetric3D_s20rts::finalize() {
     __s20rts_MOD_finalize_s20rts();
+    delete mSH;
+    mSH = 0;
 }
 
 bool Volumetric3D_s20rts::get3dProperties(double r, double theta, double phi, double rElemCenter,
@@ -68,6 +80,24 @@ bool Volumetric3D_s20rts::get3dProperties(double r, double theta, double phi, do
     return result;
 }
 
+bool Volumetric3D_s20rts::get3dPropertiesRing(double r, double theta, int nr, double rElemCenter,
+    RDMatX5 &properties, IColX &inRange) const {
+    RDColX radialBasis(21);
+    if (!__s20rts_MOD_radial_basis_s20rts(&r, &rElemCenter, radialBasis.data())) {
+        properties = RDMatX5::Zero(nr, 5);
+        inRange = IColX::Zero(nr);
+        return true;
+    }
+    RDMatXX dvsdvp;
+    mSH->synthesizeRing(radialBasis, theta, nr, dvsdvp);
+    properties.resize(nr, 5);
+    properties.col(0) = properties.col(1) = dvsdvp.col(1);
+    properties.col(2) = properties.col(3) = dvsdvp.col(0);
+    properties.col(4) = mScaleRho * dvsdvp.col(0);
+    inRange = IColX::Ones(nr);
+    return true;
+}
+
 std::string Volumetric3D_s20rts::verbose() const {
     std::stringstream ss;
     ss << "\n======================= 3D Volumetric ======================" << std::endl;
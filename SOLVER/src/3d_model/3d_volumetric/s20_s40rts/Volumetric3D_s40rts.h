@@ -6,9 +6,13 @@
 #pragma once
 #include "Volumetric3D.h"
 
+class SphericalHarmonics;
+
 class Volumetric3D_s40rts: public Volumetric3D {
 public:
     
+    ~Volumetric3D_s40rts() {finalize();};
+    
     void initialize();
     void initialize(const std::vector<std::string> &params);
     
@@ -17,6 +21,9 @@ public:
     bool get3dProperties(double r, double theta, double phi, double rElemCenter,
         double &dvpv, double &dvph, double &dvsv, double &dvsh, double &drho) const;
     
+    bool get3dPropertiesRing(double r, double theta, int nr, double rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const;
+    
     ReferenceTypes getReferenceType() const {return ReferenceTypes::Reference1D;};
     
     std::string verbose() const;
@@ -24,9 +31,21 @@ public:
     // set outer radius
     void setROuter(double router) {mRSurf = router;};
     
+    // source location for ring synthesis
+    void setSource(double srcLat, double srcLon, double srcDep) {
+        mSrcLat = srcLat; mSrcLon = srcLon; mSrcDep = srcDep;};
+    
 private:
     double mRCMB = 3480000.0;
     double mRMoho = 6346600.0;
     double mRSurf = 6371000.0;
     double mScaleRho = .4;
+    
+    // source location
+    double mSrcLat = 0.;
+    double mSrcLon = 0.;
+    double mSrcDep = 0.;
+    
+    // expansion rotated to the source-centered frame
+    SphericalHarmonics *mSH = 0;
 };
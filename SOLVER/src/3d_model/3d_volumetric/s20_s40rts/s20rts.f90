@@ -70,7 +70,7 @@ module s20rts
     double precision, dimension(:, :), allocatable :: S20RTS_V_qq0
     double precision, dimension(:, :, :), allocatable :: S20RTS_V_qq
     
-    public :: initialize_s20rts, finalize_s20rts, perturb_s20rts 
+    public :: initialize_s20rts, finalize_s20rts, perturb_s20rts, radial_basis_s20rts 
     private
     
 contains
@@ -173,7 +173,6 @@ contains
         double precision, parameter :: ZERO_ = 0.d0
         
         integer :: l, m, k
-        double precision :: r_moho, r_cmb, xr, radius, r_center
         double precision :: dvs_alm, dvs_blm
         double precision :: dvp_alm, dvp_blm
         double precision :: radial_basis(0:NK_20)
@@ -181,23 +180,10 @@ contains
         
         dvs = ZERO_
         dvp = ZERO_
-        radius = r_abs / REARTH_Par
-        r_moho = RMOHO_Par / REARTH_Par
-        r_cmb = RCMB_Par / REARTH_Par
-        r_center = r_center_abs / REARTH_Par
-        if (r_center >= r_moho .or. r_center <= r_cmb) then 
+        if (.not. radial_basis_s20rts(r_abs, r_center_abs, radial_basis)) then
             perturb_s20rts = .false.
             return
         endif
-        ! element inside mantle but point outside
-        if (radius >= r_moho * 0.999999d0) radius = r_moho * 0.999999d0 
-        if (radius <= r_cmb * 1.000001d0) radius = r_cmb * 1.000001d0
-        
-        xr = -1.0d0 + 2.0d0 * (radius - r_cmb) / (r_moho - r_cmb)
-        do k = 0, NK_20
-            radial_basis(k) = s20rts_rsple(1, NK_20 + 1, S20RTS_V_spknt(1), &
-            S20RTS_V_qq0(1, NK_20 + 1 - k), S20RTS_V_qq(1, 1, NK_20 + 1 - k), xr)
-        enddo
         
         do l = 0, NS_20
             sint = dsin(theta)
@@ -237,6 +223,47 @@ contains
     !--------------------------------------------------------------------------------------------------
     !
     
+    ! radial basis functions at r_abs, false if element is outside the mantle
+    ! !! PASS ABSOLUTE radius to me
+    function radial_basis_s20rts(r_abs, r_center_abs, radial_basis) &
+        bind(C, name="__s20rts_MOD_radial_basis_s20rts")
+        
+        implicit none
+        
+        double precision, intent(in) :: r_abs, r_center_abs
+        double precision, intent(out) :: radial_basis(0:NK_20)
+        logical :: radial_basis_s20rts
+        
+        integer :: k
+        double precision :: r_moho, r_cmb, xr, radius, r_center
+        
+        radial_basis = 0.d0
+        radius = r_abs / REARTH_Par
+        r_moho = RMOHO_Par / REARTH_Par
+        r_cmb = RCMB_Par / REARTH_Par
+        r_center = r_center_abs / REARTH_Par
+        if (r_center >= r_moho .or. r_center <= r_cmb) then 
+            radial_basis_s20rts = .false.
+            return
+        endif
+        ! element inside mantle but point outside
+        if (radius >= r_moho * 0.999999d0) radius = r_moho * 0.999999d0 
+        if (radius <= r_cmb * 1.000001d0) radius = r_cmb * 1.000001d0
+        
+        xr = -1.0d0 + 2.0d0 * (radius - r_cmb) / (r_moho - r_cmb)
+        do k = 0, NK_20
+            radial_basis(k) = s20rts_rsple(1, NK_20 + 1, S20RTS_V_spknt(1), &
+            S20RTS_V_qq0(1, NK_20 + 1 - k), S20RTS_V_qq(1, 1, NK_20 + 1 - k), xr)
+        enddo
+        
+        radial_basis_s20rts = .true.
+        
+    end function radial_basis_s20rts
+    
+    !
+    !--------------------------------------------------------------------------------------------------
+    !
+    
     subroutine s20rts_splhsetup
         
         implicit none
@@ -50,20 +50,8 @@ bool Volumetric3D_bubble::get3dProperties(double r, double theta, double phi, do
     double &dvpv, double &dvph, double &dvsv, double &dvsh, double &drho) const {
     
     // find the distance between bubble center and target point
-    RDCol3 rtpBubble, rtpTarget;
-    if (mSourceCentered) {
-        RDCol3 rtpBubbleSrc;
-        rtpBubbleSrc(0) = XMath::getROuter() - mDepth;
-        rtpBubbleSrc(1) = mLat * degree;
-        rtpBubbleSrc(2) = mLon * degree;
-        rtpBubble = XMath::rotateSrc2Glob(rtpBubbleSrc, mSrcLat, mSrcLon, mSrcDep);
-    } else {
-        rtpBubble(0) = XMath::getROuter() - mDepth;
-        rtpBubble(1) = XMath::lat2Theta(mLat, mDepth);
-        rtpBubble(2) = XMath::lon2Phi(mLon);    
-    }
-    
-    const RDCol3 &xyzBubble = XMath::toCartesian(rtpBubble);
+    RDCol3 rtpTarget;
+    const RDCol3 &xyzBubble = computeCenter();
     rtpTarget(0) = r;
     rtpTarget(1) = theta;
     rtpTarget(2) = phi;
@@ -92,6 +80,48 @@ bool Volumetric3D_bubble::get3dProperties(double r, double theta, double phi, do
     return true;
 }
 
+void Volumetric3D_bubble::get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+    RDMatX5 &properties, IColX &inRange) const {
+    // center rotated once for all locations
+    const RDCol3 &xyzBubble = computeCenter();
+    
+    // distance to bubble surface, zero inside bubble
+    const Eigen::ArrayXd &r = rtp.col(0).array();
+    const Eigen::ArrayXd &sint = rtp.col(1).array().sin();
+    const Eigen::ArrayXd &dx = r * sint * rtp.col(2).array().cos() - xyzBubble(0);
+    const Eigen::ArrayXd &dy = r * sint * rtp.col(2).array().sin() - xyzBubble(1);
+    const Eigen::ArrayXd &dz = r * rtp.col(1).array().cos() - xyzBubble(2);
+    const Eigen::ArrayXd &distance = ((dx * dx + dy * dy + dz * dz).sqrt() - mRadius).max(0.);
+    
+    // compute Gaussian within range
+    double stddev = mHWHM / sqrt(2. * log(2.));
+    inRange = (distance <= 4. * mHWHM).cast<int>().matrix();
+    const RDColX &gaussian = (inRange.array() > 0).select(
+        mMax * (-distance * distance / (stddev * stddev * 2.)).exp(), 0.).matrix();
+    
+    // set perturbations
+    properties = RDMatX5::Zero(rtp.rows(), 5);
+    if (mChangeVp) properties.col(0) = properties.col(1) = gaussian;
+    if (mChangeVs) properties.col(2) = properties.col(3) = gaussian;
+    if (mChangeRho) properties.col(4) = gaussian;
+}
+
+RDCol3 Volumetric3D_bubble::computeCenter() const {
+    RDCol3 rtpBubble;
+    if (mSourceCentered) {
+        RDCol3 rtpBubbleSrc;
+        rtpBubbleSrc(0) = XMath::getROuter() - mDepth;
+        rtpBubbleSrc(1) = mLat * degree;
+        rtpBubbleSrc(2) = mLon * degree;
+        rtpBubble = XMath::rotateSrc2Glob(rtpBubbleSrc, mSrcLat, mSrcLon, mSrcDep);
+    } else {
+        rtpBubble(0) = XMath::getROuter() - mDepth;
+        rtpBubble(1) = XMath::lat2Theta(mLat, mDepth);
+        rtpBubble(2) = XMath::lon2Phi(mLon);    
+    }
+    return XMath::toCartesian(rtpBubble);
+}
+
 std::string Volumetric3D_bubble::verbose() const {
     std::stringstream ss;
     ss << "\n======================= 3D Volumetric ======================" << std::endl;
@@ -13,6 +13,9 @@ public:
     bool get3dProperties(double r, double theta, double phi, double rElemCenter,
         double &dvpv, double &dvph, double &dvsv, double &dvsh, double &drho) const;
     
+    void get3dPropertiesBatch(const RDMatX3 &rtp, const RDColX &rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const;
+    
     ReferenceTypes getReferenceType() const {return mReferenceType;};
     
     std::string verbose() const;
@@ -24,6 +27,9 @@ public:
     }
     
 private:
+    // Cartesian center in the global frame
+    RDCol3 computeCenter() const;
+    
     // center of the bubble
     double mDepth;
     double mLat;
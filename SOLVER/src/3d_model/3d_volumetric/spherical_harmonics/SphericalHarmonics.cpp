@@ -0,0 +1,183 @@
+// SphericalHarmonics.cpp
+// created by agent on 19-Oct-2026
+// real spherical-harmonic expansion with radial basis functions,
+// evaluated on rings of constant (r, theta) by FFT synthesis
+
+#include "SphericalHarmonics.h"
+#include "PreloopFFTW.h"
+#include <cmath>
+#include <string>
+#include <stdexcept>
+
+SphericalHarmonics::SphericalHarmonics(int lmax, int nradial, int nparams):
+mLMax(lmax), mNumRadial(nradial) {
+    for (int ip = 0; ip < nparams; ip++)
+        mCoeffs.push_back(RDMatXX::Zero(nradial, (lmax + 1) * (lmax + 1)));
+}
+
+void SphericalHarmonics::setCoefficients(int iparam, int k, int l, int m, double a, double b) {
+    if (l > mLMax || m > l || m < 0) throw std::runtime_error("SphericalHarmonics::setCoefficients || "
+        "Invalid degree or order, l = " + std::to_string(l) + ", m = " + std::to_string(m) + ".");
+    if (m == 0) {
+        mCoeffs[iparam](k, index(l, 0)) = a;
+        return;
+    }
+    // remove Condon-Shortley phase and move sqrt(2) to basis functions
+    double factor = (m % 2 == 0 ? 1. : -1.) / sqrt(2.);
+    mCoeffs[iparam](k, index(l, m)) = a * factor;
+    mCoeffs[iparam](k, index(l, -m)) = b * factor;
+}
+
+int SphericalHarmonics::setCoefficientsPacked(int iparam, int lmax, const double *data) {
+    int pos = 0;
+    for (int k = 0; k < mNumRadial; k++) {
+        for (int l = 0; l <= lmax; l++) {
+            setCoefficients(iparam, k, l, 0, data[pos], 0.);
+            pos++;
+            for (int m = 1; m <= l; m++) {
+                setCoefficients(iparam, k, l, m, data[pos], data[pos + 1]);
+                pos += 2;
+            }
+        }
+    }
+    return pos;
+}
+
+void SphericalHarmonics::rotate(const RDMat33 &rot) {
+    // rotation matrices of real harmonics by recursion on degree
+    // Ivanic & Ruedenberg, J. Phys. Chem. 100 (1996) 6342, with errata 102 (1998) 9099
+    // Y_lm(rot * x) = sum_n D_l(m, n) Y_ln(x)
+    std::vector<RDMatXX> D(mLMax + 1);
+    D[0] = RDMatXX::Ones(1, 1);
+    if (mLMax >= 1) {
+        // order m = -1, 0, 1 corresponds to y, z, x
+        const int cart[3] = {1, 2, 0};
+        D[1] = RDMatXX(3, 3);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                D[1](i, j) = rot(cart[i], cart[j]);
+    }
+    for (int l = 2; l <= mLMax; l++) {
+        const RDMatXX &R1 = D[1];
+        const RDMatXX &Rp = D[l - 1];
+        // element (a, b) of D[l - 1], indices in [-(l - 1), l - 1]
+        auto prev = [&Rp, l](int a, int b) {return Rp(a + l - 1, b + l - 1);};
+        auto P = [&R1, &prev, l](int i, int a, int b) {
+            double ri1 = R1(i + 1, 2), rim1 = R1(i + 1, 0), ri0 = R1(i + 1, 1);
+            if (b == l) return ri1 * prev(a, l - 1) - rim1 * prev(a, -l + 1);
+            if (b == -l) return ri1 * prev(a, -l + 1) + rim1 * prev(a, l - 1);
+            return ri0 * prev(a, b);
+        };
+        D[l] = RDMatXX(2 * l + 1, 2 * l + 1);
+        for (int m = -l; m <= l; m++) {
+            for (int n = -l; n <= l; n++) {
+                int d = (m == 0);
+                double denom = (abs(n) < l) ? (double)(l + n) * (l - n) : (double)(2 * l) * (2 * l - 1);
+                double u = sqrt((l + m) * (l - m) / denom);
+                double v = .5 * sqrt((1. + d) * (l + abs(m) - 1) * (l + abs(m)) / denom) * (1. - 2. * d);
+                double w = -.5 * sqrt((l - abs(m) - 1) * (l - abs(m)) / denom) * (1. - d);
+                double U = 0., V = 0., W = 0.;
+                if (u != 0.) U = P(0, m, n);
+                if (v != 0.) {
+                    if (m == 0) {
+                        V = P(1, 1, n) + P(-1, -1, n);
+                    } else if (m > 0) {
+                        int d1 = (m == 1);
+                        V = P(1, m - 1, n) * sqrt(1. + d1) - P(-1, -m + 1, n) * (1. - d1);
+                    } else {
+                        int d1 = (m == -1);
+                        V = P(1, m + 1, n) * (1. - d1) + P(-1, -m - 1, n) * sqrt(1. + d1);
+                    }
+                }
+                if (w != 0.) {
+                    if (m > 0)
+                        W = P(1, m + 1, n) + P(-1, -m - 1, n);
+                    else
+                        W = P(1, m - 1, n) - P(-1, -m + 1, n);
+                }
+                D[l](m + l, n + l) = u * U + v * V + w * W;
+            }
+        }
+    }
+
+    // f'(x') = f(rot * x') = sum_lm c_lm sum_n D_l(m, n) Y_ln(x')
+    for (auto &coeffs: mCoeffs) {
+        for (int l = 0; l <= mLMax; l++) {
+            const RDMatXX &block = coeffs.block(0, index(l, -l), mNumRadial, 2 * l + 1);
+            coeffs.block(0, index(l, -l), mNumRadial, 2 * l + 1) = block * D[l];
+        }
+    }
+}
+
+void SphericalHarmonics::synthesizeRing(const RDColX &radialWeights, double theta, int nr, RDMatXX &values) const {
+    RDColX pbar;
+    legendre(theta, pbar);
+    const RDMatXX &coeffs = contract(radialWeights);
+    values = RDMatXX(nr, mCoeffs.size());
+    CDColX spectrum(nr);
+    for (int ip = 0; ip < mCoeffs.size(); ip++) {
+        // a_m cos(m phi) + b_m sin(m phi) = Re[(a_m - i b_m) exp(i m phi)],
+        // folded onto the nr discrete frequencies of the ring
+        spectrum.setZero();
+        for (int m = 0; m <= mLMax; m++) {
+            double am = 0., bm = 0.;
+            for (int l = m; l <= mLMax; l++) {
+                am += coeffs(index(l, m), ip) * pbar(index(l, m));
+                if (m > 0) bm += coeffs(index(l, -m), ip) * pbar(index(l, m));
+            }
+            if (m > 0) {
+                am *= sqrt(2.);
+                bm *= sqrt(2.);
+            }
+            spectrum(m % nr) += ComplexD(am, -bm);
+        }
+        // Hermitian half spectrum
+        CDColX &half = PreloopFFTW::getC2R_CMat(nr);
+        for (int k = 0; k < nr / 2 + 1; k++)
+            half(k) = (spectrum(k) + std::conj(spectrum((nr - k) % nr))) * .5;
+        PreloopFFTW::computeC2R(nr);
+        values.col(ip) = PreloopFFTW::getC2R_RMat(nr);
+    }
+}
+
+void SphericalHarmonics::evaluate(const RDColX &radialWeights, double theta, double phi, RDColX &values) const {
+    RDColX pbar;
+    legendre(theta, pbar);
+    const RDMatXX &coeffs = contract(radialWeights);
+    values = RDColX::Zero(mCoeffs.size());
+    for (int ip = 0; ip < mCoeffs.size(); ip++) {
+        for (int l = 0; l <= mLMax; l++) {
+            values(ip) += coeffs(index(l, 0), ip) * pbar(index(l, 0));
+            for (int m = 1; m <= l; m++)
+                values(ip) += sqrt(2.) * pbar(index(l, m)) *
+                    (coeffs(index(l, m), ip) * cos(m * phi) + coeffs(index(l, -m), ip) * sin(m * phi));
+        }
+    }
+}
+
+void SphericalHarmonics::legendre(double theta, RDColX &pbar) const {
+    double c = cos(theta);
+    double s = sin(theta);
+    pbar = RDColX::Zero((mLMax + 1) * (mLMax + 1));
+    // sectoral
+    pbar(index(0, 0)) = 1. / sqrt(4. * pi);
+    for (int m = 1; m <= mLMax; m++)
+        pbar(index(m, m)) = sqrt((2. * m + 1.) / (2. * m)) * s * pbar(index(m - 1, m - 1));
+    // upward in degree
+    for (int m = 0; m < mLMax; m++) {
+        pbar(index(m + 1, m)) = sqrt(2. * m + 3.) * c * pbar(index(m, m));
+        for (int l = m + 2; l <= mLMax; l++) {
+            double a = sqrt((4. * l * l - 1.) / ((double)l * l - m * m));
+            double b = sqrt(((l - 1.) * (l - 1.) - m * m) / (4. * (l - 1.) * (l - 1.) - 1.));
+            pbar(index(l, m)) = a * (c * pbar(index(l - 1, m)) - b * pbar(index(l - 2, m)));
+        }
+    }
+}
+
+RDMatXX SphericalHarmonics::contract(const RDColX &radialWeights) const {
+    RDMatXX coeffs((mLMax + 1) * (mLMax + 1), mCoeffs.size());
+    for (int ip = 0; ip < mCoeffs.size(); ip++)
+        coeffs.col(ip) = mCoeffs[ip].transpose() * radialWeights;
+    return coeffs;
+}
+
@@ -0,0 +1,58 @@
+// SphericalHarmonics.h
+// created by agent on 19-Oct-2026
+// real spherical-harmonic expansion with radial basis functions,
+// evaluated on rings of constant (r, theta) by FFT synthesis
+
+#pragma once
+
+#include "eigenp.h"
+#include <vector>
+
+class SphericalHarmonics {
+public:
+    SphericalHarmonics(int lmax, int nradial, int nparams);
+
+    // set coefficients of cos(m phi) and sin(m phi) for radial basis k
+    // convention of SPECFEM and Ritsema's model files: fully normalized
+    // Legendre functions including the Condon-Shortley phase
+    void setCoefficients(int iparam, int k, int l, int m, double a, double b);
+    // packed as in Ritsema's model files, up to degree lmax (<= mLMax)
+    // for each k, for each l: a_l0, a_l1, b_l1, ..., a_ll, b_ll
+    // RETURN: number of values read
+    int setCoefficientsPacked(int iparam, int lmax, const double *data);
+
+    // rotate expansion to a frame x' where x = rot * x'
+    void rotate(const RDMat33 &rot);
+
+    // values of all parameters at nr locations (theta, 2 pi i / nr), i = 0, ..., nr - 1
+    // radialWeights: values of the radial basis functions at the radius of the ring
+    void synthesizeRing(const RDColX &radialWeights, double theta, int nr, RDMatXX &values) const;
+
+    // values of all parameters at a single location
+    void evaluate(const RDColX &radialWeights, double theta, double phi, RDColX &values) const;
+
+    int getLMax() const {return mLMax;};
+    int getNumRadial() const {return mNumRadial;};
+    int getNumParameters() const {return mCoeffs.size();};
+
+private:
+    // index of (l, m) in coefficient columns, m in [-l, l], negative m for sin(|m| phi)
+    static int index(int l, int m) {return l * l + l + m;};
+
+    // fully normalized Legendre functions without Condon-Shortley phase
+    // pbar(index(l, m)) for m >= 0
+    void legendre(double theta, RDColX &pbar) const;
+
+    // coefficients contracted with radial weights, one column per parameter
+    RDMatXX contract(const RDColX &radialWeights) const;
+
+    // maximum degree
+    int mLMax;
+
+    // number of radial basis functions
+    int mNumRadial;
+
+    // coefficients in orthonormal real basis, nradial x (lmax + 1) ^ 2 per parameter
+    std::vector<RDMatXX> mCoeffs;
+};
+
@@ -0,0 +1,142 @@
+// Volumetric3D_harmonics.cpp
+// created by agent on 19-Oct-2026
+// mantle model given by spherical-harmonic coefficients on radial knots
+// a general form of s20rts/s40rts-style tomography models
+
+#include "Volumetric3D_harmonics.h"
+#include "SphericalHarmonics.h"
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include "XMPI.h"
+#include "XMath.h"
+#include "Parameters.h"
+
+void Volumetric3D_harmonics::initialize() {
+    // file format:
+    // line 1: lmax_vs lmax_vp nknots
+    // line 2: radii of knots in km, increasing
+    // then dvs coefficients for each knot, packed as (lmax_vs + 1) ^ 2 values
+    // in the order a_l0, a_l1, b_l1, ..., a_ll, b_ll for l = 0, ..., lmax_vs,
+    // then dvp coefficients in the same way
+    // convention of SPECFEM and Ritsema's model files 
+    int header[3];
+    RDColX data;
+    if (XMPI::root()) {
+        std::string fname = Parameters::sInputDirectory + "/" + mFileName;
+        std::fstream fs(fname, std::fstream::in);
+        if (!fs) throw std::runtime_error("Volumetric3D_harmonics::initialize || "
+            "Error opening spherical harmonics data file: ||" + fname);
+        fs >> header[0] >> header[1] >> header[2];
+        if (!fs || header[0] < 0 || header[1] < 0 || header[2] < 2) 
+            throw std::runtime_error("Volumetric3D_harmonics::initialize || "
+            "Invalid header in spherical harmonics data file: ||" + fname);
+        int ndata = header[2] * (1 + (header[0] + 1) * (header[0] + 1) + (header[1] + 1) * (header[1] + 1));
+        data = RDColX(ndata);
+        for (int i = 0; i < ndata; i++) fs >> data(i);
+        if (!fs) throw std::runtime_error("Volumetric3D_harmonics::initialize || "
+            "Insufficient data in spherical harmonics data file: ||" + fname);
+        fs.close();
+    }
+    XMPI::bcast(header, 3);
+    XMPI::bcastEigen(data);
+    mLMaxVs = header[0];
+    mLMaxVp = header[1];
+    int nknots = header[2];
+    
+    // knots
+    mKnots = data.topRows(nknots) * 1e3;
+    for (int k = 1; k < nknots; k++) 
+        if (mKnots(k) <= mKnots(k - 1)) throw std::runtime_error("Volumetric3D_harmonics::initialize || "
+            "Radii of knots must be strictly increasing.");
+    
+    // coefficients
+    mSH = new SphericalHarmonics(std::max(mLMaxVs, mLMaxVp), nknots, 2);
+    int pos = nknots;
+    pos += mSH->setCoefficientsPacked(0, mLMaxVs, data.data() + pos);
+    pos += mSH->setCoefficientsPacked(1, mLMaxVp, data.data() + pos);
+    
+    // rotated to the source-centered frame for ring synthesis
+    mSHSrc = new SphericalHarmonics(*mSH);
+    mSHSrc->rotate(XMath::rotationMatrix(XMath::lat2Theta(mSrcLat, mSrcDep), XMath::lon2Phi(mSrcLon)));
+}
+
+void Volumetric3D_harmonics::initialize(const std::vector<std::string> &params) {
+    if (params.size() < 1) throw std::runtime_error("Volumetric3D_harmonics::initialize || "
+        "Not enough parameters to initialize a Volumetric3D_harmonics object.");
+    const std::string source = "Volumetric3D_harmonics::initialize";
+    XMath::castValue(mFileName, params[0], source);
+    try {
+        int ipar = 1;
+        XMath::castValue(mScaleRho, params.at(ipar++), source);
+    } catch (std::out_of_range) {
+        // nothing
+    }
+    initialize();
+}
+
+void Volumetric3D_harmonics::finalize() {
+    delete mSH;
+    delete mSHSrc;
+    mSH = mSHSrc = 0;
+}
+
+bool Volumetric3D_harmonics::radialBasis(double r, double rElemCenter, RDColX &weights) const {
+    int nknots = mKnots.rows();
+    if (rElemCenter <= mKnots(0) || rElemCenter >= mKnots(nknots - 1)) return false;
+    // element inside model but point outside
+    r = std::min(std::max(r, mKnots(0)), mKnots(nknots - 1));
+    int k = 0;
+    while (k < nknots - 2 && r > mKnots(k + 1)) k++;
+    double t = (r - mKnots(k)) / (mKnots(k + 1) - mKnots(k));
+    weights = RDColX::Zero(nknots);
+    weights(k) = 1. - t;
+    weights(k + 1) = t;
+    return true;
+}
+
+bool Volumetric3D_harmonics::get3dProperties(double r, double theta, double phi, double rElemCenter,
+    double &dvpv, double &dvph, double &dvsv, double &dvsh, double &drho) const {
+    RDColX weights;
+    if (!radialBasis(r, rElemCenter, weights)) return false;
+    RDColX dvsdvp;
+    mSH->evaluate(weights, theta, phi, dvsdvp);
+    dvpv = dvph = dvsdvp(1);
+    dvsv = dvsh = dvsdvp(0);
+    drho = mScaleRho * dvsdvp(0);
+    return true;
+}
+
+bool Volumetric3D_harmonics::get3dPropertiesRing(double r, double theta, int nr, double rElemCenter,
+    RDMatX5 &properties, IColX &inRange) const {
+    RDColX weights;
+    if (!radialBasis(r, rElemCenter, weights)) {
+        properties = RDMatX5::Zero(nr, 5);
+        inRange = IColX::Zero(nr);
+        return true;
+    }
+    RDMatXX dvsdvp;
+    mSHSrc->synthesizeRing(weights, theta, nr, dvsdvp);
+    properties.resize(nr, 5);
+    properties.col(0) = properties.col(1) = dvsdvp.col(1);
+    properties.col(2) = properties.col(3) = dvsdvp.col(0);
+    properties.col(4) = mScaleRho * dvsdvp.col(0);
+    inRange = IColX::Ones(nr);
+    return true;
+}
+
+std::string Volumetric3D_harmonics::verbose() const {
+    std::stringstream ss;
+    ss << "\n======================= 3D Volumetric ======================" << std::endl;
+    ss << "  Model Name           =   harmonics" << std::endl;
+    ss << "  Data File            =   " << mFileName << std::endl;
+    ss << "  Radii (km)           =   [" << mKnots(0) / 1e3 << ", " << mKnots(mKnots.rows() - 1) / 1e3 << "]" << std::endl;
+    ss << "  Number of Knots      =   " << mKnots.rows() << std::endl;
+    ss << "  Reference Type       =   Reference1D" << std::endl;
+    ss << "  Max. Degree of Vs    =   " << mLMaxVs << std::endl;
+    ss << "  Max. Degree of Vp    =   " << mLMaxVp << std::endl;
+    ss << "  Anisotropic          =   NO" << std::endl;
+    ss << "  3D Density           =   " << (mScaleRho != 0. ? "YES" : "NO") << std::endl;
+    ss << "======================= 3D Volumetric ======================\n" << std::endl;
+    return ss.str();
+}
@@ -0,0 +1,59 @@
+// Volumetric3D_harmonics.h
+// created by agent on 19-Oct-2026
+// mantle model given by spherical-harmonic coefficients on radial knots
+// a general form of s20rts/s40rts-style tomography models
+
+#pragma once
+#include "Volumetric3D.h"
+
+class SphericalHarmonics;
+
+class Volumetric3D_harmonics: public Volumetric3D {
+public:
+    
+    ~Volumetric3D_harmonics() {finalize();};
+    
+    void initialize();
+    void initialize(const std::vector<std::string> &params);
+    
+    void finalize();
+    
+    bool get3dProperties(double r, double theta, double phi, double rElemCenter,
+        double &dvpv, double &dvph, double &dvsv, double &dvsh, double &drho) const;
+    
+    bool get3dPropertiesRing(double r, double theta, int nr, double rElemCenter,
+        RDMatX5 &properties, IColX &inRange) const;
+    
+    ReferenceTypes getReferenceType() const {return ReferenceTypes::Reference1D;};
+    
+    std::string verbose() const;
+    
+    // source location for ring synthesis
+    void setSource(double srcLat, double srcLon, double srcDep) {
+        mSrcLat = srcLat; mSrcLon = srcLon; mSrcDep = srcDep;};
+    
+private:
+    // values of linear radial basis functions at r
+    // RETURN: false if element is outside the knots
+    bool radialBasis(double r, double rElemCenter, RDColX &weights) const;
+    
+    // file
+    std::string mFileName;
+    double mScaleRho = .4;
+    
+    // maximum degrees
+    int mLMaxVs = 0;
+    int mLMaxVp = 0;
+    
+    // radial knots
+    RDColX mKnots;
+    
+    // source location
+    double mSrcLat = 0.;
+    double mSrcLon = 0.;
+    double mSrcDep = 0.;
+    
+    // expansion in the geographic and the source-centered frames
+    SphericalHarmonics *mSH = 0;
+    SphericalHarmonics *mSHSrc = 0;
+};
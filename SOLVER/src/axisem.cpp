@@ -6,6 +6,7 @@
 #include "XTimer.h"
 
 #include "XMPI.h"
+#include "IOThread.h"
 #include "eigenc.h"
 #include "eigenp.h"
 
@@ -51,6 +52,7 @@ int axisem_main(int argc, char *argv[]) {
         
         //////// 3D models 
         XTimer::begin("3D Models", 0);
+        ModelCache::setup(*(pl.mParameters));
         Volumetric3D::buildInparam(pl.mVolumetric3D, *(pl.mParameters), pl.mExodusModel, 
             srcLat, srcLon, srcDep, verbose);
         Geometric3D::buildInparam(pl.mGeometric3D, *(pl.mParameters), verbose);
@@ -111,7 +113,7 @@ int axisem_main(int argc, char *argv[]) {
         //////// receivers
         XTimer::begin("Receivers", 0);
         ReceiverCollection::buildInparam(pl.mReceivers, 
-            *(pl.mParameters), srcLat, srcLon, srcDep, verbose);
+            *(pl.mParameters), *(pl.mSTF), srcLat, srcLon, srcDep, verbose);
         XTimer::end("Receivers", 0);    
         
         //////// computational domain
@@ -153,6 +155,15 @@ int axisem_main(int argc, char *argv[]) {
         int stabInt = pl.mParameters->getValue<int>("OPTION_STABILITY_INTERVAL");
         sv.mNewmark = new Newmark(sv.mDomain, infoInt, stabInt);
         
+        //////// background output
+        int ioQueue = pl.mParameters->getValue<int>("OPTION_IO_QUEUE_DEPTH");
+        if (ioQueue > 0 && !XMPI::threadFunneled()) {
+            // MPI library does not allow a second thread 
+            XMPI::cout << "WARNING: MPI_THREAD_FUNNELED not provided; OPTION_IO_QUEUE_DEPTH set to 0." << XMPI::endl;
+            ioQueue = 0;
+        }
+        IOThread::initialize(ioQueue);
+        
         //////// final preparations
         // finalize preloop variables before time loop starts
         pl.finalize();
@@ -223,4 +234,6 @@ extern void finalizeSolverStatic() {
     SolverFFTW_N6::finalize();
     SolverFFTW_N9::finalize();
     PreloopFFTW::finalize();
+    // background output
+    IOThread::finalize();
 };
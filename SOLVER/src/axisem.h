@@ -15,6 +15,7 @@
 #include "Volumetric3D.h"
 #include "Geometric3D.h"
 #include "OceanLoad3D.h"
+#include "ModelCache.h"
 #include "Source.h"
 #include "Mesh.h"
 #include "AttBuilder.h"
@@ -9,9 +9,18 @@
 #include "SourceTerm.h"
 #include "SourceTimeFunction.h"
 #include "Station.h"
+#include "StationGroup.h"
+#include "StationOutputH5.h"
+#include "StationDecimator.h"
+#include "StationConvolver.h"
+#include "Ring.h"
+#include "SurfaceDatabase.h"
+#include "ReciprocalDatabase.h"
+#include "Seismometer.h"
 #include "XMPI.h"
 #include "NuWisdom.h"
 #include "XTimer.h"
+#include "IOThread.h"
 
 Domain::Domain() {
     #ifdef _MEASURE_TIMELOOP
@@ -28,6 +37,14 @@ Domain::~Domain() {
     for (const auto &e: mElements) delete e;
     for (const auto &e: mSourceTerms) delete e;
     for (const auto &e: mStations) delete e;
+    for (const auto &e: mStationGroups) delete e;
+    if (mStationOutput) delete mStationOutput;
+    if (mStationDecimator) delete mStationDecimator;
+    if (mStationConvolver) delete mStationConvolver;
+    for (const auto &e: mStationOutputsSTF) delete e;
+    for (const auto &e: mRings) delete e;
+    if (mSurfaceDatabase) delete mSurfaceDatabase;
+    if (mReciprocalDatabase) delete mReciprocalDatabase;
     if (mSTF) delete mSTF;
     if (mMsgInfo) delete mMsgInfo;
     if (mMsgBuffer) delete mMsgBuffer;
@@ -53,6 +70,43 @@ int Domain::addElement(Element *elem) {
     return elem->getDomainTag();
 }
 
+void Domain::addStation(Station *station) {
+    mStations.push_back(station);
+    const Element *elem = station->getSeismometer().getElement();
+    auto key = std::make_pair(elem, station->getInterval());
+    auto it = mStationGroupMap.find(key);
+    if (it == mStationGroupMap.end()) {
+        StationGroup *group = new StationGroup(elem, station->getInterval());
+        mStationGroups.push_back(group);
+        it = mStationGroupMap.insert(std::make_pair(key, group)).first;
+    }
+    it->second->addStation(station);
+}
+
+int Domain::setStationOffsets() const {
+    int offset = 0;
+    for (const auto &group: mStationGroups) {
+        group->setOffset(offset);
+        offset += group->getNumStations() * 3;
+    }
+    return offset;
+}
+
+void Domain::setStationDecimator(StationDecimator *decimator) {
+    if (mStationDecimator) delete mStationDecimator;
+    mStationDecimator = decimator;
+    mStationDecimator->setNumColumns(setStationOffsets());
+}
+
+void Domain::setStationConvolver(StationConvolver *convolver, 
+    const std::vector<StationOutputH5 *> &outputs) {
+    if (mStationConvolver) delete mStationConvolver;
+    for (const auto &e: mStationOutputsSTF) delete e;
+    mStationConvolver = convolver;
+    mStationOutputsSTF = outputs;
+    mStationConvolver->setNumColumns(setStationOffsets());
+}
+
 void Domain::test() const {
     for (const auto &point: mPoints) point->test();
     for (const auto &elem: mElements) elem->test();
@@ -171,19 +225,70 @@ void Domain::record(int tstep, Real t) const {
         mTimerOthers->resume();
     #endif
     
-    for (const auto &station: mStations) station->record(tstep, t);
+    if (mStationDecimator) {
+        // all steps go through the anti-alias filter
+        for (const auto &group: mStationGroups) group->feed(mStationDecimator->getInput());
+        if (mStationDecimator->push(tstep, t)) 
+            recordSample(mStationDecimator->getOutputStep(), 
+                mStationDecimator->getOutputTime(), mStationDecimator->getOutput());
+    } else if (mStationConvolver) {
+        if (tstep % mStationConvolver->getInterval() == 0) {
+            RRowX &motion = mStationConvolver->getInput();
+            for (const auto &group: mStationGroups) group->feed(motion);
+            recordSample(tstep, t, motion);
+        }
+    } else {
+        for (const auto &group: mStationGroups) group->record(tstep, t);
+        if (mStationOutput) mStationOutput->recordTime(tstep, t);
+    }
+    for (const auto &ring: mRings) ring->record(tstep, t);
+    if (mSurfaceDatabase) mSurfaceDatabase->record(tstep, t);
+    if (mReciprocalDatabase) mReciprocalDatabase->record(tstep, t);
     
     #ifdef _MEASURE_TIMELOOP
         mTimerOthers->stop();
     #endif
 }
 
+void Domain::recordSample(int tstep, Real t, const RRowX &motion) const {
+    for (const auto &group: mStationGroups) group->record(t, motion);
+    if (mStationOutput) mStationOutput->recordTime(tstep, t);
+    if (mStationConvolver) {
+        mStationConvolver->getInput() = motion;
+        if (mStationConvolver->push(tstep, t)) recordConvolved();
+    }
+}
+
+void Domain::recordConvolved() const {
+    for (int irow = 0; irow < mStationConvolver->getNumOutputs(); irow++) {
+        int tstep = mStationConvolver->getOutputStep(irow);
+        Real t = mStationConvolver->getOutputTime(irow);
+        for (int istf = 0; istf < mStationConvolver->getNumSTFs(); istf++) {
+            const RRowX &motion = mStationConvolver->getOutput(istf, irow);
+            for (const auto &group: mStationGroups) group->record(istf, t, motion);
+            if (mStationOutputsSTF.size() > 0) mStationOutputsSTF[istf]->recordTime(tstep, t);
+        }
+    }
+}
+
 void Domain::dumpLeft() const {
     #ifdef _MEASURE_TIMELOOP
         mTimerOthers->resume();
     #endif
     
+    if (mStationDecimator) 
+        while (mStationDecimator->drain()) 
+            recordSample(mStationDecimator->getOutputStep(), 
+                mStationDecimator->getOutputTime(), mStationDecimator->getOutput());
+    if (mStationConvolver) 
+        while (mStationConvolver->drain()) recordConvolved();
     for (const auto &station: mStations) station->dumpLeft();
+    if (mStationOutput) mStationOutput->dumpBufferToFile();
+    for (const auto &output: mStationOutputsSTF) output->dumpBufferToFile();
+    for (const auto &ring: mRings) ring->dumpLeft();
+    if (mSurfaceDatabase) mSurfaceDatabase->dumpLeft();
+    if (mReciprocalDatabase) mReciprocalDatabase->dumpLeft();
+    IOThread::flush();
     
     #ifdef _MEASURE_TIMELOOP
         mTimerOthers->stop();
@@ -376,7 +481,8 @@ void Domain::dumpWisdom() const {
         for (int i = 0; i < buffer.size() / 4; i++) 
             wis.insert(buffer[i * 4], buffer[i * 4 + 1], 
                 round(buffer[i * 4 + 2]), round(buffer[i * 4 + 3]));
-        wis.writeToFile(mLearnPar->mFileName, false);
+        std::string fname = mLearnPar->mFileName;
+        IOThread::submit([wis, fname] {wis.writeToFile(fname, false);});
     }
     
     #ifdef _MEASURE_TIMELOOP
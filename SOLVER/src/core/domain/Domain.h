@@ -4,7 +4,8 @@
 
 #pragma once
 #include <vector>
-#include "global.h"
+#include <map>
+#include "eigenc.h"
 
 #ifdef _MEASURE_TIMELOOP
     #include "XTimer.h"
@@ -16,6 +17,13 @@ class SolidFluidPoint;
 class SourceTerm;
 class SourceTimeFunction;
 class Station;
+class StationGroup;
+class StationOutputH5;
+class StationDecimator;
+class StationConvolver;
+class Ring;
+class SurfaceDatabase;
+class ReciprocalDatabase;
 struct MessagingInfo;
 struct MessagingBuffer;
 struct LearnParameters;
@@ -31,7 +39,16 @@ public:
     int addElement(Element *elem);
     void addSourceTerm(SourceTerm *source) {mSourceTerms.push_back(source);};
     void setSTF(SourceTimeFunction *stf) {mSTF = stf;};
-    void addStation(Station *station) {mStations.push_back(station);};
+    void addStation(Station *station);
+    void setStationOutput(StationOutputH5 *output) {mStationOutput = output;};
+    // after all stations are added
+    void setStationDecimator(StationDecimator *decimator);
+    // outputs: single-file outputs of convolved seismograms, if any
+    void setStationConvolver(StationConvolver *convolver, 
+        const std::vector<StationOutputH5 *> &outputs);
+    void addRing(Ring *ring) {mRings.push_back(ring);};
+    void setSurfaceDatabase(SurfaceDatabase *database) {mSurfaceDatabase = database;};
+    void setReciprocalDatabase(ReciprocalDatabase *database) {mReciprocalDatabase = database;};
     void setMessaging(MessagingInfo *msgInfo, MessagingBuffer *msgBuffer) 
         {mMsgInfo = msgInfo; mMsgBuffer = msgBuffer;};
     void addSFPoint(SolidFluidPoint *SFPoint) {mSFPoints.push_back(SFPoint);};
@@ -84,6 +101,13 @@ public:
     
 private:
     bool pointInPreviousRank(int myPointTag) const;
+    // first column of each StationGroup in rank-level rows
+    // RETURN: number of columns
+    int setStationOffsets() const;
+    // record a sample of all stations and feed it to convolver
+    void recordSample(int tstep, Real t, const RRowX &motion) const;
+    // record samples ready from convolver
+    void recordConvolved() const;
     
     // points
     std::vector<Point *> mPoints;
@@ -97,6 +121,23 @@ private:
     SourceTimeFunction *mSTF = 0;
     // stations
     std::vector<Station *> mStations;
+    // stations grouped by element and record interval
+    std::vector<StationGroup *> mStationGroups;
+    std::map<std::pair<const Element *, int>, StationGroup *> mStationGroupMap;
+    // rank-level station output, null if stations write their own files
+    StationOutputH5 *mStationOutput = 0;
+    // anti-alias decimation
+    StationDecimator *mStationDecimator = 0;
+    // convolution with additional STFs
+    StationConvolver *mStationConvolver = 0;
+    std::vector<StationOutputH5 *> mStationOutputsSTF;
+    // ring receivers
+    std::vector<Ring *> mRings;
+    // surface wavefield database
+    SurfaceDatabase *mSurfaceDatabase = 0;
+    
+    // reciprocal strain database
+    ReciprocalDatabase *mReciprocalDatabase = 0;
     // massaging 
     MessagingInfo *mMsgInfo = 0;
     MessagingBuffer *mMsgBuffer = 0;
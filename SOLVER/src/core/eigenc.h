@@ -11,11 +11,13 @@
 
 // pointwise fields
 typedef Eigen::Matrix<Real, Eigen::Dynamic, 1> RColX;
+typedef Eigen::Matrix<Real, 1, Eigen::Dynamic> RRowX;
 typedef Eigen::Matrix<Real, Eigen::Dynamic, 3> RMatX3;
 typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1> CColX;
 typedef Eigen::Matrix<Complex, Eigen::Dynamic, 3> CMatX3;
 typedef std::array<CMatX3, nPntElem> arPP_CMatX3; // source 
 typedef Eigen::Matrix<Real, 1, 3> RRow3;         // receiver
+typedef Eigen::Matrix<Real, 3, 3> RMat33;        // receiver
 typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic> CMatXX; // mpi buffer
 typedef Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic> RMatXX;
 
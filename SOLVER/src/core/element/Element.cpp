@@ -25,6 +25,18 @@ void Element::addSourceTerm(const arPP_CMatX3 &source) const {
         mPoints[i]->addToStiff(source[i]);
 }
 
+void Element::stackGroundMotionField(const vec_ar3_CMatPP &fieldPP, CMatXX &field) const {
+    int nu = mMaxNu + 1;
+    for (int alpha = 0; alpha < nu; alpha++) {
+        for (int idim = 0; idim < 3; idim++) {
+            int ipnt = 0;
+            for (int ipol = 0; ipol <= nPol; ipol++)
+                for (int jpol = 0; jpol <= nPol; jpol++)
+                    field(idim * nu + alpha, ipnt++) = fieldPP[alpha][idim](ipol, jpol);
+        }
+    }
+}
+
 int Element::sizeComm() const {
     int ipol, jpol;
     
@@ -53,7 +65,7 @@ bool Element::axial() const {
 
 std::string Element::costSignature() const {
     std::stringstream ss;
-    ss << verbose() << "$DimAzimuth=" << mMaxNr << "$Axial=" << (axial() ? "T" : "F");
+    ss << verbose() << "$" << verboseAttenuation() << "$DimAzimuth=" << mMaxNr << "$Axial=" << (axial() ? "T" : "F");
     return ss.str();
 }
 
@@ -23,12 +23,21 @@ public:
     // test stiffness 
     virtual void test() const = 0;
     
-    // compute Real displacement, used by receiver
-    virtual void computeGroundMotion(Real phi, const RMatPP &weights, RRow3 &u_spz) const = 0; 
+    // compute Fourier displacement stacked for receivers in this element
+    // field: (3 * (maxNu + 1)) x nPntElem, preallocated, row = idim * (maxNu + 1) + alpha
+    virtual void computeGroundMotionField(CMatXX &field) const = 0; 
+    
+    // compute Fourier strain tensor stacked for reciprocal database
+    // field: (6 * (maxNu + 1)) x nPntElem, preallocated, row = icomp * (maxNu + 1) + alpha
+    // components: ss, pp, zz, pz, sz, sp (tensor, not engineering shear)
+    virtual void computeStrainField(CMatXX &field) const = 0; 
     
     // verbose
     virtual std::string verbose() const = 0;
     
+    // attenuation type, for cost signature
+    virtual std::string verboseAttenuation() const {return "NoAttenuation";};
+    
     // get point ptr
     const Point *getPoint(int index) const {return mPoints[index];};
     
@@ -40,6 +49,7 @@ public:
     
     // get nr 
     int getMaxNr() const {return mMaxNr;};
+    int getMaxNu() const {return mMaxNu;};
     
     // signature for cost measurement
     std::string costSignature() const;
@@ -48,6 +58,9 @@ public:
     bool axial() const;
     
 protected:
+    // stack a Fourier field for receivers
+    void stackGroundMotionField(const vec_ar3_CMatPP &fieldPP, CMatXX &field) const;
+    
     int mMaxNu;
     int mMaxNr;
     std::array<Point *, nPntElem> mPoints;
@@ -124,7 +124,7 @@ void FluidElement::test() const {
     }
 }
 
-void FluidElement::computeGroundMotion(Real phi, const RMatPP &weights, RRow3 &u_spz) const {
+void FluidElement::computeGroundMotionField(CMatXX &field) const {
     // get chi
     int ipnt = 0;
     for (int ipol = 0; ipol <= nPol; ipol++)
@@ -133,25 +133,12 @@ void FluidElement::computeGroundMotion(Real phi, const RMatPP &weights, RRow3 &u
     // u = nabla(chi) / rho       
     mGradient->gradScalar(sDispl, sStrain, mMaxNu, mMaxNr % 2 == 0);
     mAcoustic->strainToStress(sStrain, sStress, mMaxNu);
-    // compute ground motion pointwise
-    u_spz.setZero();
-    for (int ipol = 0; ipol <= nPol; ipol++) {
-        for (int jpol = 0; jpol <= nPol; jpol++) {
-            if (std::abs(weights(ipol, jpol)) < tinyDouble) continue;
-            Real up0 = sStress[0][0](ipol, jpol).real();
-            Real up1 = sStress[0][1](ipol, jpol).real();
-            Real up2 = sStress[0][2](ipol, jpol).real();
-            for (int alpha = 1; alpha <= mMaxNu - (int)(mMaxNr % 2 == 0); alpha++) {
-                Complex expval = two * exp((Real)alpha * phi * ii);
-                up0 += (expval * sStress[alpha][0](ipol, jpol)).real();
-                up1 += (expval * sStress[alpha][1](ipol, jpol)).real();
-                up2 += (expval * sStress[alpha][2](ipol, jpol)).real();
-            }
-            u_spz(0) += weights(ipol, jpol) * up0;
-            u_spz(1) += weights(ipol, jpol) * up1;
-            u_spz(2) += weights(ipol, jpol) * up2;
-        }
-    }
+    stackGroundMotionField(sStress, field);
+}
+
+void FluidElement::computeStrainField(CMatXX &field) const {
+    throw std::runtime_error("FluidElement::computeStrainField || "
+        "Strain tensor is not available in fluid.");
 }
 
 std::string FluidElement::verbose() const {
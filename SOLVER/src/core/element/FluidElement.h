@@ -23,8 +23,9 @@ public:
     // test stiffness 
     void test() const;
     
-    // compute Real displacement, used by receiver
-    void computeGroundMotion(Real phi, const RMatPP &weights, RRow3 &u_spz) const; 
+    // compute Fourier displacement and strain, used by receivers
+    void computeGroundMotionField(CMatXX &field) const; 
+    void computeStrainField(CMatXX &field) const; 
     
     // verbose
     std::string verbose() const;
@@ -150,29 +150,49 @@ void SolidElement::test() const {
     }
 }
 
-void SolidElement::computeGroundMotion(Real phi, const RMatPP &weights, RRow3 &u_spz) const {
+void SolidElement::computeGroundMotionField(CMatXX &field) const {
     // get displ from points
     int ipnt = 0;
     for (int ipol = 0; ipol <= nPol; ipol++)
         for (int jpol = 0; jpol <= nPol; jpol++)
             mPoints[ipnt++]->scatterDisplToElement(sDispl, ipol, jpol, mMaxNu);
-    // compute ground motion pointwise
-    u_spz.setZero();
-    for (int ipol = 0; ipol <= nPol; ipol++) {
-        for (int jpol = 0; jpol <= nPol; jpol++) {
-            if (std::abs(weights(ipol, jpol)) < tinyDouble) continue;
-            Real up0 = sDispl[0][0](ipol, jpol).real();
-            Real up1 = sDispl[0][1](ipol, jpol).real();
-            Real up2 = sDispl[0][2](ipol, jpol).real();
-            for (int alpha = 1; alpha <= mMaxNu - (int)(mMaxNr % 2 == 0); alpha++) {
-                Complex expval = two * exp((Real)alpha * phi * ii);
-                up0 += (expval * sDispl[alpha][0](ipol, jpol)).real();
-                up1 += (expval * sDispl[alpha][1](ipol, jpol)).real();
-                up2 += (expval * sDispl[alpha][2](ipol, jpol)).real();
+    stackGroundMotionField(sDispl, field);
+}
+
+void SolidElement::computeStrainField(CMatXX &field) const {
+    // get displ from points
+    int ipnt = 0;
+    for (int ipol = 0; ipol <= nPol; ipol++)
+        for (int jpol = 0; jpol <= nPol; jpol++)
+            mPoints[ipnt++]->scatterDisplToElement(sDispl, ipol, jpol, mMaxNu);
+    mGradient->gradVector(sDispl, sStrain, mMaxNu, mMaxNr % 2 == 0);
+    // symmetric part of displacement gradient
+    int nu = mMaxNu + 1;
+    bool voigt = mGradient->isVoigt();
+    for (int alpha = 0; alpha < nu; alpha++) {
+        const ar9_CMatPP &g = sStrain[alpha];
+        ipnt = 0;
+        for (int ipol = 0; ipol <= nPol; ipol++) {
+            for (int jpol = 0; jpol <= nPol; jpol++) {
+                if (voigt) {
+                    // ss, pp, zz, 2pz, 2sz, 2sp
+                    field(0 * nu + alpha, ipnt) = g[0](ipol, jpol);
+                    field(1 * nu + alpha, ipnt) = g[1](ipol, jpol);
+                    field(2 * nu + alpha, ipnt) = g[2](ipol, jpol);
+                    field(3 * nu + alpha, ipnt) = half * g[3](ipol, jpol);
+                    field(4 * nu + alpha, ipnt) = half * g[4](ipol, jpol);
+                    field(5 * nu + alpha, ipnt) = half * g[5](ipol, jpol);
+                } else {
+                    // ui_j at i * 3 + j
+                    field(0 * nu + alpha, ipnt) = g[0](ipol, jpol);
+                    field(1 * nu + alpha, ipnt) = g[4](ipol, jpol);
+                    field(2 * nu + alpha, ipnt) = g[8](ipol, jpol);
+                    field(3 * nu + alpha, ipnt) = half * (g[5](ipol, jpol) + g[7](ipol, jpol));
+                    field(4 * nu + alpha, ipnt) = half * (g[2](ipol, jpol) + g[6](ipol, jpol));
+                    field(5 * nu + alpha, ipnt) = half * (g[1](ipol, jpol) + g[3](ipol, jpol));
+                }
+                ipnt++;
             }
-            u_spz(0) += weights(ipol, jpol) * up0;
-            u_spz(1) += weights(ipol, jpol) * up1;
-            u_spz(2) += weights(ipol, jpol) * up2;
         }
     }
 }
@@ -181,6 +201,10 @@ std::string SolidElement::verbose() const {
     return "SolidElement$" + mElastic->verbose();
 }
 
+std::string SolidElement::verboseAttenuation() const {
+    return mElastic->verboseAttenuation();
+}
+
 void SolidElement::displToStiff(const vec_ar3_CMatPP &displ, vec_ar3_CMatPP &stiff) const {
     mGradient->gradVector(displ, sStrain, mMaxNu, mMaxNr % 2 == 0);
     mElastic->strainToStress(sStrain, sStress, mMaxNu);
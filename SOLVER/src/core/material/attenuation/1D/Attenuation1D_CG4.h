@@ -27,6 +27,9 @@ public:
     // reset to zero 
     void resetZero(); 
     
+    // verbose
+    std::string verbose() const {return "Attenuation1D_CG4";};
+    
 private:
     
     // memory variables
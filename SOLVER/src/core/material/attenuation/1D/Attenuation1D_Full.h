@@ -26,6 +26,9 @@ public:
     // reset to zero 
     void resetZero(); 
     
+    // verbose
+    std::string verbose() const {return "Attenuation1D_Full";};
+    
 private:
     // memory variables
     vec_ar6_CMatPP mStressR;
@@ -26,6 +26,9 @@ public:
     // reset to zero 
     void resetZero(); 
     
+    // verbose
+    std::string verbose() const {return "Attenuation3D_Full";};
+    
 private:
     // memory variables
     RMatXN6 mStressR;
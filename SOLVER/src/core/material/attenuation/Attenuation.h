@@ -19,6 +19,9 @@ public:
     // check memory variable size
     virtual void checkCompatibility(int Nr) const = 0;
     
+    // verbose
+    virtual std::string verbose() const = 0;
+    
 protected:
     int mNSLS;
     RColX mAlpha;
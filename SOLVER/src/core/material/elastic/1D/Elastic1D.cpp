@@ -24,3 +24,7 @@ void Elastic1D::resetZero() {
     if (mAttenuation) mAttenuation->resetZero();
 }
 
+std::string Elastic1D::verboseAttenuation() const {
+    return mAttenuation ? mAttenuation->verbose() : "NoAttenuation";
+}
+
@@ -20,6 +20,9 @@ public:
     // reset to zero 
     void resetZero(); 
     
+    // attenuation type, for cost signature
+    std::string verboseAttenuation() const;
+    
 protected:
     Attenuation1D *mAttenuation;
 };
@@ -22,6 +22,10 @@ void Elastic3D::resetZero() {
     if (mAttenuation) mAttenuation->resetZero();
 }
 
+std::string Elastic3D::verboseAttenuation() const {
+    return mAttenuation ? mAttenuation->verbose() : "NoAttenuation";
+}
+
 // data structure convertors
 void Elastic3D::flattenVector(const vec_ar9_CMatPP &mat, CMatXN9 &row, int Nu) {
     for (int alpha = 0; alpha <= Nu; alpha++) 
@@ -20,6 +20,9 @@ public:
     // reset to zero 
     void resetZero(); 
     
+    // attenuation type, for cost signature
+    std::string verboseAttenuation() const;
+    
     // change data structure
     // make flat
     static void flattenVector(const vec_ar9_CMatPP &mat, CMatXN9 &row, int Nu);
@@ -20,6 +20,9 @@ public:
     // verbose
     virtual std::string verbose() const = 0;
     
+    // attenuation type, for cost signature
+    virtual std::string verboseAttenuation() const = 0;
+    
     // reset to zero 
     virtual void resetZero() = 0; 
     
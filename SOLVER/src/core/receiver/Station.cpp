@@ -14,16 +14,19 @@ mInterval(interval), mSeismometer(seismometer), mRecorder(recorder) {
 Station::~Station() {
     mRecorder->close();
     delete mRecorder;
+    for (const auto &rec: mRecordersSTF) {
+        rec->close();
+        delete rec;
+    }
     delete mSeismometer;
 }
 
-void Station::record(int tstep, Real t) {
-    if (tstep % mInterval != 0) return;
-    static RRow3 gm;
-    mSeismometer->getGroundMotion(gm);
-    mRecorder->record(t, gm);
+void Station::addRecorderSTF(Recorder *recorder) {
+    recorder->open();
+    mRecordersSTF.push_back(recorder);
 }
 
 void Station::dumpLeft() {
     mRecorder->dumpBufferToFile();
+    for (const auto &rec: mRecordersSTF) rec->dumpBufferToFile();
 }
\ No newline at end of file
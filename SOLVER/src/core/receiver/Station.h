@@ -7,18 +7,28 @@
 
 #include "Seismometer.h"
 #include "Recorder.h"
+#include <vector>
 
 class Station {
 public:        
     Station(int interval, Seismometer *seismometer, Recorder *recorder);
     virtual ~Station();
     
-    void record(int tstep, Real t);
+    // record ground motion computed by the StationGroup
+    void record(Real t, const RRow3 &gm) {mRecorder->record(t, gm);};
+    
+    // ground motion convolved with an additional STF
+    void addRecorderSTF(Recorder *recorder);
+    void record(int istf, Real t, const RRow3 &gm) {mRecordersSTF[istf]->record(t, gm);};
     
     void dumpLeft();
     
+    int getInterval() const {return mInterval;};
+    const Seismometer &getSeismometer() const {return *mSeismometer;};
+    
 protected:
     int mInterval;
     Seismometer *mSeismometer;
     Recorder *mRecorder;
+    std::vector<Recorder *> mRecordersSTF;
 };
\ No newline at end of file
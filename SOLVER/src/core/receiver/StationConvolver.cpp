@@ -0,0 +1,125 @@
+// StationConvolver.cpp
+// created by agent on 19-Oct-2026
+// convolution of station output with additional source time functions,
+// overlap-add FFT applied to the ground motions of all stations on this rank at once
+
+#include "StationConvolver.h"
+#include <algorithm>
+
+StationConvolver::StationConvolver(const RMatXX &kernels, const std::vector<bool> &integrate, 
+    int interval): mInterval(interval), mIntegrate(integrate) {
+    // block size from FFT size
+    mNumTaps = kernels.rows();
+    mCenter = mNumTaps / 2;
+    mSizeFFT = 256;
+    while (mSizeFFT < 2 * mNumTaps) mSizeFFT *= 2;
+    mBlockSize = mSizeFFT - mNumTaps + 1;
+    mSteps.assign(mBlockSize + mCenter + 1, 0);
+    mTimes.assign(mBlockSize + mCenter + 1, 0.);
+    
+    // kernel spectra
+    int nstf = kernels.cols();
+    int nc = mSizeFFT / 2 + 1;
+    int n[] = {mSizeFFT};
+    RMatXX padded = RMatXX::Zero(mSizeFFT, nstf);
+    padded.topRows(mNumTaps) = kernels;
+    mKernelSpectra = CMatXX::Zero(nc, nstf);
+    PlanFFTW plan = planR2CFFTW(1, n, nstf, padded.data(), n, 1, mSizeFFT, 
+        complexFFTW(mKernelSpectra.data()), n, 1, nc, FFTW_ESTIMATE);
+    execFFTW(plan);
+    distroyFFTW(plan);
+    mKernelSpectra /= (Real)mSizeFFT;
+    setNumColumns(0);
+}
+
+StationConvolver::~StationConvolver() {
+    destroyPlans();
+}
+
+void StationConvolver::destroyPlans() {
+    if (!mPlanned) return;
+    distroyFFTW(mPlanR2C);
+    distroyFFTW(mPlanC2R);
+    mPlanned = false;
+}
+
+void StationConvolver::setNumColumns(int ncols) {
+    int nc = mSizeFFT / 2 + 1;
+    mBlock = RMatXX::Zero(mSizeFFT, ncols);
+    mSpectrum = CMatXX::Zero(nc, ncols);
+    mWork = CMatXX::Zero(nc, ncols);
+    mResult = RMatXX::Zero(mSizeFFT, ncols);
+    mInput = RRowX::Zero(ncols);
+    int nstf = getNumSTFs();
+    mOverlap.assign(nstf, RMatXX::Zero(mSizeFFT, ncols));
+    mSum.assign(nstf, RRowX::Zero(ncols));
+    mOutput.assign(nstf, std::vector<RRowX>(mBlockSize, RRowX::Zero(ncols)));
+    
+    // one plan for all columns
+    destroyPlans();
+    if (ncols == 0) return;
+    int n[] = {mSizeFFT};
+    mPlanR2C = planR2CFFTW(1, n, ncols, mBlock.data(), n, 1, mSizeFFT, 
+        complexFFTW(mSpectrum.data()), n, 1, nc, FFTW_ESTIMATE);
+    mPlanC2R = planC2RFFTW(1, n, ncols, complexFFTW(mWork.data()), n, 1, nc, 
+        mResult.data(), n, 1, mSizeFFT, FFTW_ESTIMATE);
+    mPlanned = true;
+}
+
+bool StationConvolver::push(int tstep, Real t) {
+    int iring = mNumInput % mSteps.size();
+    mSteps[iring] = tstep;
+    mTimes[iring] = t;
+    mBlock.row(mNumPadded % mBlockSize) = mInput;
+    mNumInput++;
+    mNumPadded++;
+    mNumOutputs = 0;
+    if (mNumPadded % mBlockSize == 0) processBlock();
+    return mNumOutputs > 0;
+}
+
+bool StationConvolver::drain() {
+    mNumOutputs = 0;
+    while (mNumEmitted < mNumInput && mNumOutputs == 0) {
+        // fill the rest of the block with zeros
+        int nfilled = mNumPadded % mBlockSize;
+        mBlock.middleRows(nfilled, mBlockSize - nfilled).setZero();
+        mNumPadded += mBlockSize - nfilled;
+        processBlock();
+    }
+    return mNumOutputs > 0;
+}
+
+void StationConvolver::processBlock() {
+    int ncols = mInput.size();
+    int first = mNumPadded - mBlockSize;
+    if (mPlanned) execFFTW(mPlanR2C);
+    
+    // rows first, ..., first + block - 1 of the full convolution are final;
+    // output n is row n + center, for emitted < n < number of inputs
+    int nlast = std::min(first + mBlockSize - 1 - mCenter, mNumInput - 1);
+    mFirstOutput = mNumEmitted;
+    mNumOutputs = std::max(nlast - mNumEmitted + 1, 0);
+    for (int istf = 0; istf < getNumSTFs(); istf++) {
+        mWork = mSpectrum.array().colwise() * mKernelSpectra.col(istf).array();
+        if (mPlanned) execFFTW(mPlanC2R);
+        RMatXX &overlap = mOverlap[istf];
+        overlap += mResult;
+        for (int irow = 0; irow < mNumOutputs; irow++) {
+            RRowX &out = mOutput[istf][irow];
+            out = overlap.row(mNumEmitted + irow + mCenter - first);
+            if (mIntegrate[istf]) {
+                // trapezoidal
+                mSum[istf] += out;
+                out = mSum[istf] - (Real).5 * out;
+            }
+        }
+        // move to next block
+        for (int icol = 0; icol < ncols; icol++) {
+            Real *col = overlap.col(icol).data();
+            std::copy(col + mBlockSize, col + mSizeFFT, col);
+        }
+        overlap.bottomRows(mBlockSize).setZero();
+    }
+    mNumEmitted += mNumOutputs;
+}
@@ -0,0 +1,89 @@
+// StationConvolver.h
+// created by agent on 19-Oct-2026
+// convolution of station output with additional source time functions,
+// overlap-add FFT applied to the ground motions of all stations on this rank at once
+
+#pragma once
+
+#include "SolverFFTW.h"
+#include <vector>
+
+class StationConvolver {
+public:
+    // kernels: one column per output STF, centered at the middle row
+    // integrate: whether to integrate the result, per output STF
+    // interval: record interval of input samples
+    StationConvolver(const RMatXX &kernels, const std::vector<bool> &integrate, int interval);
+    ~StationConvolver();
+    
+    // allocate for ncols = 3 * number of stations, before time loop
+    void setNumColumns(int ncols);
+    
+    int getInterval() const {return mInterval;};
+    int getNumSTFs() const {return mIntegrate.size();};
+    
+    // ground motions of current sample
+    RRowX &getInput() {return mInput;};
+    
+    // feed a sample recorded at tstep
+    // RETURN: whether output samples are ready 
+    bool push(int tstep, Real t);
+    
+    // zero-pad past the last sample to finish pending output samples
+    // RETURN: whether output samples are ready 
+    bool drain();
+    
+    // output samples ready, aligned with input samples
+    int getNumOutputs() const {return mNumOutputs;};
+    const RRowX &getOutput(int istf, int irow) const {return mOutput[istf][irow];};
+    int getOutputStep(int irow) const {return mSteps[(mFirstOutput + irow) % mSteps.size()];};
+    Real getOutputTime(int irow) const {return mTimes[(mFirstOutput + irow) % mTimes.size()];};
+    
+private:
+    // convolve a full input block
+    void processBlock();
+    void destroyPlans();
+    
+    // record interval
+    int mInterval;
+    // kernel length, center and input block size
+    int mNumTaps;
+    int mCenter;
+    int mBlockSize;
+    int mSizeFFT;
+    
+    // kernel spectra, (nfft / 2 + 1) x nstf, with 1 / nfft of inverse FFT
+    CMatXX mKernelSpectra;
+    std::vector<bool> mIntegrate;
+    
+    // workspaces, nfft x ncols or (nfft / 2 + 1) x ncols
+    // input block, zero-padded
+    RMatXX mBlock;
+    CMatXX mSpectrum;
+    CMatXX mWork;
+    RMatXX mResult;
+    // full convolution from the current block, per STF
+    std::vector<RMatXX> mOverlap;
+    // running sums for integration
+    std::vector<RRowX> mSum;
+    
+    // input and output
+    RRowX mInput;
+    std::vector<std::vector<RRowX>> mOutput;
+    int mNumOutputs = 0;
+    int mFirstOutput = 0;
+    
+    // steps and times of recent input samples
+    std::vector<int> mSteps;
+    std::vector<Real> mTimes;
+    
+    // sample counters
+    int mNumInput = 0;
+    int mNumPadded = 0;
+    int mNumEmitted = 0;
+    
+    // fftw
+    PlanFFTW mPlanR2C;
+    PlanFFTW mPlanC2R;
+    bool mPlanned = false;
+};
@@ -0,0 +1,58 @@
+// StationDecimator.cpp
+// created by agent on 19-Oct-2026
+// anti-alias decimation of station output, a polyphase FIR 
+// applied to the ground motions of all stations on this rank at once
+
+#include "StationDecimator.h"
+#include <stdexcept>
+
+StationDecimator::StationDecimator(int factor, const RColX &taps):
+mFactor(factor), mTaps(taps) {
+    if (mTaps.size() % 2 == 0) throw std::runtime_error("StationDecimator::StationDecimator || "
+        "Number of FIR taps must be odd.");
+    mTimes.assign(mTaps.size(), 0.);
+    mOutputStep = -mFactor;
+    setNumColumns(0);
+}
+
+void StationDecimator::setNumColumns(int ncols) {
+    mHistory = RMatXX::Zero(2 * mTaps.size(), ncols);
+    mInput = RRowX::Zero(ncols);
+    mOutput = RRowX::Zero(ncols);
+}
+
+bool StationDecimator::push(int tstep, Real t) {
+    int ntaps = mTaps.size();
+    int p = tstep % ntaps;
+    mHistory.row(p) = mInput;
+    mHistory.row(p + ntaps) = mInput;
+    mTimes[p] = t;
+    mLastStep = mPaddedStep = tstep;
+    return filter(tstep);
+}
+
+bool StationDecimator::drain() {
+    int ntaps = mTaps.size();
+    // output centered at mOutputStep + mFactor needs more input
+    while (mOutputStep + mFactor <= mLastStep) {
+        int n = ++mPaddedStep;
+        int p = n % ntaps;
+        mHistory.row(p).setZero();
+        mHistory.row(p + ntaps).setZero();
+        if (filter(n)) return true;
+    }
+    return false;
+}
+
+bool StationDecimator::filter(int n) {
+    int ntaps = mTaps.size();
+    int center = n - ntaps / 2;
+    if (center < 0 || center % mFactor != 0) return false;
+    // steps n - ntaps + 1, ..., n, in rows p + 1, ..., p + ntaps;
+    // one GEMV over all stations, only at output steps 
+    int p = n % ntaps;
+    mOutput.noalias() = mTaps.transpose() * mHistory.middleRows(p + 1, ntaps);
+    mOutputStep = center;
+    mOutputTime = mTimes[center % ntaps];
+    return true;
+}
@@ -0,0 +1,61 @@
+// StationDecimator.h
+// created by agent on 19-Oct-2026
+// anti-alias decimation of station output, a polyphase FIR 
+// applied to the ground motions of all stations on this rank at once
+
+#pragma once
+
+#include "eigenc.h"
+#include <vector>
+
+class StationDecimator {
+public:
+    // factor: decimation factor
+    // taps: symmetric lowpass FIR, odd length
+    StationDecimator(int factor, const RColX &taps);
+    
+    // allocate for ncols = 3 * number of stations, before time loop
+    void setNumColumns(int ncols);
+    
+    // ground motions of current step, filled by StationGroups
+    RRowX &getInput() {return mInput;};
+    
+    // feed input of step tstep, steps must be contiguous from 0
+    // RETURN: whether an output sample is ready 
+    bool push(int tstep, Real t);
+    
+    // zero-pad past the last step to finish pending output samples
+    // RETURN: whether an output sample is ready 
+    bool drain();
+    
+    // output sample, centered at input step getOutputStep()
+    const RRowX &getOutput() const {return mOutput;};
+    int getOutputStep() const {return mOutputStep;};
+    Real getOutputTime() const {return mOutputTime;};
+    
+private:
+    // compute output if step n completes a window
+    bool filter(int n);
+    
+    // decimation factor
+    int mFactor;
+    // taps
+    RColX mTaps;
+    
+    // history stored twice, such that the last nTaps steps 
+    // are always contiguous rows, (2 * nTaps) x ncols
+    RMatXX mHistory;
+    // time of the last nTaps steps
+    std::vector<Real> mTimes;
+    
+    // input and output rows
+    RRowX mInput;
+    RRowX mOutput;
+    
+    // last step pushed and last step padded
+    int mLastStep = -1;
+    int mPaddedStep = -1;
+    // last output
+    int mOutputStep;
+    Real mOutputTime = 0.;
+};
@@ -0,0 +1,91 @@
+// StationGroup.cpp
+// created by agent on 19-Oct-2026
+// stations located in the same element, 
+// whose ground motions are computed together
+
+#include "StationGroup.h"
+#include "Station.h"
+#include "Element.h"
+
+StationGroup::StationGroup(const Element *element, int interval):
+mElement(element), mInterval(interval) {
+    int nu = mElement->getMaxNu() + 1;
+    mPhases = CMatXX::Zero(0, nu);
+    mWeights = CMatXX::Zero(nPntElem, 0);
+    mField = CMatXX::Zero(3 * nu, nPntElem);
+    for (int idim = 0; idim < 3; idim++) mRotation[idim] = RMatX3::Zero(0, 3);
+}
+
+void StationGroup::addStation(Station *station) {
+    const Seismometer &seis = station->getSeismometer();
+    int irec = mStations.size();
+    mStations.push_back(station);
+    
+    // phases, Nyquist excluded for even Nr
+    int nu = mPhases.cols();
+    int maxAlpha = mElement->getMaxNu() - (int)(mElement->getMaxNr() % 2 == 0);
+    mPhases.conservativeResize(irec + 1, nu);
+    mPhases.row(irec).setZero();
+    mPhases(irec, 0) = one;
+    for (int alpha = 1; alpha <= maxAlpha; alpha++) 
+        mPhases(irec, alpha) = two * exp((Real)alpha * seis.getPhi() * ii);
+    
+    // weights
+    mWeights.conservativeResize(nPntElem, irec + 1);
+    const RMatPP &weights = seis.getWeights();
+    int ipnt = 0;
+    for (int ipol = 0; ipol <= nPol; ipol++)
+        for (int jpol = 0; jpol <= nPol; jpol++)
+            mWeights(ipnt++, irec) = weights(ipol, jpol);
+    
+    // workspaces
+    mInterp = CMatXX::Zero(3 * nu, irec + 1);
+    mMotionSPZ = RMatX3::Zero(irec + 1, 3);
+    mMotion = RMatX3::Zero(irec + 1, 3);
+    
+    // rotation
+    const RMat33 &rot = seis.getRotation();
+    for (int idim = 0; idim < 3; idim++) {
+        mRotation[idim].conservativeResize(irec + 1, 3);
+        mRotation[idim].row(irec) = rot.row(idim);
+    }
+}
+
+void StationGroup::record(int tstep, Real t) {
+    if (tstep % mInterval != 0) return;
+    compute();
+    for (int irec = 0; irec < mStations.size(); irec++) 
+        mStations[irec]->record(t, mMotion.row(irec));
+}
+
+void StationGroup::feed(RRowX &input) {
+    compute();
+    for (int irec = 0; irec < mStations.size(); irec++) 
+        input.segment(mOffset + irec * 3, 3) = mMotion.row(irec);
+}
+
+void StationGroup::record(Real t, const RRowX &output) {
+    for (int irec = 0; irec < mStations.size(); irec++) 
+        mStations[irec]->record(t, output.segment(mOffset + irec * 3, 3));
+}
+
+void StationGroup::record(int istf, Real t, const RRowX &output) {
+    for (int irec = 0; irec < mStations.size(); irec++) 
+        mStations[irec]->record(istf, t, output.segment(mOffset + irec * 3, 3));
+}
+
+void StationGroup::compute() {
+    // stacked field from element
+    mElement->computeGroundMotionField(mField);
+    // interpolate in (s, z) for all stations
+    mInterp.noalias() = mField * mWeights;
+    // sum over Fourier orders
+    int nu = mPhases.cols();
+    for (int idim = 0; idim < 3; idim++) 
+        mMotionSPZ.col(idim) = mPhases.cwiseProduct(mInterp.middleRows(idim * nu, nu).transpose())
+            .real().rowwise().sum();
+    // rotate
+    for (int idim = 0; idim < 3; idim++) 
+        mMotion.col(idim) = mMotionSPZ.cwiseProduct(mRotation[idim]).rowwise().sum();
+}
+
@@ -0,0 +1,70 @@
+// StationGroup.h
+// created by agent on 19-Oct-2026
+// stations located in the same element, 
+// whose ground motions are computed together
+
+#pragma once
+
+#include "eigenc.h"
+
+class Station;
+class Element;
+
+class StationGroup {
+public:
+    StationGroup(const Element *element, int interval);
+    
+    // add a station located in my element
+    void addStation(Station *station);
+    
+    // compute and record ground motion of all stations
+    void record(int tstep, Real t);
+    
+    // with decimation
+    // compute ground motion into columns of decimator input
+    void feed(RRowX &input);
+    // record decimated ground motion from columns of decimator output
+    void record(Real t, const RRowX &output);
+    // record ground motion convolved with an additional STF
+    void record(int istf, Real t, const RRowX &output);
+    
+    // first column in decimator rows
+    void setOffset(int offset) {mOffset = offset;};
+    int getNumStations() const {return mStations.size();};
+    
+private:
+    // compute ground motion of all stations
+    void compute();
+    
+
+    // host Element
+    const Element *mElement;
+    
+    // record interval
+    int mInterval;
+    
+    // first column in decimator rows
+    int mOffset = 0;
+    
+    // stations, not owned
+    std::vector<Station *> mStations;
+    
+    // phase table, nrec x (maxNu + 1), including the factor 2 for alpha > 0
+    CMatXX mPhases;
+    
+    // interpolation weights, nPntElem x nrec
+    CMatXX mWeights;
+    
+    // row idim of output rotation of each station, nrec x 3
+    std::array<RMatX3, 3> mRotation;
+    
+    // workspaces, allocated before time loop
+    // stacked Fourier field, (3 * nu) x nPntElem
+    CMatXX mField;
+    // interpolated Fourier field, (3 * nu) x nrec
+    CMatXX mInterp;
+    // ground motion in (s, phi, z) and output components, nrec x 3
+    RMatX3 mMotionSPZ;
+    RMatX3 mMotion;
+};
+
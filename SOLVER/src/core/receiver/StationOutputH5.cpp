@@ -0,0 +1,190 @@
+// StationOutputH5.cpp
+// created by agent on 19-Oct-2026
+// rank-level buffer of station seismograms, 
+// written collectively into a single HDF5 file
+
+#include "StationOutputH5.h"
+#include "XMPI.h"
+#include "hdf5.h"
+#include <stdexcept>
+
+#if defined(H5_HAVE_PARALLEL) && !defined(_SERIAL_BUILD)
+    #define _STATION_PARALLEL_HDF5
+#endif
+
+namespace {
+    void h5check(herr_t retval, const std::string &func) {
+        if (retval < 0) throw std::runtime_error("StationOutputH5 || "
+            "Error in HDF5 function: " + func + ".");
+    }
+    
+    hid_t h5Real() {
+        return sizeof(Real) == sizeof(double) ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+    }
+}
+
+StationOutputH5::StationOutputH5(const std::string &fname, int nStation, int offset, int count, 
+    int ntime, int interval, int bufSize):
+mFileName(fname), mNumStations(nStation), mOffset(offset), mCount(count), 
+mNumTime(ntime), mInterval(interval), mBufferSize(bufSize) {
+    if (mInterval <= 0) mInterval = 1;
+    if (mBufferSize <= 0) mBufferSize = 1;
+    mBufferData.resize(mCount * mBufferSize * 3, 0.);
+    mBufferTime.resize(mBufferSize, 0.);
+}
+
+StationOutputH5::~StationOutputH5() {
+    if (mFid >= 0) H5Fclose(mFid);
+}
+
+void StationOutputH5::create(const std::vector<std::string> &names, const std::vector<double> &coords, 
+    const std::string &components) {
+    if (XMPI::root()) {
+        hid_t fid = H5Fcreate(mFileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        if (fid < 0) throw std::runtime_error("StationOutputH5::create || "
+            "Error creating station output file: ||" + mFileName);
+        
+        // seismograms, preallocated such that every dump is one hyperslab
+        hsize_t dims[3] = {(hsize_t)mNumStations, (hsize_t)mNumTime, 3};
+        hid_t space = H5Screate_simple(3, dims, NULL);
+        hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        h5check(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY), "H5Pset_alloc_time");
+        h5check(H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER), "H5Pset_fill_time");
+        hid_t dset = H5Dcreate(fid, "displacement", h5Real(), space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        h5check(dset, "H5Dcreate");
+        
+        // components
+        hid_t sspace = H5Screate(H5S_SCALAR);
+        hid_t atype = H5Tcopy(H5T_C_S1);
+        h5check(H5Tset_size(atype, components.size() + 1), "H5Tset_size");
+        hid_t aid = H5Acreate(dset, "components", atype, sspace, H5P_DEFAULT, H5P_DEFAULT);
+        h5check(H5Awrite(aid, atype, components.c_str()), "H5Awrite");
+        H5Aclose(aid);
+        H5Tclose(atype);
+        H5Sclose(sspace);
+        H5Dclose(dset);
+        H5Pclose(dcpl);
+        H5Sclose(space);
+        
+        // time
+        hsize_t dimt[1] = {(hsize_t)mNumTime};
+        space = H5Screate_simple(1, dimt, NULL);
+        dset = H5Dcreate(fid, "time", h5Real(), space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        h5check(dset, "H5Dcreate");
+        H5Dclose(dset);
+        H5Sclose(space);
+        
+        // metadata table: NETWORK.NAME and latitude, longitude, depth
+        int len = 1;
+        for (const auto &name: names) len = std::max(len, (int)name.size() + 1);
+        std::vector<char> buf(mNumStations * len, 0);
+        for (int i = 0; i < mNumStations; i++) names[i].copy(&buf[i * len], len - 1);
+        hsize_t dimn[1] = {(hsize_t)mNumStations};
+        space = H5Screate_simple(1, dimn, NULL);
+        hid_t stype = H5Tcopy(H5T_C_S1);
+        h5check(H5Tset_size(stype, len), "H5Tset_size");
+        dset = H5Dcreate(fid, "names", stype, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        h5check(dset, "H5Dcreate");
+        if (mNumStations > 0) h5check(H5Dwrite(dset, stype, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf.data()), "H5Dwrite");
+        H5Dclose(dset);
+        H5Tclose(stype);
+        H5Sclose(space);
+        
+        hsize_t dimc[2] = {(hsize_t)mNumStations, 3};
+        space = H5Screate_simple(2, dimc, NULL);
+        dset = H5Dcreate(fid, "coordinates", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        h5check(dset, "H5Dcreate");
+        if (mNumStations > 0) h5check(H5Dwrite(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, coords.data()), "H5Dwrite");
+        H5Dclose(dset);
+        H5Sclose(space);
+        
+        h5check(H5Fclose(fid), "H5Fclose");
+    }
+    XMPI::barrier();
+    
+    #ifdef _STATION_PARALLEL_HDF5
+        // keep open for collective writes
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        h5check(H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL), "H5Pset_fapl_mpio");
+        mFid = H5Fopen(mFileName.c_str(), H5F_ACC_RDWR, fapl);
+        H5Pclose(fapl);
+        if (mFid < 0) throw std::runtime_error("StationOutputH5::create || "
+            "Error opening station output file: ||" + mFileName);
+    #endif
+}
+
+void StationOutputH5::recordTime(int tstep, Real t) {
+    if (tstep % mInterval != 0) return;
+    mBufferTime[mBufferLoc++] = t;
+    if (mBufferLoc == mBufferSize) dumpBufferToFile();
+}
+
+void StationOutputH5::dumpBufferToFile() {
+    if (mBufferLoc == 0) return;
+    #ifdef _STATION_PARALLEL_HDF5
+        writeBuffer(mFid);
+    #else
+        // serial HDF5, procs take turns
+        for (int iproc = 0; iproc < XMPI::nproc(); iproc++) {
+            if (iproc == XMPI::rank() && (mCount > 0 || XMPI::root())) {
+                hid_t fid = H5Fopen(mFileName.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+                if (fid < 0) throw std::runtime_error("StationOutputH5::dumpBufferToFile || "
+                    "Error opening station output file: ||" + mFileName);
+                writeBuffer(fid);
+                h5check(H5Fclose(fid), "H5Fclose");
+            }
+            XMPI::barrier();
+        }
+    #endif
+    mFileLoc += mBufferLoc;
+    mBufferLoc = 0;
+}
+
+void StationOutputH5::writeBuffer(int64_t fid) const {
+    hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+    #ifdef _STATION_PARALLEL_HDF5
+        h5check(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE), "H5Pset_dxpl_mpio");
+    #endif
+    
+    // seismograms, one hyperslab of my stations
+    hid_t dset = H5Dopen(fid, "displacement", H5P_DEFAULT);
+    hid_t fspace = H5Dget_space(dset);
+    hsize_t dimm[3] = {(hsize_t)std::max(mCount, 1), (hsize_t)mBufferSize, 3};
+    hid_t mspace = H5Screate_simple(3, dimm, NULL);
+    if (mCount > 0) {
+        hsize_t fstart[3] = {(hsize_t)mOffset, (hsize_t)mFileLoc, 0};
+        hsize_t mstart[3] = {0, 0, 0};
+        hsize_t count[3] = {(hsize_t)mCount, (hsize_t)mBufferLoc, 3};
+        h5check(H5Sselect_hyperslab(fspace, H5S_SELECT_SET, fstart, NULL, count, NULL), "H5Sselect_hyperslab");
+        h5check(H5Sselect_hyperslab(mspace, H5S_SELECT_SET, mstart, NULL, count, NULL), "H5Sselect_hyperslab");
+    } else {
+        H5Sselect_none(fspace);
+        H5Sselect_none(mspace);
+    }
+    h5check(H5Dwrite(dset, h5Real(), mspace, fspace, dxpl, mBufferData.data()), "H5Dwrite");
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+    
+    // time, by root
+    dset = H5Dopen(fid, "time", H5P_DEFAULT);
+    fspace = H5Dget_space(dset);
+    hsize_t dimt[1] = {(hsize_t)mBufferSize};
+    mspace = H5Screate_simple(1, dimt, NULL);
+    if (XMPI::root()) {
+        hsize_t fstart[1] = {(hsize_t)mFileLoc};
+        hsize_t mstart[1] = {0};
+        hsize_t count[1] = {(hsize_t)mBufferLoc};
+        h5check(H5Sselect_hyperslab(fspace, H5S_SELECT_SET, fstart, NULL, count, NULL), "H5Sselect_hyperslab");
+        h5check(H5Sselect_hyperslab(mspace, H5S_SELECT_SET, mstart, NULL, count, NULL), "H5Sselect_hyperslab");
+    } else {
+        H5Sselect_none(fspace);
+        H5Sselect_none(mspace);
+    }
+    h5check(H5Dwrite(dset, h5Real(), mspace, fspace, dxpl, mBufferTime.data()), "H5Dwrite");
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+    H5Pclose(dxpl);
+}
+
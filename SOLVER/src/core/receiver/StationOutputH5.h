@@ -0,0 +1,65 @@
+// StationOutputH5.h
+// created by agent on 19-Oct-2026
+// rank-level buffer of station seismograms, 
+// written collectively into a single HDF5 file
+
+#pragma once
+
+#include "eigenc.h"
+#include <string>
+#include <cstdint>
+
+class StationOutputH5 {
+public:
+    // nStation: number of stations in file
+    // offset, count: range of my stations in file
+    // ntime: number of recorded steps
+    StationOutputH5(const std::string &fname, int nStation, int offset, int count, 
+        int ntime, int interval, int bufSize);
+    ~StationOutputH5();
+    
+    // create file, datasets and metadata table, all procs must call
+    // names and coords (nStation x 3, latitude, longitude, depth) 
+    // of all stations in file order
+    void create(const std::vector<std::string> &names, const std::vector<double> &coords, 
+        const std::string &components);
+    
+    // record my i-th station at current step
+    void record(int istation, const RRow3 &u) {
+        Real *buf = &(mBufferData[(istation * mBufferSize + mBufferLoc) * 3]);
+        buf[0] = u(0);
+        buf[1] = u(1);
+        buf[2] = u(2);
+    };
+    
+    // advance after all stations have recorded, all procs must call
+    void recordTime(int tstep, Real t);
+    
+    // dump buffer to file, all procs must call
+    void dumpBufferToFile();
+    
+private:
+    // write buffer in [mFileLoc, mFileLoc + mBufferLoc)
+    void writeBuffer(int64_t fid) const;
+    
+    // file
+    std::string mFileName;
+    int mNumStations;
+    int mOffset;
+    int mCount;
+    int mNumTime;
+    int mInterval;
+    
+    // buffer, count x bufSize x 3
+    int mBufferSize;
+    int mBufferLoc = 0;
+    std::vector<Real> mBufferData;
+    std::vector<Real> mBufferTime;
+    
+    // location of buffer start in file
+    int mFileLoc = 0;
+    
+    // file kept open with parallel HDF5
+    int64_t mFid = -1;
+};
+
@@ -0,0 +1,120 @@
+// ReciprocalDatabase.cpp
+// created by agent on 19-Oct-2026
+// rank-level database of Fourier coefficients of strain on GLL points 
+// in a depth and distance range, see ReciprocalReader for format
+
+#include "ReciprocalDatabase.h"
+#include "Element.h"
+#include "IOThread.h"
+
+ReciprocalDatabase::ReciprocalDatabase(int interval, int bufSize, double tolerance, const std::string &fname):
+mInterval(interval), mTolerance(tolerance), mBufferSize(bufSize), mFileName(fname) {
+    if (mBufferSize <= 0) mBufferSize = 1;
+    mBufferLoc = 0;
+    mFront = 0;
+    mTicket = 0;
+    mTimeFirst = mTimeLast = mDeltaT = 0.;
+}
+
+ReciprocalDatabase::~ReciprocalDatabase() {
+    IOThread::wait(mTicket);
+    if (mFStream.is_open()) mFStream.close();
+    if (mFStreamIndex.is_open()) mFStreamIndex.close();
+}
+
+void ReciprocalDatabase::addElement(const Element *element, const std::vector<double> &xi, 
+    const std::vector<double> &eta, const std::vector<double> &s, const std::vector<double> &z) {
+    int norders = element->getMaxNu() + 1 - (int)(element->getMaxNr() % 2 == 0);
+    int nchannels = nPntElem * 6 * norders * 2;
+    mElements.push_back(element);
+    mXi.push_back(xi);
+    mEta.push_back(eta);
+    mS.push_back(s);
+    mZ.push_back(z);
+    mNumOrders.push_back(norders);
+    mFields.push_back(CMatXX::Zero(6 * (element->getMaxNu() + 1), nPntElem));
+    mBufferData[0].push_back(std::vector<Real>(mBufferSize * nchannels));
+    mBufferData[1].push_back(std::vector<Real>(mBufferSize * nchannels));
+    mCodecs.push_back(TraceCodec(nchannels, sizeof(Real), mTolerance));
+}
+
+void ReciprocalDatabase::open(double srcTheta, double srcPhi, double router, 
+    double rmin, double rmax, double fmin, double fmax) {
+    mFStream.open(mFileName + ".bin", std::fstream::out | std::fstream::binary);
+    if (!mFStream) throw std::runtime_error("ReciprocalDatabase::open || "
+        "Error opening output file: ||" + mFileName + ".bin");
+    mFStreamIndex.open(mFileName + ".idx", std::fstream::out | std::fstream::binary);
+    if (!mFStreamIndex) throw std::runtime_error("ReciprocalDatabase::open || "
+        "Error opening output file: ||" + mFileName + ".idx");
+    
+    // header
+    const char magic[8] = {'A', 'X', 'R', 'E', 'C', 'I', '0', '1'};
+    int32_t ints[4] = {(int32_t)sizeof(Real), (int32_t)mElements.size(), nPntEdge, 0};
+    double doubles[8] = {mTolerance, srcTheta, srcPhi, router, rmin, rmax, fmin, fmax};
+    mFStream.write(magic, 8);
+    mFStream.write((char *)ints, sizeof(ints));
+    mFStream.write((char *)doubles, sizeof(doubles));
+    for (int ielem = 0; ielem < mElements.size(); ielem++) {
+        int32_t norders = mNumOrders[ielem];
+        mFStream.write((char *)&norders, sizeof(int32_t));
+        mFStream.write((char *)mXi[ielem].data(), sizeof(double) * nPntEdge);
+        mFStream.write((char *)mEta[ielem].data(), sizeof(double) * nPntEdge);
+        mFStream.write((char *)mS[ielem].data(), sizeof(double) * nPntElem);
+        mFStream.write((char *)mZ[ielem].data(), sizeof(double) * nPntElem);
+    }
+    mOffsets.resize(mElements.size());
+}
+
+void ReciprocalDatabase::record(int tstep, Real t) {
+    if (tstep % mInterval != 0) return;
+    if (mBufferLoc == 0) mTimeFirst = t;
+    mTimeLast = t;
+    for (int ielem = 0; ielem < mElements.size(); ielem++) {
+        CMatXX &field = mFields[ielem];
+        mElements[ielem]->computeStrainField(field);
+        int nu = field.rows() / 6;
+        int norders = mNumOrders[ielem];
+        int nchannels = nPntElem * 6 * norders * 2;
+        Real *rec = &(mBufferData[mFront][ielem][mBufferLoc * nchannels]);
+        for (int ipnt = 0; ipnt < nPntElem; ipnt++) {
+            for (int icomp = 0; icomp < 6; icomp++) {
+                for (int alpha = 0; alpha < norders; alpha++) {
+                    // including the factor 2 for alpha > 0
+                    Complex coeff = field(icomp * nu + alpha, ipnt);
+                    if (alpha > 0) coeff *= two;
+                    *(rec++) = coeff.real();
+                    *(rec++) = coeff.imag();
+                }
+            }
+        }
+    }
+    // dump and clear buffer
+    if (++mBufferLoc == mBufferSize) {
+        dumpBufferToFile();
+    }
+}
+
+void ReciprocalDatabase::dumpBufferToFile() {
+    if (mBufferLoc == 0) return;
+    // times are uniform, stored as t0 and dt per chunk
+    if (mBufferLoc > 1) mDeltaT = (mTimeLast - mTimeFirst) / (mBufferLoc - 1);
+    // back buffer must be written before it is filled again
+    IOThread::wait(mTicket);
+    int back = mFront;
+    int nsamples = mBufferLoc;
+    double t0 = mTimeFirst;
+    double dt = mDeltaT;
+    mFront = 1 - mFront;
+    mBufferLoc = 0;
+    // one chunk per element, located by offsets in index
+    mTicket = IOThread::submit([this, back, nsamples, t0, dt] {
+        for (int ielem = 0; ielem < mElements.size(); ielem++) {
+            mOffsets[ielem] = mFStream.tellp();
+            mCodecs[ielem].encodeBlock(mBufferData[back][ielem].data(), nsamples, t0, dt, mBytes);
+            mFStream.write((char *) mBytes.data(), mBytes.size());
+        }
+        mFStream.flush();
+        mFStreamIndex.write((char *) mOffsets.data(), sizeof(uint64_t) * mOffsets.size());
+        mFStreamIndex.flush();
+    });
+}
@@ -0,0 +1,83 @@
+// ReciprocalDatabase.h
+// created by agent on 19-Oct-2026
+// rank-level database of Fourier coefficients of strain on GLL points 
+// in a depth and distance range, see ReciprocalReader for format
+
+#pragma once
+
+#include "eigenc.h"
+#include "TraceCodec.h"
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+class Element;
+
+class ReciprocalDatabase {
+public:
+    // fname: path without extension, .bin for data and .idx for chunk offsets
+    // tolerance: of TraceCodec, 0 for lossless
+    ReciprocalDatabase(int interval, int bufSize, double tolerance, const std::string &fname);
+    ~ReciprocalDatabase();
+    
+    // add a solid element, all GLL points stored
+    // xi, eta: reference coordinates of GLL nodes, nPntEdge each
+    // s, z: source-centered coordinates of GLL points, nPntElem each
+    void addElement(const Element *element, const std::vector<double> &xi, const std::vector<double> &eta,
+        const std::vector<double> &s, const std::vector<double> &z);
+    
+    // write header after all elements are added
+    // srcTheta, srcPhi: geocentric location of point force, i.e., the station
+    // rmin, rmax, fmin, fmax: radius range and flattening at its ends
+    void open(double srcTheta, double srcPhi, double router, 
+        double rmin, double rmax, double fmin, double fmax);
+    
+    // compute and record coefficients of all elements
+    void record(int tstep, Real t);
+    void dumpLeft() {dumpBufferToFile();};
+    
+private:
+    void dumpBufferToFile();
+    
+    int mInterval;
+    double mTolerance;
+    
+    // elements, not owned
+    std::vector<const Element *> mElements;
+    std::vector<std::vector<double>> mXi;
+    std::vector<std::vector<double>> mEta;
+    std::vector<std::vector<double>> mS;
+    std::vector<std::vector<double>> mZ;
+    // number of recorded orders, Nyquist excluded for even Nr
+    std::vector<int> mNumOrders;
+    
+    // workspaces, allocated before time loop
+    // stacked Fourier strain of each element, (6 * nu) x nPntElem
+    std::vector<CMatXX> mFields;
+    
+    // buffer size in samples
+    int mBufferSize;
+    // current sample in buffer
+    int mBufferLoc;
+    // double buffer of each element, one filled by the solver and 
+    // the other compressed and written by IOThread
+    // per sample: for each point, for each strain component, for each order: Re, Im
+    std::vector<std::vector<Real>> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
+    // time of first and last sample in front buffer
+    double mTimeFirst;
+    double mTimeLast;
+    double mDeltaT;
+    
+    // used only by IOThread after open
+    std::vector<TraceCodec> mCodecs;
+    std::vector<uint8_t> mBytes;
+    std::vector<uint64_t> mOffsets;
+    
+    // files
+    std::string mFileName;
+    std::fstream mFStream;
+    std::fstream mFStreamIndex;
+};
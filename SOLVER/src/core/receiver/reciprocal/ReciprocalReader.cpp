@@ -0,0 +1,283 @@
+// ReciprocalReader.cpp
+// created by agent on 19-Oct-2026
+// synthesize seismograms at a station for arbitrary moment-tensor sources 
+// from reciprocal databases of point-force runs at that station
+// self-contained (std and TraceCodec only), can be compiled into external tools
+
+#include "ReciprocalReader.h"
+#include "TraceCodec.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+ReciprocalReader::ReciprocalReader(const std::string &directory): mDirectory(directory) {
+    for (int rank = 0; ; rank++) {
+        std::string fname = mDirectory + "/reciprocal_rank" + std::to_string(rank);
+        std::ifstream fs(fname + ".bin", std::ifstream::binary);
+        if (!fs) break;
+        char magic[8];
+        int32_t ints[4];
+        double doubles[8];
+        fs.read(magic, 8);
+        fs.read((char *)ints, sizeof(ints));
+        fs.read((char *)doubles, sizeof(doubles));
+        if (!fs || std::memcmp(magic, "AXRECI01", 8) != 0) throw std::runtime_error("ReciprocalReader::ReciprocalReader || "
+            "Not a reciprocal database file: ||" + fname + ".bin");
+        RankInfo rk;
+        rk.mWordBytes = ints[0];
+        rk.mNumElements = ints[1];
+        mNumPntEdge = ints[2];
+        rk.mTolerance = doubles[0];
+        mSrcTheta = doubles[1];
+        mSrcPhi = doubles[2];
+        mROuter = doubles[3];
+        mRMin = doubles[4];
+        mRMax = doubles[5];
+        mFMin = doubles[6];
+        mFMax = doubles[7];
+        int npnts = mNumPntEdge * mNumPntEdge;
+        for (int ielem = 0; ielem < rk.mNumElements; ielem++) {
+            int32_t norders;
+            fs.read((char *)&norders, sizeof(int32_t));
+            ElementInfo elem;
+            elem.mRank = rank;
+            elem.mIndex = ielem;
+            elem.mNumOrders = norders;
+            elem.mXi.resize(mNumPntEdge);
+            elem.mEta.resize(mNumPntEdge);
+            elem.mS.resize(npnts);
+            elem.mZ.resize(npnts);
+            fs.read((char *)elem.mXi.data(), sizeof(double) * mNumPntEdge);
+            fs.read((char *)elem.mEta.data(), sizeof(double) * mNumPntEdge);
+            fs.read((char *)elem.mS.data(), sizeof(double) * npnts);
+            fs.read((char *)elem.mZ.data(), sizeof(double) * npnts);
+            // bounding box with a margin for curved edges
+            elem.mBox[0] = *std::min_element(elem.mS.begin(), elem.mS.end());
+            elem.mBox[1] = *std::max_element(elem.mS.begin(), elem.mS.end());
+            elem.mBox[2] = *std::min_element(elem.mZ.begin(), elem.mZ.end());
+            elem.mBox[3] = *std::max_element(elem.mZ.begin(), elem.mZ.end());
+            double margin = .1 * std::max(elem.mBox[1] - elem.mBox[0], elem.mBox[3] - elem.mBox[2]);
+            elem.mBox[0] -= margin;
+            elem.mBox[1] += margin;
+            elem.mBox[2] -= margin;
+            elem.mBox[3] += margin;
+            mElements.push_back(elem);
+        }
+        if (!fs) throw std::runtime_error("ReciprocalReader::ReciprocalReader || "
+            "Truncated reciprocal database file: ||" + fname + ".bin");
+        
+        // chunk offsets, complete dumps only
+        std::ifstream fsIndex(fname + ".idx", std::ifstream::binary | std::ifstream::ate);
+        if (!fsIndex) throw std::runtime_error("ReciprocalReader::ReciprocalReader || "
+            "Error opening reciprocal database index: ||" + fname + ".idx");
+        if (rk.mNumElements > 0) {
+            std::size_t ndumps = (std::size_t)fsIndex.tellg() / (sizeof(uint64_t) * rk.mNumElements);
+            rk.mOffsets.resize(ndumps * rk.mNumElements);
+            fsIndex.seekg(0);
+            fsIndex.read((char *)rk.mOffsets.data(), sizeof(uint64_t) * rk.mOffsets.size());
+        }
+        mRanks.push_back(rk);
+    }
+    if (mRanks.size() == 0) throw std::runtime_error("ReciprocalReader::ReciprocalReader || "
+        "No reciprocal database found in directory: ||" + mDirectory);
+}
+
+void ReciprocalReader::extractStrain(double theta, double phi, double r, 
+    std::vector<double> &times, std::vector<double> &strain) const {
+    // locate element
+    double s = r * sin(theta);
+    double z = r * cos(theta);
+    double xi = 0., eta = 0.;
+    const ElementInfo *elem = 0;
+    for (const auto &e: mElements) {
+        if (s < e.mBox[0] || s > e.mBox[1] || z < e.mBox[2] || z > e.mBox[3]) continue;
+        if (invMapping(e, s, z, xi, eta)) {
+            elem = &e;
+            break;
+        }
+    }
+    if (!elem) throw std::runtime_error("ReciprocalReader::extractStrain || "
+        "Location outside database, theta = " + std::to_string(theta) + 
+        ", r = " + std::to_string(r) + ".");
+    std::vector<double> wxi, weta, dw;
+    lagrange(elem->mXi, xi, wxi, dw);
+    lagrange(elem->mEta, eta, weta, dw);
+    
+    // read chunks
+    const RankInfo &rk = mRanks[elem->mRank];
+    int npoints = mNumPntEdge * mNumPntEdge;
+    int norders = elem->mNumOrders;
+    int nchannels = npoints * 6 * norders * 2;
+    std::ifstream fs(mDirectory + "/reciprocal_rank" + std::to_string(elem->mRank) + ".bin", 
+        std::ifstream::binary);
+    if (!fs) throw std::runtime_error("ReciprocalReader::extractStrain || "
+        "Error opening reciprocal database file of rank " + std::to_string(elem->mRank) + ".");
+    TraceCodec codec(nchannels, rk.mWordBytes, rk.mTolerance);
+    std::vector<double> data;
+    times.clear();
+    int ndumps = rk.mNumElements > 0 ? rk.mOffsets.size() / rk.mNumElements : 0;
+    for (int idump = 0; idump < ndumps; idump++) {
+        fs.seekg(rk.mOffsets[idump * rk.mNumElements + elem->mIndex]);
+        codec.decodeBlock(fs, times, data);
+    }
+    
+    // sum orders and interpolate
+    std::vector<double> cosa(norders), sina(norders);
+    for (int alpha = 0; alpha < norders; alpha++) {
+        cosa[alpha] = cos(alpha * phi);
+        sina[alpha] = sin(alpha * phi);
+    }
+    int nsteps = times.size();
+    strain.assign((std::size_t)nsteps * 6, 0.);
+    for (int step = 0; step < nsteps; step++) {
+        const double *c = &data[(std::size_t)step * nchannels];
+        double *e = &strain[(std::size_t)step * 6];
+        for (int ipnt = 0; ipnt < npoints; ipnt++) {
+            double w = wxi[ipnt / mNumPntEdge] * weta[ipnt % mNumPntEdge];
+            for (int icomp = 0; icomp < 6; icomp++) {
+                double sum = 0.;
+                for (int alpha = 0; alpha < norders; alpha++) 
+                    sum += c[2 * alpha] * cosa[alpha] - c[2 * alpha + 1] * sina[alpha];
+                e[icomp] += w * sum;
+                c += 2 * norders;
+            }
+        }
+    }
+}
+
+void ReciprocalReader::extract(double lat, double lon, double depth, const double mrtp[6],
+    std::vector<double> &times, std::vector<double> &u) const {
+    // geographic to geocentric, as in XMath::lat2Theta and XMath::lon2Phi
+    const double pi = 3.141592653589793238463;
+    double r = mROuter - depth;
+    double flattening = mFMin;
+    if (mRMax > mRMin) flattening += (mFMax - mFMin) * (r - mRMin) / (mRMax - mRMin);
+    double lim = 90. - 1e-12;
+    lat = std::max(std::min(lat, lim), -lim);
+    double thetaG = pi / 2. - atan((1. - flattening) * (1. - flattening) * tan(lat * pi / 180.));
+    double phiG = (lon < 0. ? lon + 360. : lon) * pi / 180.;
+    
+    // local basis r, theta, phi in global frame, as in XMath::sphericalBasis
+    double ctG = cos(thetaG), stG = sin(thetaG), cpG = cos(phiG), spG = sin(phiG);
+    double basisG[3][3] = {{stG * cpG, stG * spG, ctG}, {ctG * cpG, ctG * spG, -stG}, {-spG, cpG, 0.}};
+    // to station-centered, transpose of XMath::rotationMatrix
+    double ct = cos(mSrcTheta), st = sin(mSrcTheta), cp = cos(mSrcPhi), sp = sin(mSrcPhi);
+    double Q[3][3] = {{ct * cp, -sp, st * cp}, {ct * sp, cp, st * sp}, {-st, 0., ct}};
+    double basisS[3][3];
+    for (int k = 0; k < 3; k++) 
+        for (int i = 0; i < 3; i++) 
+            basisS[k][i] = Q[0][i] * basisG[k][0] + Q[1][i] * basisG[k][1] + Q[2][i] * basisG[k][2];
+    // the radial basis vector is the location
+    double theta = acos(std::max(std::min(basisS[0][2], 1.), -1.));
+    double phi = atan2(basisS[0][1], basisS[0][0]);
+    if (phi < 0.) phi += 2. * pi;
+    
+    // moment tensor from (r, theta, phi) to (s, phi, z) of station-centered frame
+    double cylinder[3][3] = {{cos(phi), sin(phi), 0.}, {-sin(phi), cos(phi), 0.}, {0., 0., 1.}};
+    double T[3][3];
+    for (int a = 0; a < 3; a++) 
+        for (int k = 0; k < 3; k++) 
+            T[a][k] = cylinder[a][0] * basisS[k][0] + cylinder[a][1] * basisS[k][1] + cylinder[a][2] * basisS[k][2];
+    double M[3][3] = {{mrtp[0], mrtp[3], mrtp[4]}, {mrtp[3], mrtp[1], mrtp[5]}, {mrtp[4], mrtp[5], mrtp[2]}};
+    double Mspz[3][3];
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            Mspz[a][b] = 0.;
+            for (int k = 0; k < 3; k++) 
+                for (int l = 0; l < 3; l++) 
+                    Mspz[a][b] += T[a][k] * M[k][l] * T[b][l];
+        }
+    }
+    
+    // u = M : e, off-diagonal terms twice
+    std::vector<double> strain;
+    extractStrain(theta, phi, r, times, strain);
+    const double weights[6] = {Mspz[0][0], Mspz[1][1], Mspz[2][2], 
+        2. * Mspz[1][2], 2. * Mspz[0][2], 2. * Mspz[0][1]};
+    u.assign(times.size(), 0.);
+    for (int step = 0; step < times.size(); step++) 
+        for (int icomp = 0; icomp < 6; icomp++) 
+            u[step] += weights[icomp] * strain[step * 6 + icomp];
+}
+
+void ReciprocalReader::extractENZ(const ReciprocalReader &south, const ReciprocalReader &east, 
+    const ReciprocalReader &up, double lat, double lon, double depth, const double mrtp[6], 
+    std::vector<double> &times, std::vector<double> &u) {
+    std::vector<double> uS, uE, uZ, timesE, timesZ;
+    south.extract(lat, lon, depth, mrtp, times, uS);
+    east.extract(lat, lon, depth, mrtp, timesE, uE);
+    up.extract(lat, lon, depth, mrtp, timesZ, uZ);
+    if (timesE.size() != times.size() || timesZ.size() != times.size()) 
+        throw std::runtime_error("ReciprocalReader::extractENZ || "
+        "Inconsistent number of time steps in the three databases.");
+    u.resize(times.size() * 3);
+    for (int step = 0; step < times.size(); step++) {
+        u[step * 3] = uE[step];
+        u[step * 3 + 1] = -uS[step];
+        u[step * 3 + 2] = uZ[step];
+    }
+}
+
+bool ReciprocalReader::invMapping(const ElementInfo &elem, double s, double z, double &xi, double &eta) {
+    // Newton on the Lagrange interpolant of (s, z) over GLL points
+    int n = elem.mXi.size();
+    std::vector<double> wxi, dwxi, weta, dweta;
+    xi = eta = 0.;
+    double scale = std::max(elem.mBox[1] - elem.mBox[0], elem.mBox[3] - elem.mBox[2]);
+    bool converged = false;
+    for (int iter = 0; iter < 50; iter++) {
+        lagrange(elem.mXi, xi, wxi, dwxi);
+        lagrange(elem.mEta, eta, weta, dweta);
+        double sz[2] = {0., 0.}, J[2][2] = {{0., 0.}, {0., 0.}};
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                double ps = elem.mS[i * n + j];
+                double pz = elem.mZ[i * n + j];
+                sz[0] += wxi[i] * weta[j] * ps;
+                sz[1] += wxi[i] * weta[j] * pz;
+                J[0][0] += dwxi[i] * weta[j] * ps;
+                J[0][1] += wxi[i] * dweta[j] * ps;
+                J[1][0] += dwxi[i] * weta[j] * pz;
+                J[1][1] += wxi[i] * dweta[j] * pz;
+            }
+        }
+        double rs = s - sz[0];
+        double rz = z - sz[1];
+        if (std::sqrt(rs * rs + rz * rz) < 1e-10 * scale) {
+            converged = true;
+            break;
+        }
+        double det = J[0][0] * J[1][1] - J[0][1] * J[1][0];
+        if (det == 0.) return false;
+        xi += (J[1][1] * rs - J[0][1] * rz) / det;
+        eta += (J[0][0] * rz - J[1][0] * rs) / det;
+        // keep iterates near the element
+        xi = std::max(std::min(xi, 2.), -2.);
+        eta = std::max(std::min(eta, 2.), -2.);
+    }
+    const double tol = 1e-6;
+    if (!converged) return false;
+    if (std::abs(xi) > 1. + tol || std::abs(eta) > 1. + tol) return false;
+    xi = std::max(std::min(xi, 1.), -1.);
+    eta = std::max(std::min(eta, 1.), -1.);
+    return true;
+}
+
+void ReciprocalReader::lagrange(const std::vector<double> &nodes, double x, 
+    std::vector<double> &weights, std::vector<double> &derivs) {
+    int n = nodes.size();
+    weights.assign(n, 1.);
+    derivs.assign(n, 0.);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (j == i) continue;
+            weights[i] *= (x - nodes[j]) / (nodes[i] - nodes[j]);
+            double term = 1. / (nodes[i] - nodes[j]);
+            for (int k = 0; k < n; k++) 
+                if (k != i && k != j) term *= (x - nodes[k]) / (nodes[i] - nodes[k]);
+            derivs[i] += term;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// ReciprocalReader.h
+// created by agent on 19-Oct-2026
+// synthesize seismograms at a station for arbitrary moment-tensor sources 
+// from reciprocal databases of point-force runs at that station
+// self-contained (std and TraceCodec only), can be compiled into external tools
+
+// one pair of files per rank, native byte order:
+//   reciprocal_rank<r>.bin
+//     header: char[8] "AXRECI01", int32 wordBytes, int32 nelem, int32 nPntEdge, int32 0,
+//             double tolerance, double srcTheta, double srcPhi, double router,
+//             double rmin, double rmax, double fmin, double fmax
+//     for each element: int32 norders, double xi[nPntEdge], double eta[nPntEdge],
+//             double s[nPntElem], double z[nPntElem], point index ipol * nPntEdge + jpol
+//     chunks: one TraceCodec block per element per dump, with channels
+//             for each point, for ss, pp, zz, pz, sz, sp, for each order: Re c, Im c
+//   reciprocal_rank<r>.idx
+//     for each dump, for each element: uint64 offset of chunk in .bin
+// strain at a point and azimuth phi (station-centered):
+//   e(phi) = sum_alpha Re(c_alpha * exp(i * alpha * phi))
+// by reciprocity, the displacement at the station along the force f of a run, 
+// excited by a moment tensor M at x, is u = M : e(x) / |f|
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class ReciprocalReader {
+public:
+    // directory: containing reciprocal_rank<r>.bin and .idx, r = 0, 1, ...
+    ReciprocalReader(const std::string &directory);
+    
+    // strain (ss, pp, zz, pz, sz, sp) at station-centered colatitude theta, 
+    // azimuth phi (rad) and radius r (m)
+    // strain: nsteps x 6, row-major
+    void extractStrain(double theta, double phi, double r, 
+        std::vector<double> &times, std::vector<double> &strain) const;
+    
+    // displacement at the station along the force of this run, excited by a 
+    // moment tensor at geographic latitude and longitude (deg) and depth (m)
+    // mrtp: Mrr, Mtt, Mpp, Mrt, Mrp, Mtp (N.m), per unit force of this run
+    // u: nsteps
+    void extract(double lat, double lon, double depth, const double mrtp[6],
+        std::vector<double> &times, std::vector<double> &u) const;
+    
+    // ENZ seismogram at the station, combining three runs with unit forces 
+    // f1 (south), f2 (east) and f3 (up) in the point force file
+    // u: nsteps x 3, row-major
+    static void extractENZ(const ReciprocalReader &south, const ReciprocalReader &east, 
+        const ReciprocalReader &up, double lat, double lon, double depth, const double mrtp[6], 
+        std::vector<double> &times, std::vector<double> &u);
+    
+    int getNumElements() const {return mElements.size();};
+    
+private:
+    struct ElementInfo {
+        int mRank;
+        int mIndex;
+        int mNumOrders;
+        std::vector<double> mXi;
+        std::vector<double> mEta;
+        std::vector<double> mS;
+        std::vector<double> mZ;
+        double mBox[4];
+    };
+    
+    struct RankInfo {
+        int mWordBytes;
+        double mTolerance;
+        int mNumElements;
+        std::vector<uint64_t> mOffsets;
+    };
+    
+    // reference coordinates of (s, z) in an element
+    // RETURN: false if outside
+    static bool invMapping(const ElementInfo &elem, double s, double z, double &xi, double &eta);
+    
+    // Lagrange interpolation weights of nodes at x and their derivatives
+    static void lagrange(const std::vector<double> &nodes, double x, 
+        std::vector<double> &weights, std::vector<double> &derivs);
+    
+    std::string mDirectory;
+    std::vector<ElementInfo> mElements;
+    std::vector<RankInfo> mRanks;
+    int mNumPntEdge;
+    double mSrcTheta;
+    double mSrcPhi;
+    double mROuter;
+    double mRMin, mRMax;
+    double mFMin, mFMax;
+};
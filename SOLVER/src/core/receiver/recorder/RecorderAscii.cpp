@@ -3,11 +3,18 @@
 // ascii seismogram output
 
 #include "RecorderAscii.h"
+#include "IOThread.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 
 RecorderAscii::RecorderAscii(int bufSize, const std::string &fname, bool append):
 mBufferSize(bufSize), mBufferLine(0), mFileName(fname), mAppend(append) {
     if (mBufferSize <= 0) mBufferSize = 1;
-    mBufferData = Eigen::Matrix<Real, Eigen::Dynamic, 4>(mBufferSize, 4);
+    mBufferData[0] = Eigen::Matrix<Real, Eigen::Dynamic, 4>(mBufferSize, 4);
+    mBufferData[1] = Eigen::Matrix<Real, Eigen::Dynamic, 4>(mBufferSize, 4);
+    mFront = 0;
+    mTicket = 0;
 }
 
 void RecorderAscii::open() {
@@ -19,13 +26,14 @@ void RecorderAscii::open() {
 }
 
 void RecorderAscii::close() {
+    IOThread::wait(mTicket);
     if (mFStream.is_open())
         mFStream.close();
 }
 
 void RecorderAscii::record(Real t, const RRow3 &u) {
-    mBufferData(mBufferLine, 0) = t;
-    mBufferData.block(mBufferLine, 1, 1, 3) = u;
+    mBufferData[mFront](mBufferLine, 0) = t;
+    mBufferData[mFront].block(mBufferLine, 1, 1, 3) = u;
     mBufferLine++;
     // dump and clear buffer
     if (mBufferLine == mBufferSize) {
@@ -34,14 +42,37 @@ void RecorderAscii::record(Real t, const RRow3 &u) {
 }
 
 void RecorderAscii::dumpBufferToFile() {
-    // each row starts with a space
-    #ifndef NDEBUG
-        Eigen::internal::set_is_malloc_allowed(true);
-        mFStream << mBufferData.topRows(mBufferLine).format(EIGEN_FMT) << std::endl;   
-        Eigen::internal::set_is_malloc_allowed(false); 
-    #else
-        mFStream << mBufferData.topRows(mBufferLine).format(EIGEN_FMT) << std::endl;  
-    #endif
-    mFStream.flush();
+    if (mBufferLine == 0) return;
+    // back buffer must be written before it is filled again
+    IOThread::wait(mTicket);
+    int back = mFront;
+    int nrows = mBufferLine;
+    mFront = 1 - mFront;
     mBufferLine = 0;
+    mTicket = IOThread::submit([this, back, nrows] {
+        writeRows(back, nrows);
+        mFStream.flush();
+    });
+}
+
+void RecorderAscii::writeRows(int ibuf, int nrows) {
+    const auto &data = mBufferData[ibuf];
+    // aligned columns as in Eigen::IOFormat
+    std::stringstream sstr;
+    sstr.copyfmt(mFStream);
+    std::streamsize width = 0;
+    for (int i = 0; i < nrows; i++) {
+        for (int j = 0; j < 4; j++) {
+            sstr.str("");
+            sstr << data(i, j);
+            width = std::max<std::streamsize>(width, sstr.str().length());
+        }
+    }
+    // each row starts with a space
+    for (int i = 0; i < nrows; i++) {
+        if (i > 0) mFStream << "\n";
+        for (int j = 0; j < 4; j++) 
+            mFStream << " " << std::setw(width) << data(i, j);
+    }
+    mFStream << std::endl;
 }
@@ -6,6 +6,7 @@
 
 #include "Recorder.h"
 #include <fstream>
+#include <cstdint>
 
 class RecorderAscii: public Recorder {
 public: 
@@ -21,8 +22,11 @@ protected:
     int mBufferSize;
     // current line in buffer
     int mBufferLine;
-    // data buffer
-    Eigen::Matrix<Real, Eigen::Dynamic, 4, Eigen::RowMajor> mBufferData;
+    // double buffer, one filled by the solver and the other written by IOThread
+    Eigen::Matrix<Real, Eigen::Dynamic, 4, Eigen::RowMajor> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
     
     // file name
     std::string mFileName;
@@ -31,4 +35,8 @@ protected:
     // file stream
     std::fstream mFStream;
     
+private:
+    // write rows of a buffer in EIGEN_FMT without Eigen temporaries,
+    // as Eigen malloc checks are global and the time loop forbids them
+    void writeRows(int ibuf, int nrows);
 };
@@ -3,13 +3,17 @@
 // ascii seismogram output
 
 #include "RecorderBinary.h"
+#include "IOThread.h"
 
 RecorderBinary::RecorderBinary(int bufSize, const std::string &fname, bool append):
 mBufferSize(bufSize), mFileName(fname), mAppend(append) {
     if (mBufferSize <= 0) mBufferSize = 1;
     mBufferSize = mBufferSize * 4;
-    mBufferData.resize(mBufferSize);
+    mBufferData[0].resize(mBufferSize);
+    mBufferData[1].resize(mBufferSize);
     mBufferLoc = 0;
+    mFront = 0;
+    mTicket = 0;
 }
 
 void RecorderBinary::open() {
@@ -21,15 +25,17 @@ void RecorderBinary::open() {
 }
 
 void RecorderBinary::close() {
+    IOThread::wait(mTicket);
     if (mFStream.is_open())
         mFStream.close();
 }
 
 void RecorderBinary::record(Real t, const RRow3 &u) {
-    mBufferData[mBufferLoc++] = t;
-    mBufferData[mBufferLoc++] = u(0);
-    mBufferData[mBufferLoc++] = u(1);
-    mBufferData[mBufferLoc++] = u(2);
+    std::vector<Real> &buffer = mBufferData[mFront];
+    buffer[mBufferLoc++] = t;
+    buffer[mBufferLoc++] = u(0);
+    buffer[mBufferLoc++] = u(1);
+    buffer[mBufferLoc++] = u(2);
     // dump and clear buffer
     if (mBufferLoc == mBufferSize) {
         dumpBufferToFile();
@@ -37,7 +43,15 @@ void RecorderBinary::record(Real t, const RRow3 &u) {
 }
 
 void RecorderBinary::dumpBufferToFile() {
-    mFStream.write((char *) &(mBufferData[0]), sizeof(Real) * (mBufferLoc));
-    mFStream.flush();
+    if (mBufferLoc == 0) return;
+    // back buffer must be written before it is filled again
+    IOThread::wait(mTicket);
+    int back = mFront;
+    int nwrite = mBufferLoc;
+    mFront = 1 - mFront;
     mBufferLoc = 0;
+    mTicket = IOThread::submit([this, back, nwrite] {
+        mFStream.write((char *) &(mBufferData[back][0]), sizeof(Real) * nwrite);
+        mFStream.flush();
+    });
 }
@@ -7,6 +7,7 @@
 #include "Recorder.h"
 #include <fstream>
 #include <vector>
+#include <cstdint>
 
 class RecorderBinary: public Recorder
 {
@@ -23,8 +24,11 @@ protected:
     int mBufferSize;
     // current position in buffer
     int mBufferLoc;
-    // data buffer
-    std::vector<Real> mBufferData;
+    // double buffer, one filled by the solver and the other written by IOThread
+    std::vector<Real> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
     
     // file name
     std::string mFileName;
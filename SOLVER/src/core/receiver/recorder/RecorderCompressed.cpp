@@ -0,0 +1,67 @@
+// RecorderCompressed.cpp
+// created by agent on 19-Oct-2026
+// compressed seismogram output, see TraceCodec for format
+
+#include "RecorderCompressed.h"
+#include "IOThread.h"
+
+RecorderCompressed::RecorderCompressed(int bufSize, const std::string &fname, bool append, double tolerance):
+mBufferSize(bufSize), mCodec(3, sizeof(Real), tolerance), mFileName(fname), mAppend(append) {
+    if (mBufferSize <= 0) mBufferSize = 1;
+    mBufferData[0].resize(mBufferSize * 3);
+    mBufferData[1].resize(mBufferSize * 3);
+    mBufferLoc = 0;
+    mFront = 0;
+    mTicket = 0;
+    mTimeFirst = mTimeLast = mDeltaT = 0.;
+}
+
+void RecorderCompressed::open() {
+    std::fstream::openmode mode = std::fstream::out | std::fstream::binary;
+    if (mAppend) mode = mode | std::fstream::app;
+    mFStream.open(mFileName, mode);
+    if (!mFStream) throw std::runtime_error("RecorderCompressed::open || "
+        "Error opening output file: ||" + mFileName);
+    // header only for a new file
+    mFStream.seekp(0, std::fstream::end);
+    if (mFStream.tellp() == 0) mCodec.writeHeader(mFStream);
+}
+
+void RecorderCompressed::close() {
+    IOThread::wait(mTicket);
+    if (mFStream.is_open())
+        mFStream.close();
+}
+
+void RecorderCompressed::record(Real t, const RRow3 &u) {
+    std::vector<Real> &buffer = mBufferData[mFront];
+    if (mBufferLoc == 0) mTimeFirst = t;
+    mTimeLast = t;
+    buffer[mBufferLoc * 3] = u(0);
+    buffer[mBufferLoc * 3 + 1] = u(1);
+    buffer[mBufferLoc * 3 + 2] = u(2);
+    // dump and clear buffer
+    if (++mBufferLoc == mBufferSize) {
+        dumpBufferToFile();
+    }
+}
+
+void RecorderCompressed::dumpBufferToFile() {
+    if (mBufferLoc == 0) return;
+    // times are uniform, stored as t0 and dt per block
+    if (mBufferLoc > 1) mDeltaT = (mTimeLast - mTimeFirst) / (mBufferLoc - 1);
+    // back buffer must be written before it is filled again
+    IOThread::wait(mTicket);
+    int back = mFront;
+    int nsamples = mBufferLoc;
+    double t0 = mTimeFirst;
+    double dt = mDeltaT;
+    mFront = 1 - mFront;
+    mBufferLoc = 0;
+    // compression on IOThread
+    mTicket = IOThread::submit([this, back, nsamples, t0, dt] {
+        mCodec.encodeBlock(mBufferData[back].data(), nsamples, t0, dt, mBytes);
+        mFStream.write((char *) mBytes.data(), mBytes.size());
+        mFStream.flush();
+    });
+}
@@ -0,0 +1,52 @@
+// RecorderCompressed.h
+// created by agent on 19-Oct-2026
+// compressed seismogram output, see TraceCodec for format
+
+#pragma once
+
+#include "Recorder.h"
+#include "TraceCodec.h"
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+class RecorderCompressed: public Recorder
+{
+public: 
+    // tolerance = 0: lossless
+    RecorderCompressed(int bufSize, const std::string &fname, bool append, double tolerance);
+    
+    void open();
+    void close();
+    void record(Real t, const RRow3 &u);
+    void dumpBufferToFile();
+
+protected:
+    // buffer size in samples
+    int mBufferSize;
+    // current sample in buffer
+    int mBufferLoc;
+    // double buffer, one filled by the solver and the other 
+    // compressed and written by IOThread
+    std::vector<Real> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
+    
+    // time of first and last sample in front buffer
+    double mTimeFirst;
+    double mTimeLast;
+    // sampling interval, kept for single-sample buffers
+    double mDeltaT;
+    
+    // codec and encoded block, used only by IOThread after open
+    TraceCodec mCodec;
+    std::vector<uint8_t> mBytes;
+    
+    // file name
+    std::string mFileName;
+    // file options
+    bool mAppend;
+    // file stream
+    std::fstream mFStream;
+};
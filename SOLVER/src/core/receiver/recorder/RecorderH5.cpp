@@ -0,0 +1,16 @@
+// RecorderH5.cpp
+// created by agent on 19-Oct-2026
+// station proxy to the rank-level HDF5 station output
+
+#include "RecorderH5.h"
+#include "StationOutputH5.h"
+
+RecorderH5::RecorderH5(StationOutputH5 *output, int index):
+mOutput(output), mIndex(index) {
+    // nothing
+}
+
+void RecorderH5::record(Real t, const RRow3 &u) {
+    mOutput->record(mIndex, u);
+}
+
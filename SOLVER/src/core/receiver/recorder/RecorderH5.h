@@ -0,0 +1,28 @@
+// RecorderH5.h
+// created by agent on 19-Oct-2026
+// station proxy to the rank-level HDF5 station output
+
+#pragma once
+
+#include "Recorder.h"
+
+class StationOutputH5;
+
+class RecorderH5: public Recorder
+{
+public: 
+    RecorderH5(StationOutputH5 *output, int index);
+    
+    // file and buffer are managed by StationOutputH5
+    void open() {};
+    void close() {};
+    void record(Real t, const RRow3 &u);
+    void dumpBufferToFile() {};
+
+protected:
+    // rank-level output
+    StationOutputH5 *mOutput;
+    // index of this station in rank-level buffer
+    int mIndex;
+};
+
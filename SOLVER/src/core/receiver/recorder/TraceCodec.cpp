@@ -0,0 +1,266 @@
+// TraceCodec.cpp
+// created by agent on 19-Oct-2026
+// compressed seismogram format, fixed polynomial prediction and Rice coding
+// self-contained (std only), can be compiled into external readers
+
+#include "TraceCodec.h"
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    const char sMagic[8] = {'A', 'X', 'T', 'R', 'A', 'C', 'E', '1'};
+    // fixed polynomial predictors of order 0 to 3
+    const int sMaxOrder = 3;
+    // quotients from this on are escaped with raw 64 bits
+    const int sMaxUnary = 32;
+    // bytes of block header
+    const int sBlockHeader = 24;
+
+    // residual of fixed predictor, modulo 2^64
+    inline uint64_t residual(const uint64_t *v, int i, int order) {
+        switch (order) {
+            case 0: return v[i];
+            case 1: return v[i] - v[i - 1];
+            case 2: return v[i] - 2 * v[i - 1] + v[i - 2];
+            default: return v[i] - 3 * v[i - 1] + 3 * v[i - 2] - v[i - 3];
+        }
+    }
+
+    // inverse of residual
+    inline uint64_t predict(const uint64_t *v, int i, int order, uint64_t res) {
+        switch (order) {
+            case 0: return res;
+            case 1: return res + v[i - 1];
+            case 2: return res + 2 * v[i - 1] - v[i - 2];
+            default: return res + 3 * v[i - 1] - 3 * v[i - 2] + v[i - 3];
+        }
+    }
+
+    inline uint64_t zigzag(uint64_t r) {
+        return (r << 1) ^ (uint64_t)((int64_t)r >> 63);
+    }
+
+    inline uint64_t unzigzag(uint64_t u) {
+        return (u >> 1) ^ (~(u & 1) + 1);
+    }
+}
+
+TraceCodec::TraceCodec(int nchannels, int wordBytes, double tolerance):
+mNumChannels(nchannels), mWordBytes(wordBytes), mTolerance(tolerance),
+mBitAcc(0), mBitNum(0), mBitPos(0) {
+    if (mWordBytes != 4 && mWordBytes != 8) throw std::runtime_error("TraceCodec::TraceCodec || "
+        "Invalid word size: " + std::to_string(mWordBytes) + ".");
+    // quantized integers must fit in 64 bits
+    if (mTolerance != 0. && (mTolerance < 1e-15 || mTolerance >= .5)) throw std::runtime_error("TraceCodec::TraceCodec || "
+        "Tolerance must be 0 or in [1e-15, 0.5).");
+}
+
+void TraceCodec::writeHeader(std::ostream &os) const {
+    int32_t ints[2] = {mNumChannels, mWordBytes};
+    os.write(sMagic, 8);
+    os.write((const char *)ints, sizeof(ints));
+    os.write((const char *)&mTolerance, sizeof(double));
+}
+
+TraceCodec TraceCodec::readHeader(std::istream &is) {
+    char magic[8];
+    int32_t ints[2];
+    double tolerance;
+    is.read(magic, 8);
+    is.read((char *)ints, sizeof(ints));
+    is.read((char *)&tolerance, sizeof(double));
+    if (!is || std::memcmp(magic, sMagic, 8) != 0) throw std::runtime_error("TraceCodec::readHeader || "
+        "Not a compressed trace stream.");
+    return TraceCodec(ints[0], ints[1], tolerance);
+}
+
+bool TraceCodec::decodeBlock(std::istream &is, std::vector<double> &times, std::vector<double> &data) {
+    char header[sBlockHeader];
+    is.read(header, sBlockHeader);
+    if (is.gcount() == 0) return false;
+    if (!is) throw std::runtime_error("TraceCodec::decodeBlock || Truncated block header.");
+    uint32_t nbytes;
+    int32_t nsamples;
+    double t0, dt;
+    std::memcpy(&nbytes, header, 4);
+    std::memcpy(&nsamples, header + 4, 4);
+    std::memcpy(&t0, header + 8, 8);
+    std::memcpy(&dt, header + 16, 8);
+    mStream.resize(nbytes);
+    is.read((char *)mStream.data(), nbytes);
+    if (!is) throw std::runtime_error("TraceCodec::decodeBlock || Truncated block.");
+    mBitAcc = 0;
+    mBitNum = 0;
+    mBitPos = 0;
+
+    for (int i = 0; i < nsamples; i++) times.push_back(t0 + i * dt);
+    std::size_t base = data.size();
+    data.resize(base + (std::size_t)nsamples * mNumChannels);
+    mInts.resize(nsamples);
+    for (int ic = 0; ic < mNumChannels; ic++) {
+        double quantum;
+        decodeChannel(nsamples, quantum);
+        for (int i = 0; i < nsamples; i++)
+            data[base + (std::size_t)i * mNumChannels + ic] = (mTolerance > 0.) ?
+                mInts[i] * quantum : fromOrdered(mInts[i], mWordBytes);
+    }
+    return true;
+}
+
+void TraceCodec::readFile(const std::string &fname, std::vector<double> &times,
+    std::vector<double> &data, int &nchannels) {
+    std::ifstream fs(fname, std::ifstream::binary);
+    if (!fs) throw std::runtime_error("TraceCodec::readFile || "
+        "Error opening compressed trace file: ||" + fname);
+    TraceCodec codec = readHeader(fs);
+    nchannels = codec.getNumChannels();
+    times.clear();
+    data.clear();
+    while (codec.decodeBlock(fs, times, data));
+}
+
+int64_t TraceCodec::toOrdered(double x) {
+    int64_t s;
+    std::memcpy(&s, &x, 8);
+    // sign-magnitude to two's complement, -0 maps to -1
+    if (s < 0) s = ~(s & std::numeric_limits<int64_t>::max());
+    return s;
+}
+
+int64_t TraceCodec::toOrdered(float x) {
+    int32_t s;
+    std::memcpy(&s, &x, 4);
+    if (s < 0) s = ~(s & std::numeric_limits<int32_t>::max());
+    return s;
+}
+
+double TraceCodec::fromOrdered(int64_t o, int wordBytes) {
+    if (wordBytes == 4) {
+        int32_t s = (int32_t)o;
+        if (s < 0) s = ~s | std::numeric_limits<int32_t>::min();
+        float x;
+        std::memcpy(&x, &s, 4);
+        return x;
+    }
+    if (o < 0) o = ~o | std::numeric_limits<int64_t>::min();
+    double x;
+    std::memcpy(&x, &o, 8);
+    return x;
+}
+
+void TraceCodec::encodeChannel(int nsamples, double quantum) {
+    if (mTolerance > 0.) {
+        uint64_t bits;
+        std::memcpy(&bits, &quantum, 8);
+        putBits(bits, 64);
+    }
+
+    // predictor with least sum of residual magnitudes
+    const uint64_t *v = (const uint64_t *)mInts.data();
+    int maxOrder = std::min(sMaxOrder, nsamples);
+    int order = 0;
+    double minCost = std::numeric_limits<double>::max();
+    for (int p = 0; p <= maxOrder; p++) {
+        double cost = 0.;
+        for (int i = p; i < nsamples; i++) cost += (double)zigzag(residual(v, i, p));
+        if (cost < minCost) {
+            minCost = cost;
+            order = p;
+        }
+    }
+    mResidual.resize(nsamples);
+    for (int i = order; i < nsamples; i++) mResidual[i] = zigzag(residual(v, i, order));
+
+    // rice parameter with least bits
+    int k = 0;
+    double minBits = std::numeric_limits<double>::max();
+    for (int kk = 0; kk < 64; kk++) {
+        double bits = 0.;
+        for (int i = order; i < nsamples; i++) {
+            uint64_t q = mResidual[i] >> kk;
+            bits += (q < sMaxUnary) ? (double)q + 1. + kk : sMaxUnary + 64.;
+        }
+        if (bits < minBits) {
+            minBits = bits;
+            k = kk;
+        }
+    }
+
+    putBits(order, 2);
+    putBits(k, 6);
+    for (int i = 0; i < order; i++) putBits(v[i], 64);
+    for (int i = order; i < nsamples; i++) {
+        uint64_t q = mResidual[i] >> k;
+        if (q < sMaxUnary) {
+            putBits((1ULL << q) - 1, q);
+            putBits(0, 1);
+            putBits(mResidual[i], k);
+        } else {
+            putBits((1ULL << sMaxUnary) - 1, sMaxUnary);
+            putBits(mResidual[i], 64);
+        }
+    }
+}
+
+void TraceCodec::decodeChannel(int nsamples, double &quantum) {
+    quantum = 0.;
+    if (mTolerance > 0.) {
+        uint64_t bits = getBits(64);
+        std::memcpy(&quantum, &bits, 8);
+    }
+
+    uint64_t *v = (uint64_t *)mInts.data();
+    int order = (int)getBits(2);
+    int k = (int)getBits(6);
+    if (order > nsamples) throw std::runtime_error("TraceCodec::decodeChannel || Corrupted block.");
+    for (int i = 0; i < order; i++) v[i] = getBits(64);
+    for (int i = order; i < nsamples; i++) {
+        int q = 0;
+        while (q < sMaxUnary && getBits(1)) q++;
+        uint64_t u = (q < sMaxUnary) ? ((uint64_t)q << k) | getBits(k) : getBits(64);
+        v[i] = predict(v, i, order, unzigzag(u));
+    }
+}
+
+void TraceCodec::finishBlock(int nsamples, double t0, double dt, std::vector<uint8_t> &bytes) {
+    // pad last byte
+    if (mBitNum > 0) putBits(0, 8 - mBitNum);
+    uint32_t nbytes = mStream.size();
+    int32_t ns = nsamples;
+    bytes.resize(sBlockHeader + nbytes);
+    std::memcpy(&bytes[0], &nbytes, 4);
+    std::memcpy(&bytes[4], &ns, 4);
+    std::memcpy(&bytes[8], &t0, 8);
+    std::memcpy(&bytes[16], &dt, 8);
+    if (nbytes > 0) std::memcpy(&bytes[sBlockHeader], mStream.data(), nbytes);
+}
+
+void TraceCodec::putBits(uint64_t value, int nbits) {
+    if (nbits > 32) {
+        putBits(value >> 32, nbits - 32);
+        value &= 0xffffffffULL;
+        nbits = 32;
+    }
+    // at most 7 pending bits, so 39 bits fit
+    mBitAcc = (mBitAcc << nbits) | (value & ((1ULL << nbits) - 1));
+    mBitNum += nbits;
+    while (mBitNum >= 8) {
+        mBitNum -= 8;
+        mStream.push_back((uint8_t)(mBitAcc >> mBitNum));
+    }
+}
+
+uint64_t TraceCodec::getBits(int nbits) {
+    if (nbits > 32) {
+        uint64_t high = getBits(nbits - 32);
+        return (high << 32) | getBits(32);
+    }
+    while (mBitNum < nbits) {
+        if (mBitPos >= mStream.size()) throw std::runtime_error("TraceCodec::getBits || Corrupted block.");
+        mBitAcc = (mBitAcc << 8) | mStream[mBitPos++];
+        mBitNum += 8;
+    }
+    mBitNum -= nbits;
+    return (mBitAcc >> mBitNum) & ((1ULL << nbits) - 1);
+}
@@ -0,0 +1,105 @@
+// TraceCodec.h
+// created by agent on 19-Oct-2026
+// compressed seismogram format, fixed polynomial prediction and Rice coding
+// self-contained (std only), can be compiled into external readers
+
+// file layout, native byte order:
+//   header: char[8] "AXTRACE1", int32 nchannels, int32 wordBytes, double tolerance
+//   blocks: uint32 nbytes, int32 nsamples, double t0, double dt, bitstream[nbytes]
+// bitstream, for each channel:
+//   quantum (64 bits, lossy only), order (2 bits), rice k (6 bits),
+//   order warm-up values (64 bits each), nsamples - order rice-coded residuals
+// samples are either mapped bijectively to ordered integers (lossless)
+// or quantized to integer multiples of 2 * tolerance * peak (lossy),
+// with peak the maximum amplitude of a channel in a block
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+class TraceCodec {
+public:
+    // tolerance = 0: lossless
+    // wordBytes: 4 or 8, size of floating-point samples
+    TraceCodec(int nchannels, int wordBytes, double tolerance);
+
+    // header
+    void writeHeader(std::ostream &os) const;
+    static TraceCodec readHeader(std::istream &is);
+
+    // encode nsamples x nchannels samples (row-major) at times t0 + i * dt
+    template<typename Type>
+    void encodeBlock(const Type *data, int nsamples, double t0, double dt, std::vector<uint8_t> &bytes);
+
+    // decode next block and append to times and data (row-major)
+    // RETURN: false at end of stream
+    bool decodeBlock(std::istream &is, std::vector<double> &times, std::vector<double> &data);
+
+    // read a whole file
+    static void readFile(const std::string &fname, std::vector<double> &times,
+        std::vector<double> &data, int &nchannels);
+
+    int getNumChannels() const {return mNumChannels;};
+    int getWordBytes() const {return mWordBytes;};
+    double getTolerance() const {return mTolerance;};
+
+    // bijective and monotonic maps between floating-point numbers and integers
+    static int64_t toOrdered(double x);
+    static int64_t toOrdered(float x);
+    static double fromOrdered(int64_t o, int wordBytes);
+
+private:
+    void encodeChannel(int nsamples, double quantum);
+    void decodeChannel(int nsamples, double &quantum);
+    void finishBlock(int nsamples, double t0, double dt, std::vector<uint8_t> &bytes);
+    
+    // bitstream, most significant bit first, nbits <= 64
+    void putBits(uint64_t value, int nbits);
+    uint64_t getBits(int nbits);
+
+    int mNumChannels;
+    int mWordBytes;
+    double mTolerance;
+
+    // workspace, one channel as integers
+    std::vector<int64_t> mInts;
+    // workspace, residuals of one channel
+    std::vector<uint64_t> mResidual;
+    
+    // bitstream of a block
+    std::vector<uint8_t> mStream;
+    uint64_t mBitAcc;
+    int mBitNum;
+    std::size_t mBitPos;
+};
+
+template<typename Type>
+void TraceCodec::encodeBlock(const Type *data, int nsamples, double t0, double dt, std::vector<uint8_t> &bytes) {
+    mInts.resize(nsamples);
+    mStream.clear();
+    mBitAcc = 0;
+    mBitNum = 0;
+    for (int ic = 0; ic < mNumChannels; ic++) {
+        double quantum = 0.;
+        if (mTolerance > 0.) {
+            double peak = 0.;
+            for (int i = 0; i < nsamples; i++)
+                peak = std::max(peak, std::abs((double)data[i * mNumChannels + ic]));
+            quantum = (peak > 0.) ? 2. * mTolerance * peak : 1.;
+            for (int i = 0; i < nsamples; i++)
+                mInts[i] = std::llround(data[i * mNumChannels + ic] / quantum);
+        } else {
+            for (int i = 0; i < nsamples; i++)
+                mInts[i] = toOrdered(data[i * mNumChannels + ic]);
+        }
+        encodeChannel(nsamples, quantum);
+    }
+    finishBlock(nsamples, t0, dt, bytes);
+}
@@ -0,0 +1,92 @@
+// Ring.cpp
+// created by agent on 19-Oct-2026
+// ring receiver at constant (r, theta) in the source-centered frame,
+// recording Fourier coefficients of ground motion in phi for 
+// synthesis at any azimuth, see RingReader for format
+
+#include "Ring.h"
+#include "Seismometer.h"
+#include "Element.h"
+#include "IOThread.h"
+
+Ring::Ring(int interval, Seismometer *seismometer, double theta, double depth, 
+    int bufSize, const std::string &fname):
+mInterval(interval), mSeismometer(seismometer), mElement(seismometer->getElement()), 
+mBufferSize(bufSize), mFileName(fname) {
+    int nu = mElement->getMaxNu() + 1;
+    mNumOrders = mElement->getMaxNu() + 1 - (int)(mElement->getMaxNr() % 2 == 0);
+    mWeights = CColX::Zero(nPntElem);
+    const RMatPP &weights = mSeismometer->getWeights();
+    int ipnt = 0;
+    for (int ipol = 0; ipol <= nPol; ipol++)
+        for (int jpol = 0; jpol <= nPol; jpol++)
+            mWeights(ipnt++) = weights(ipol, jpol);
+    mRotation = mSeismometer->getRotation();
+    mField = CMatXX::Zero(3 * nu, nPntElem);
+    mInterp = CColX::Zero(3 * nu);
+    
+    // buffer
+    if (mBufferSize <= 0) mBufferSize = 1;
+    mRecordSize = 1 + 6 * mNumOrders;
+    mBufferData[0].resize(mBufferSize * mRecordSize);
+    mBufferData[1].resize(mBufferSize * mRecordSize);
+    mBufferLoc = 0;
+    mFront = 0;
+    mTicket = 0;
+    
+    // header
+    mFStream.open(mFileName, std::fstream::out | std::fstream::binary);
+    if (!mFStream) throw std::runtime_error("Ring::Ring || "
+        "Error opening output file: ||" + mFileName);
+    const char magic[8] = {'A', 'X', 'R', 'I', 'N', 'G', '0', '1'};
+    int32_t ints[2] = {(int32_t)sizeof(Real), mNumOrders};
+    mFStream.write(magic, 8);
+    mFStream.write((char *)ints, sizeof(ints));
+    mFStream.write((char *)&theta, sizeof(double));
+    mFStream.write((char *)&depth, sizeof(double));
+}
+
+Ring::~Ring() {
+    IOThread::wait(mTicket);
+    if (mFStream.is_open()) mFStream.close();
+    delete mSeismometer;
+}
+
+void Ring::record(int tstep, Real t) {
+    if (tstep % mInterval != 0) return;
+    // interpolate in (s, z)
+    mElement->computeGroundMotionField(mField);
+    mInterp.noalias() = mField * mWeights;
+    // rotate to RTZ, including the factor 2 for alpha > 0
+    int nu = mInterp.rows() / 3;
+    Real *rec = &(mBufferData[mFront][mBufferLoc * mRecordSize]);
+    *(rec++) = t;
+    for (int idim = 0; idim < 3; idim++) {
+        for (int alpha = 0; alpha < mNumOrders; alpha++) {
+            Complex coeff = mRotation(idim, 0) * mInterp(alpha) 
+                + mRotation(idim, 1) * mInterp(nu + alpha) 
+                + mRotation(idim, 2) * mInterp(2 * nu + alpha);
+            if (alpha > 0) coeff *= two;
+            *(rec++) = coeff.real();
+            *(rec++) = coeff.imag();
+        }
+    }
+    // dump and clear buffer
+    if (++mBufferLoc == mBufferSize) {
+        dumpBufferToFile();
+    }
+}
+
+void Ring::dumpBufferToFile() {
+    if (mBufferLoc == 0) return;
+    // back buffer must be written before it is filled again
+    IOThread::wait(mTicket);
+    int back = mFront;
+    int nwrite = mBufferLoc * mRecordSize;
+    mFront = 1 - mFront;
+    mBufferLoc = 0;
+    mTicket = IOThread::submit([this, back, nwrite] {
+        mFStream.write((char *) &(mBufferData[back][0]), sizeof(Real) * nwrite);
+        mFStream.flush();
+    });
+}
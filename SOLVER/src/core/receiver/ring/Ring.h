@@ -0,0 +1,63 @@
+// Ring.h
+// created by agent on 19-Oct-2026
+// ring receiver at constant (r, theta) in the source-centered frame,
+// recording Fourier coefficients of ground motion in phi for 
+// synthesis at any azimuth, see RingReader for format
+
+#pragma once
+
+#include "eigenc.h"
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+class Seismometer;
+class Element;
+
+class Ring {
+public:
+    // seismometer: provides weights, element and RTZ rotation; azimuth ignored
+    Ring(int interval, Seismometer *seismometer, double theta, double depth, 
+        int bufSize, const std::string &fname);
+    ~Ring();
+    
+    // compute and record Fourier coefficients
+    void record(int tstep, Real t);
+    void dumpLeft() {dumpBufferToFile();};
+    
+private:
+    void dumpBufferToFile();
+    
+    int mInterval;
+    Seismometer *mSeismometer;
+    const Element *mElement;
+    
+    // number of recorded orders, Nyquist excluded for even Nr
+    int mNumOrders;
+    // interpolation weights
+    CColX mWeights;
+    // rotation from (s, phi, z) to RTZ
+    RMat33 mRotation;
+    
+    // workspaces, allocated before time loop
+    // stacked Fourier field, (3 * nu) x nPntElem
+    CMatXX mField;
+    // interpolated Fourier field, 3 * nu
+    CColX mInterp;
+    
+    // buffer size in records
+    int mBufferSize;
+    // current record in buffer
+    int mBufferLoc;
+    // Reals per record, t and 3 x mNumOrders complex
+    int mRecordSize;
+    // double buffer, one filled by the solver and the other written by IOThread
+    std::vector<Real> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
+    
+    // file
+    std::string mFileName;
+    std::fstream mFStream;
+};
@@ -0,0 +1,66 @@
+// RingReader.cpp
+// created by agent on 19-Oct-2026
+// read ring receiver files and synthesize seismograms at any azimuth
+// self-contained (std only), can be compiled into external tools
+
+#include "RingReader.h"
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    template<typename Type>
+    void readRecords(std::ifstream &fs, int recordSize, 
+        std::vector<double> &times, std::vector<double> &coeffs) {
+        std::vector<Type> rec(recordSize);
+        while (fs.read((char *)rec.data(), sizeof(Type) * recordSize)) {
+            times.push_back(rec[0]);
+            coeffs.insert(coeffs.end(), rec.begin() + 1, rec.end());
+        }
+    }
+}
+
+RingReader::RingReader(const std::string &fname) {
+    std::ifstream fs(fname, std::ifstream::binary);
+    if (!fs) throw std::runtime_error("RingReader::RingReader || "
+        "Error opening ring file: ||" + fname);
+    char magic[8];
+    int32_t ints[2];
+    fs.read(magic, 8);
+    fs.read((char *)ints, sizeof(ints));
+    fs.read((char *)&mTheta, sizeof(double));
+    fs.read((char *)&mDepth, sizeof(double));
+    if (!fs || std::memcmp(magic, "AXRING01", 8) != 0) throw std::runtime_error("RingReader::RingReader || "
+        "Not a ring file: ||" + fname);
+    mNumOrders = ints[1];
+    // a partial record at the end, if any, is ignored
+    int recordSize = 1 + 6 * mNumOrders;
+    if (ints[0] == 4) 
+        readRecords<float>(fs, recordSize, mTimes, mCoeffs);
+    else if (ints[0] == 8) 
+        readRecords<double>(fs, recordSize, mTimes, mCoeffs);
+    else 
+        throw std::runtime_error("RingReader::RingReader || "
+            "Invalid word size in ring file: ||" + fname);
+}
+
+void RingReader::synthesize(double phi, std::vector<double> &u) const {
+    std::vector<double> cosa(mNumOrders), sina(mNumOrders);
+    for (int alpha = 0; alpha < mNumOrders; alpha++) {
+        cosa[alpha] = cos(alpha * phi);
+        sina[alpha] = sin(alpha * phi);
+    }
+    int nsteps = getNumSteps();
+    u.assign((std::size_t)nsteps * 3, 0.);
+    for (int step = 0; step < nsteps; step++) {
+        for (int idim = 0; idim < 3; idim++) {
+            const double *c = &mCoeffs[index(step, idim, 0)];
+            double sum = 0.;
+            for (int alpha = 0; alpha < mNumOrders; alpha++) 
+                sum += c[2 * alpha] * cosa[alpha] - c[2 * alpha + 1] * sina[alpha];
+            u[step * 3 + idim] = sum;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+// RingReader.h
+// created by agent on 19-Oct-2026
+// read ring receiver files and synthesize seismograms at any azimuth
+// self-contained (std only), can be compiled into external tools
+
+// file layout, native byte order:
+//   header: char[8] "AXRING01", int32 wordBytes, int32 norders, 
+//           double theta (rad, source-centered), double depth (m)
+//   records: t, then for u_R, u_T, u_Z: for alpha = 0, ..., norders - 1: Re c, Im c
+//   all in floating-point numbers of wordBytes
+// ground motion at azimuth phi (rad, source-centered):
+//   u(phi) = sum_alpha Re(c_alpha * exp(i * alpha * phi))
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class RingReader {
+public:
+    RingReader(const std::string &fname);
+    
+    // synthesize RTZ ground motion at azimuth phi
+    // u: nsteps x 3, row-major
+    void synthesize(double phi, std::vector<double> &u) const;
+    
+    int getNumOrders() const {return mNumOrders;};
+    int getNumSteps() const {return mTimes.size();};
+    double getTheta() const {return mTheta;};
+    double getDepth() const {return mDepth;};
+    const std::vector<double> &getTimes() const {return mTimes;};
+    
+    // coefficient of order alpha and component idim (0, 1, 2 for R, T, Z) at step
+    double getReal(int step, int idim, int alpha) const {
+        return mCoeffs[index(step, idim, alpha)];};
+    double getImag(int step, int idim, int alpha) const {
+        return mCoeffs[index(step, idim, alpha) + 1];};
+    
+private:
+    std::size_t index(int step, int idim, int alpha) const {
+        return ((std::size_t)step * 3 * mNumOrders + idim * mNumOrders + alpha) * 2;};
+    
+    int mNumOrders;
+    double mTheta;
+    double mDepth;
+    std::vector<double> mTimes;
+    // coefficients, nsteps x 3 x norders x 2
+    std::vector<double> mCoeffs;
+};
@@ -4,13 +4,8 @@
 // implement a new sub-class for other trace components 
 
 #include "Seismometer.h"
-#include "Element.h"
 
 Seismometer::Seismometer(Real phi, const RMatPP &weights, Element *element):
 mPhi(phi), mWeights(weights), mElement(element) {
     // nothing
 }
-
-void Seismometer::getGroundMotion(RRow3 &gm) const {
-    mElement->computeGroundMotion(mPhi, mWeights, gm);
-}
@@ -14,7 +14,13 @@ public:
     Seismometer(Real phi, const RMatPP &weights, Element *element);
     virtual ~Seismometer() {};
     
-    virtual void getGroundMotion(RRow3 &gm) const; 
+    // constant rotation from (s, phi, z) to output components
+    virtual RMat33 getRotation() const {return RMat33::Identity();};
+    
+    // get properties
+    Real getPhi() const {return mPhi;};
+    const RMatPP &getWeights() const {return mWeights;};
+    Element *getElement() const {return mElement;};
     
 protected:
     // azimuth
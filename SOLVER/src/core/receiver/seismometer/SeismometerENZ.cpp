@@ -10,18 +10,20 @@ Seismometer(phi, weights, element), mTheta(theta), mBAz(baz) {
     // nothing
 }
 
-void SeismometerENZ::getGroundMotion(RRow3 &gm) const {
-    Seismometer::getGroundMotion(gm);
+RMat33 SeismometerENZ::getRotation() const {
     // first to r, theta, phi
     Real cost = cos(mTheta);
     Real sint = sin(mTheta);
-    Real ur = gm(0) * sint + gm(2) * cost; 
-    Real ut = gm(0) * cost - gm(2) * sint;
-    Real up = gm(1);
+    RMat33 toRTP;
+    toRTP.row(0) << sint, 0., cost;
+    toRTP.row(1) << cost, 0., -sint;
+    toRTP.row(2) << 0., 1., 0.;
     // then to east, north, vertical
     Real cosbaz = cos(mBAz);
     Real sinbaz = sin(mBAz);
-    gm(0) = - ut * sinbaz + up * cosbaz;
-    gm(1) = - ut * cosbaz - up * sinbaz;
-    gm(2) = ur; 
+    RMat33 toENZ;
+    toENZ.row(0) << 0., -sinbaz, cosbaz;
+    toENZ.row(1) << 0., -cosbaz, -sinbaz;
+    toENZ.row(2) << 1., 0., 0.;
+    return toENZ * toRTP;
 }
\ No newline at end of file
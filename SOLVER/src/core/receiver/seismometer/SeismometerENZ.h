@@ -10,7 +10,7 @@ class SeismometerENZ: public Seismometer {
 public:    
     SeismometerENZ(Real phi, const RMatPP &weights, Element *element,
         Real theta, Real baz);
-    void getGroundMotion(RRow3 &gm) const; 
+    RMat33 getRotation() const; 
         
 protected:
     // distance
@@ -9,14 +9,16 @@ Seismometer(phi, weights, element), mTheta(theta) {
     // nothing
 }
 
-void SeismometerRTZ::getGroundMotion(RRow3 &gm) const {
-    Seismometer::getGroundMotion(gm);
+RMat33 SeismometerRTZ::getRotation() const {
     Real cost = cos(mTheta);
     Real sint = sin(mTheta);
-    Real u_s = gm(0);
-    Real u_z = gm(2);
-    gm(0) = u_s * cost - u_z * sint;
-    // gm(1) = u_p, nothing to do
-    gm(2) = u_s * sint + u_z * cost;  
+    RMat33 rot;
+    // u_r = u_s * cost - u_z * sint
+    rot.row(0) << cost, 0., -sint;
+    // u_t = u_p
+    rot.row(1) << 0., 1., 0.;
+    // u_z = u_s * sint + u_z * cost
+    rot.row(2) << sint, 0., cost;
+    return rot;
 }
 
@@ -10,7 +10,7 @@ class SeismometerRTZ: public Seismometer {
 public:    
     SeismometerRTZ(Real phi, const RMatPP &weights, Element *element, Real theta);
 
-    void getGroundMotion(RRow3 &gm) const; 
+    RMat33 getRotation() const; 
         
 protected:
     // distance
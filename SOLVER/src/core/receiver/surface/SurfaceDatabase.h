@@ -0,0 +1,82 @@
+// SurfaceDatabase.h
+// created by agent on 19-Oct-2026
+// rank-level database of Fourier coefficients of displacement on 
+// surface GLL points, see SurfaceReader for format
+
+#pragma once
+
+#include "eigenc.h"
+#include "TraceCodec.h"
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+class Element;
+
+class SurfaceDatabase {
+public:
+    // fname: path without extension, .bin for data and .idx for chunk offsets
+    // tolerance: of TraceCodec, 0 for lossless
+    SurfaceDatabase(int interval, int bufSize, double tolerance, const std::string &fname);
+    ~SurfaceDatabase();
+    
+    // add a surface element
+    // ipnts: indices (ipol * nPntEdge + jpol) of points along the surface edge
+    // xi: reference coordinates of these points along the edge
+    // theta: source-centered colatitudes of these points
+    void addElement(const Element *element, const std::vector<int> &ipnts, 
+        const std::vector<double> &xi, const std::vector<double> &theta);
+    
+    // write header after all elements are added
+    // srcTheta, srcPhi: geocentric source location
+    // flattening: surface flattening, for geographic receivers
+    void open(double srcTheta, double srcPhi, double flattening);
+    
+    // compute and record coefficients of all elements
+    void record(int tstep, Real t);
+    void dumpLeft() {dumpBufferToFile();};
+    
+private:
+    void dumpBufferToFile();
+    
+    int mInterval;
+    double mTolerance;
+    
+    // elements, not owned
+    std::vector<const Element *> mElements;
+    std::vector<std::vector<int>> mPoints;
+    std::vector<std::vector<double>> mXi;
+    std::vector<std::vector<double>> mTheta;
+    // number of recorded orders, Nyquist excluded for even Nr
+    std::vector<int> mNumOrders;
+    
+    // workspaces, allocated before time loop
+    // stacked Fourier field of each element, (3 * nu) x nPntElem
+    std::vector<CMatXX> mFields;
+    
+    // buffer size in samples
+    int mBufferSize;
+    // current sample in buffer
+    int mBufferLoc;
+    // double buffer of each element, one filled by the solver and 
+    // the other compressed and written by IOThread
+    // per sample: for each edge point, for s, phi, z, for each order: Re, Im
+    std::vector<std::vector<Real>> mBufferData[2];
+    int mFront;
+    // ticket of last write
+    uint64_t mTicket;
+    // time of first and last sample in front buffer
+    double mTimeFirst;
+    double mTimeLast;
+    double mDeltaT;
+    
+    // used only by IOThread after open
+    std::vector<TraceCodec> mCodecs;
+    std::vector<uint8_t> mBytes;
+    std::vector<uint64_t> mOffsets;
+    
+    // files
+    std::string mFileName;
+    std::fstream mFStream;
+    std::fstream mFStreamIndex;
+};
@@ -0,0 +1,175 @@
+// SurfaceReader.cpp
+// created by agent on 19-Oct-2026
+// extract seismograms at arbitrary surface locations from a surface database
+// self-contained (std and TraceCodec only), can be compiled into external tools
+
+#include "SurfaceReader.h"
+#include "TraceCodec.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+SurfaceReader::SurfaceReader(const std::string &directory): mDirectory(directory) {
+    for (int rank = 0; ; rank++) {
+        std::string fname = mDirectory + "/surface_rank" + std::to_string(rank);
+        std::ifstream fs(fname + ".bin", std::ifstream::binary);
+        if (!fs) break;
+        char magic[8];
+        int32_t ints[4];
+        double doubles[4];
+        fs.read(magic, 8);
+        fs.read((char *)ints, sizeof(ints));
+        fs.read((char *)doubles, sizeof(doubles));
+        if (!fs || std::memcmp(magic, "AXSURF01", 8) != 0) throw std::runtime_error("SurfaceReader::SurfaceReader || "
+            "Not a surface database file: ||" + fname + ".bin");
+        RankInfo rk;
+        rk.mWordBytes = ints[0];
+        rk.mNumElements = ints[1];
+        rk.mTolerance = doubles[0];
+        mSrcTheta = doubles[1];
+        mSrcPhi = doubles[2];
+        mFlattening = doubles[3];
+        for (int ielem = 0; ielem < rk.mNumElements; ielem++) {
+            int32_t elemInts[2];
+            fs.read((char *)elemInts, sizeof(elemInts));
+            ElementInfo elem;
+            elem.mRank = rank;
+            elem.mIndex = ielem;
+            elem.mNumOrders = elemInts[0];
+            elem.mXi.resize(elemInts[1]);
+            elem.mTheta.resize(elemInts[1]);
+            fs.read((char *)elem.mXi.data(), sizeof(double) * elemInts[1]);
+            fs.read((char *)elem.mTheta.data(), sizeof(double) * elemInts[1]);
+            elem.mThetaMin = *std::min_element(elem.mTheta.begin(), elem.mTheta.end());
+            elem.mThetaMax = *std::max_element(elem.mTheta.begin(), elem.mTheta.end());
+            mElements.push_back(elem);
+        }
+        if (!fs) throw std::runtime_error("SurfaceReader::SurfaceReader || "
+            "Truncated surface database file: ||" + fname + ".bin");
+        
+        // chunk offsets, complete dumps only
+        std::ifstream fsIndex(fname + ".idx", std::ifstream::binary | std::ifstream::ate);
+        if (!fsIndex) throw std::runtime_error("SurfaceReader::SurfaceReader || "
+            "Error opening surface database index: ||" + fname + ".idx");
+        if (rk.mNumElements > 0) {
+            std::size_t ndumps = (std::size_t)fsIndex.tellg() / (sizeof(uint64_t) * rk.mNumElements);
+            rk.mOffsets.resize(ndumps * rk.mNumElements);
+            fsIndex.seekg(0);
+            fsIndex.read((char *)rk.mOffsets.data(), sizeof(uint64_t) * rk.mOffsets.size());
+        }
+        mRanks.push_back(rk);
+    }
+    if (mRanks.size() == 0) throw std::runtime_error("SurfaceReader::SurfaceReader || "
+        "No surface database found in directory: ||" + mDirectory);
+}
+
+void SurfaceReader::extract(double theta, double phi, 
+    std::vector<double> &times, std::vector<double> &u) const {
+    // locate element
+    const double tol = 1e-9;
+    const ElementInfo *elem = 0;
+    for (const auto &e: mElements) {
+        if (theta >= e.mThetaMin - tol && theta <= e.mThetaMax + tol) {
+            elem = &e;
+            break;
+        }
+    }
+    if (!elem) throw std::runtime_error("SurfaceReader::extract || "
+        "No surface element found at theta = " + std::to_string(theta) + ".");
+    
+    // inverse mapping along the edge by bisection, theta monotonic in xi
+    std::vector<double> weights;
+    auto thetaAt = [elem, &weights](double xi) {
+        lagrange(elem->mXi, xi, weights);
+        double th = 0.;
+        for (int i = 0; i < weights.size(); i++) th += weights[i] * elem->mTheta[i];
+        return th;
+    };
+    double lo = -1., hi = 1.;
+    bool increasing = thetaAt(hi) > thetaAt(lo);
+    for (int iter = 0; iter < 60; iter++) {
+        double mid = .5 * (lo + hi);
+        if ((thetaAt(mid) < theta) == increasing) 
+            lo = mid;
+        else 
+            hi = mid;
+    }
+    lagrange(elem->mXi, .5 * (lo + hi), weights);
+    
+    // read chunks
+    const RankInfo &rk = mRanks[elem->mRank];
+    int npoints = elem->mXi.size();
+    int norders = elem->mNumOrders;
+    int nchannels = npoints * 3 * norders * 2;
+    std::ifstream fs(mDirectory + "/surface_rank" + std::to_string(elem->mRank) + ".bin", 
+        std::ifstream::binary);
+    if (!fs) throw std::runtime_error("SurfaceReader::extract || "
+        "Error opening surface database file of rank " + std::to_string(elem->mRank) + ".");
+    TraceCodec codec(nchannels, rk.mWordBytes, rk.mTolerance);
+    std::vector<double> data;
+    times.clear();
+    int ndumps = rk.mNumElements > 0 ? rk.mOffsets.size() / rk.mNumElements : 0;
+    for (int idump = 0; idump < ndumps; idump++) {
+        fs.seekg(rk.mOffsets[idump * rk.mNumElements + elem->mIndex]);
+        codec.decodeBlock(fs, times, data);
+    }
+    
+    // sum orders and interpolate
+    std::vector<double> cosa(norders), sina(norders);
+    for (int alpha = 0; alpha < norders; alpha++) {
+        cosa[alpha] = cos(alpha * phi);
+        sina[alpha] = sin(alpha * phi);
+    }
+    int nsteps = times.size();
+    u.assign((std::size_t)nsteps * 3, 0.);
+    double cost = cos(theta);
+    double sint = sin(theta);
+    for (int step = 0; step < nsteps; step++) {
+        const double *c = &data[(std::size_t)step * nchannels];
+        double spz[3] = {0., 0., 0.};
+        for (int ipnt = 0; ipnt < npoints; ipnt++) {
+            for (int idim = 0; idim < 3; idim++) {
+                double sum = 0.;
+                for (int alpha = 0; alpha < norders; alpha++) 
+                    sum += c[2 * alpha] * cosa[alpha] - c[2 * alpha + 1] * sina[alpha];
+                spz[idim] += weights[ipnt] * sum;
+                c += 2 * norders;
+            }
+        }
+        // to RTZ, as in SeismometerRTZ
+        u[step * 3] = spz[0] * cost - spz[2] * sint;
+        u[step * 3 + 1] = spz[1];
+        u[step * 3 + 2] = spz[0] * sint + spz[2] * cost;
+    }
+}
+
+void SurfaceReader::extractGeographic(double lat, double lon, 
+    std::vector<double> &times, std::vector<double> &u) const {
+    // geographic to geocentric, as in XMath::lat2Theta and XMath::lon2Phi
+    const double pi = 3.141592653589793238463;
+    double lim = 90. - 1e-12;
+    lat = std::max(std::min(lat, lim), -lim);
+    double thetaG = pi / 2. - atan((1. - mFlattening) * (1. - mFlattening) * tan(lat * pi / 180.));
+    double phiG = (lon < 0. ? lon + 360. : lon) * pi / 180.;
+    double xyzG[3] = {sin(thetaG) * cos(phiG), sin(thetaG) * sin(phiG), cos(thetaG)};
+    // to source-centered, transpose of XMath::rotationMatrix
+    double ct = cos(mSrcTheta), st = sin(mSrcTheta), cp = cos(mSrcPhi), sp = sin(mSrcPhi);
+    double Q[3][3] = {{ct * cp, -sp, st * cp}, {ct * sp, cp, st * sp}, {-st, 0., ct}};
+    double xyzS[3];
+    for (int i = 0; i < 3; i++) 
+        xyzS[i] = Q[0][i] * xyzG[0] + Q[1][i] * xyzG[1] + Q[2][i] * xyzG[2];
+    double theta = acos(std::max(std::min(xyzS[2], 1.), -1.));
+    double phi = atan2(xyzS[1], xyzS[0]);
+    if (phi < 0.) phi += 2. * pi;
+    extract(theta, phi, times, u);
+}
+
+void SurfaceReader::lagrange(const std::vector<double> &nodes, double x, std::vector<double> &weights) {
+    int n = nodes.size();
+    weights.assign(n, 1.);
+    for (int i = 0; i < n; i++) 
+        for (int j = 0; j < n; j++) 
+            if (j != i) weights[i] *= (x - nodes[j]) / (nodes[i] - nodes[j]);
+}
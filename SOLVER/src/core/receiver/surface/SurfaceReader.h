@@ -0,0 +1,67 @@
+// SurfaceReader.h
+// created by agent on 19-Oct-2026
+// extract seismograms at arbitrary surface locations from a surface database
+// self-contained (std and TraceCodec only), can be compiled into external tools
+
+// one pair of files per rank, native byte order:
+//   surface_rank<r>.bin
+//     header: char[8] "AXSURF01", int32 wordBytes, int32 nelem, int32 nPntEdge, int32 0,
+//             double tolerance, double srcTheta, double srcPhi, double flattening
+//     for each element: int32 norders, int32 npoints, double xi[npoints], double theta[npoints]
+//     chunks: one TraceCodec block per element per dump, with channels
+//             for each point, for s, phi, z, for each order: Re c, Im c
+//   surface_rank<r>.idx
+//     for each dump, for each element: uint64 offset of chunk in .bin
+// ground motion at a point and azimuth phi (source-centered):
+//   u(phi) = sum_alpha Re(c_alpha * exp(i * alpha * phi))
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class SurfaceReader {
+public:
+    // directory: containing surface_rank<r>.bin and .idx, r = 0, 1, ...
+    SurfaceReader(const std::string &directory);
+    
+    // RTZ seismogram at source-centered colatitude theta and azimuth phi (rad)
+    // u: nsteps x 3, row-major
+    void extract(double theta, double phi, 
+        std::vector<double> &times, std::vector<double> &u) const;
+    
+    // RTZ seismogram at geographic latitude and longitude (deg)
+    void extractGeographic(double lat, double lon, 
+        std::vector<double> &times, std::vector<double> &u) const;
+    
+    int getNumElements() const {return mElements.size();};
+    
+private:
+    struct ElementInfo {
+        int mRank;
+        int mIndex;
+        int mNumOrders;
+        std::vector<double> mXi;
+        std::vector<double> mTheta;
+        double mThetaMin;
+        double mThetaMax;
+    };
+    
+    struct RankInfo {
+        int mWordBytes;
+        double mTolerance;
+        int mNumElements;
+        std::vector<uint64_t> mOffsets;
+    };
+    
+    // Lagrange interpolation weights of nodes at x
+    static void lagrange(const std::vector<double> &nodes, double x, std::vector<double> &weights);
+    
+    std::string mDirectory;
+    std::vector<ElementInfo> mElements;
+    std::vector<RankInfo> mRanks;
+    double mSrcTheta;
+    double mSrcPhi;
+    double mFlattening;
+};
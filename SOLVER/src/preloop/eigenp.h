@@ -19,6 +19,7 @@ typedef Eigen::Matrix<double, 1, 4> RDRow4;
 typedef Eigen::Matrix<double, 3, 3> RDMat33;
 typedef Eigen::Matrix<double, 3, 1> RDCol3;
 typedef Eigen::Matrix<double, Eigen::Dynamic, 3> RDMatX3;
+typedef Eigen::Matrix<double, Eigen::Dynamic, 5> RDMatX5;
 
 // elemental fields 
 typedef Eigen::Matrix<double, Eigen::Dynamic, 1> RDColX;
@@ -26,16 +26,30 @@
 #include "H5Reader.h"
 
 
-ExodusModel::ExodusModel(const std::string &fileName): mExodusFileName(fileName) {
+ExodusModel::ExodusModel(const std::string &fileName, bool nodeShared, bool readPerNode): 
+mExodusFileName(fileName), mNodeShared(nodeShared), mReadPerNode(readPerNode) {
     std::vector<std::string> substrs;
     boost::split(substrs, mExodusFileName, boost::is_any_of("/"), boost::token_compress_on);
     mExodusTitle = substrs[substrs.size() - 1];
     boost::trim_if(mExodusTitle, boost::is_any_of("\t "));
 }
 
+ExodusModel::~ExodusModel() {
+    for (void *block: mSharedBlocks) XMPI::freeNodeShared(block);
+}
+
+template<typename Type>
+SharedArray<Type> ExodusModel::allocShared(int size) {
+    void *block = XMPI::allocNodeShared((std::size_t)size * sizeof(Type));
+    mSharedBlocks.push_back(block);
+    return SharedArray<Type>(static_cast<Type *>(block), size);
+}
+
 void ExodusModel::initialize() {
+    XMPI::setupNodeShared(mNodeShared);
+    
     XTimer::begin("Read Exodus", 1);
-    if (XMPI::root()) readRawData();
+    if (mReadPerNode ? XMPI::nodeRoot() : XMPI::root()) readRawData();
     XTimer::end("Read Exodus", 1);
     
     XTimer::begin("Bcast Exodus", 1);
@@ -144,31 +158,31 @@ void ExodusModel::bcastRawData() {
     XMPI::bcast(mRawLenGlbRec);
     XMPI::bcast_alloc(mRawGlbRec, mRawNumGlbRec * mRawLenGlbRec);
     
-    /////////// connectivity
-    XMPI::bcast_alloc(mRawConnect, mNumQuads * 4);
-    
-    /////////// coords
-    XMPI::bcast_alloc(mRawNodalS, mNumNodes);
-    XMPI::bcast_alloc(mRawNodalZ, mNumNodes);
-    
-    /////////// elemental
+    /////////// elemental names
     XMPI::bcast(mRawNumEleVar);
     XMPI::bcast(mRawLenEleVarName);
     XMPI::bcast_alloc(mRawEleVarName, mRawNumEleVar * mRawLenEleVarName);
-    if (!XMPI::root()) {
-        mRawEleVarVals = new double * [mRawNumEleVar];
-        mRawEleVarVals[0] = new double[mRawNumEleVar * mNumQuads];
-        for (int i = 1; i < mRawNumEleVar; i++) mRawEleVarVals[i] = mRawEleVarVals[0] + i * mNumQuads;
-    }
-    XMPI::bcast(mRawEleVarVals[0], mRawNumEleVar * mNumQuads);
     
-    /////////// side sets
+    /////////// side set names
     XMPI::bcast(mRawNumSS);
     XMPI::bcast(mRawLenSSName);
     XMPI::bcast(mRawMaxPair);
     XMPI::bcast_alloc(mRawNameSS, mRawNumSS * mRawLenSSName);
     XMPI::bcast_alloc(mRawNumPairsSS, mRawNumSS);
+    
+    /////////// ellipticity
+    XMPI::bcast(mRawEllipCol);
+    XMPI::bcast_alloc(mRawEllipData, mRawEllipCol * 2);
+    
+    /////////// bulk data, only needed by node roots to form shared arrays
+    if (!XMPI::nodeRoot() || mReadPerNode) return;
     if (!XMPI::root()) {
+        mRawConnect = new int[mNumQuads * 4];
+        mRawNodalS = new double[mNumNodes];
+        mRawNodalZ = new double[mNumNodes];
+        mRawEleVarVals = new double * [mRawNumEleVar];
+        mRawEleVarVals[0] = new double[mRawNumEleVar * mNumQuads];
+        for (int i = 1; i < mRawNumEleVar; i++) mRawEleVarVals[i] = mRawEleVarVals[0] + i * mNumQuads;
         mRawElemSS = new int * [mRawNumSS];
         mRawSideSS = new int * [mRawNumSS];
         mRawElemSS[0] = new int[mRawNumSS * mRawMaxPair];
@@ -178,12 +192,12 @@ void ExodusModel::bcastRawData() {
             mRawSideSS[i] = mRawSideSS[0] + i * mRawMaxPair;
         }
     }
-    XMPI::bcast(mRawElemSS[0], mRawNumSS * mRawMaxPair);
-    XMPI::bcast(mRawSideSS[0], mRawNumSS * mRawMaxPair);
-    
-    /////////// ellipticity
-    XMPI::bcast(mRawEllipCol);
-    XMPI::bcast_alloc(mRawEllipData, mRawEllipCol * 2);
+    XMPI::bcastNodeRoots(mRawConnect, mNumQuads * 4);
+    XMPI::bcastNodeRoots(mRawNodalS, mNumNodes);
+    XMPI::bcastNodeRoots(mRawNodalZ, mNumNodes);
+    XMPI::bcastNodeRoots(mRawEleVarVals[0], mRawNumEleVar * mNumQuads);
+    XMPI::bcastNodeRoots(mRawElemSS[0], mRawNumSS * mRawMaxPair);
+    XMPI::bcastNodeRoots(mRawSideSS[0], mRawNumSS * mRawMaxPair);
 }
 
 void ExodusModel::formStructured() {
@@ -219,66 +233,80 @@ void ExodusModel::formStructured() {
     mSSNameSurface = mCartesian ? "y1" : "r1";
     
     /////////// connectivity
-    mConnectivity.resize(mNumQuads);
-    for (int i = 0; i < mNumQuads; i++) {
-        mConnectivity[i][0] = mRawConnect[i * 4 + 0] - 1;
-        mConnectivity[i][1] = mRawConnect[i * 4 + 1] - 1;
-        mConnectivity[i][2] = mRawConnect[i * 4 + 2] - 1;
-        mConnectivity[i][3] = mRawConnect[i * 4 + 3] - 1;
+    mConnectivity = allocShared<std::array<int, 4>>(mNumQuads);
+    if (XMPI::nodeRoot()) {
+        for (int i = 0; i < mNumQuads; i++) {
+            mConnectivity[i][0] = mRawConnect[i * 4 + 0] - 1;
+            mConnectivity[i][1] = mRawConnect[i * 4 + 1] - 1;
+            mConnectivity[i][2] = mRawConnect[i * 4 + 2] - 1;
+            mConnectivity[i][3] = mRawConnect[i * 4 + 3] - 1;
+        }
+        delete [] mRawConnect;
     }
-    delete [] mRawConnect;
     
     /////////// coords
-    mNodalS.resize(mNumNodes);
-    mNodalZ.resize(mNumNodes);
-    for (int i = 0; i < mNumNodes; i++) {
-        mNodalS[i] = mRawNodalS[i];
-        mNodalZ[i] = mRawNodalZ[i];
-    }
-    // NOTE: we temporarily treat Cartesian meshes as special cases of spherical meshes
-    //       by means of moving it to the "north pole". The introduced global 
-    //       curvature should be ignorable, or the problem itself is ill-defined
-    //       as a local problem.
-    if (mCartesian) {
-        double R_EARTH = mGlobalVariables.at("radius");
-        double maxz = -1.;
-        for (int i = 0; i < mNumNodes; i++) 
-            maxz = std::max(maxz, mNodalZ[i]);
-        for (int i = 0; i < mNumNodes; i++) 
-            mNodalZ[i] += R_EARTH - maxz;
+    mNodalS = allocShared<double>(mNumNodes);
+    mNodalZ = allocShared<double>(mNumNodes);
+    if (XMPI::nodeRoot()) {
+        for (int i = 0; i < mNumNodes; i++) {
+            mNodalS[i] = mRawNodalS[i];
+            mNodalZ[i] = mRawNodalZ[i];
+        }
+        // NOTE: we temporarily treat Cartesian meshes as special cases of spherical meshes
+        //       by means of moving it to the "north pole". The introduced global 
+        //       curvature should be ignorable, or the problem itself is ill-defined
+        //       as a local problem.
+        if (mCartesian) {
+            double R_EARTH = mGlobalVariables.at("radius");
+            double maxz = -1.;
+            for (int i = 0; i < mNumNodes; i++) 
+                maxz = std::max(maxz, mNodalZ[i]);
+            for (int i = 0; i < mNumNodes; i++) 
+                mNodalZ[i] += R_EARTH - maxz;
+        }
+        delete [] mRawNodalS;
+        delete [] mRawNodalZ;
     }
-    delete [] mRawNodalS;
-    delete [] mRawNodalZ;
     
     /////////// elemental
     all = std::string(mRawEleVarName);
+    SharedArray<double> eleVarVals = allocShared<double>(mRawNumEleVar * mNumQuads);
     for (int i = 0; i < mRawNumEleVar; i++) {
         std::string varName = all.substr(i * mRawLenEleVarName, mRawLenEleVarName);
         boost::trim_if(varName, boost::is_any_of("\t "));
-        std::vector<double> buffer(mNumQuads);
-        for (int j = 0; j < mNumQuads; j++) buffer[j] = mRawEleVarVals[i][j];
-        mElementalVariables.insert(std::pair<std::string, std::vector<double>>
-                    (std::string(varName), buffer));
+        SharedArray<double> var(eleVarVals.data() + i * mNumQuads, mNumQuads);
+        if (XMPI::nodeRoot()) 
+            for (int j = 0; j < mNumQuads; j++) var[j] = mRawEleVarVals[i][j];
+        mElementalVariables.insert(std::pair<std::string, SharedArray<double>>
+                    (std::string(varName), var));
     }
     delete [] mRawEleVarName;
-    delete [] mRawEleVarVals[0];
-    delete [] mRawEleVarVals;
+    if (XMPI::nodeRoot()) {
+        delete [] mRawEleVarVals[0];
+        delete [] mRawEleVarVals;
+    }
     
     /////////// side sets 
     all = std::string(mRawNameSS);
+    SharedArray<int> sideSets = allocShared<int>(mRawNumSS * mNumQuads);
     for (int i = 0; i < mRawNumSS; i++) {
         std::string varName = all.substr(i * mRawLenSSName, mRawLenSSName);
         boost::trim_if(varName, boost::is_any_of("\t "));
-        std::vector<int> ss(mNumQuads, -1);
-        for (int j = 0; j < mRawNumPairsSS[i]; j++) ss[mRawElemSS[i][j] - 1] = mRawSideSS[i][j] - 1;
-        mSideSets.insert(std::pair<std::string, std::vector<int>>(std::string(varName), ss));
+        SharedArray<int> ss(sideSets.data() + i * mNumQuads, mNumQuads);
+        if (XMPI::nodeRoot()) {
+            for (int j = 0; j < mNumQuads; j++) ss[j] = -1;
+            for (int j = 0; j < mRawNumPairsSS[i]; j++) ss[mRawElemSS[i][j] - 1] = mRawSideSS[i][j] - 1;
+        }
+        mSideSets.insert(std::pair<std::string, SharedArray<int>>(std::string(varName), ss));
     }
     delete [] mRawNameSS;
     delete [] mRawNumPairsSS;
-    delete [] mRawElemSS[0];
-    delete [] mRawSideSS[0];
-    delete [] mRawElemSS;
-    delete [] mRawSideSS;
+    if (XMPI::nodeRoot()) {
+        delete [] mRawElemSS[0];
+        delete [] mRawSideSS[0];
+        delete [] mRawElemSS;
+        delete [] mRawSideSS;
+    }
     
     /////////// ellipticity
     for (int i = 0; i < mRawEllipCol; i++) {
@@ -286,6 +314,9 @@ void ExodusModel::formStructured() {
         mEllipCoeffs.push_back(mRawEllipData[i + mRawEllipCol]);
     }
     delete [] mRawEllipData;
+    
+    // shared arrays ready
+    XMPI::barrierNode();
 }
 
 void ExodusModel::finishReading() {
@@ -330,7 +361,7 @@ void ExodusModel::finishReading() {
         refElem[mConnectivity[i][2]].push_back(i);
         refElem[mConnectivity[i][3]].push_back(i);
     }
-    mAveGLLSpacing = std::vector<double>(mNumNodes, 0.);
+    std::vector<double> aveGLLSpacing(mNumNodes, 0.);
     for (int i = 0; i < mNumNodes; i++) {
         if (i % XMPI::nproc() != XMPI::rank()) continue;
         for (int j = 0; j < refElem[i].size(); j++) {
@@ -347,78 +378,88 @@ void ExodusModel::finishReading() {
             double dist1 = sqrt((s1 - s2) * (s1 - s2) + (z1 - z2) * (z1 - z2));
             double dist2 = sqrt((s2 - s3) * (s2 - s3) + (z2 - z3) * (z2 - z3));
             double dist3 = sqrt((s3 - s0) * (s3 - s0) + (z3 - z0) * (z3 - z0));
-            mAveGLLSpacing[i] += (dist0 + dist1 + dist2 + dist3) / 4. / nPol / refElem[i].size();
+            aveGLLSpacing[i] += (dist0 + dist1 + dist2 + dist3) / 4. / nPol / refElem[i].size();
         }
     } 
-    XMPI::sumVector(mAveGLLSpacing);
+    XMPI::sumVector(aveGLLSpacing);
+    mAveGLLSpacing = allocShared<double>(mNumNodes);
+    if (XMPI::nodeRoot()) 
+        std::copy(aveGLLSpacing.begin(), aveGLLSpacing.end(), mAveGLLSpacing.data());
     XTimer::end("Process Exodus GLL-Spacing", 2);
     
     // rotate nodes of axial elements such that side 3 is on axis
     XTimer::begin("Process Exodus Axis", 2);
-    for (int axialQuad = 0; axialQuad < mNumQuads; axialQuad++) {
-        // loop over t0
-        int axialSide = getSideAxis(axialQuad);
-        if (axialSide == 3 || axialSide == -1) continue;
+    // node-shared arrays are modified by node roots only
+    if (XMPI::nodeRoot()) {
+        for (int axialQuad = 0; axialQuad < mNumQuads; axialQuad++) {
+            // loop over t0
+            int axialSide = getSideAxis(axialQuad);
+            if (axialSide == 3 || axialSide == -1) continue;
 
-        // connectivity
-        std::array<int, 4> con = mConnectivity[axialQuad];
-        for (int j = 0; j < 4; j++) 
-            mConnectivity[axialQuad][j] = con[Mapping::period0123(j + axialSide - 3)];
+            // connectivity
+            std::array<int, 4> con = mConnectivity[axialQuad];
+            for (int j = 0; j < 4; j++) 
+                mConnectivity[axialQuad][j] = con[Mapping::period0123(j + axialSide - 3)];
         
         
-        // elemental fields
-        for (auto it = mElementalVariables.begin(); it != mElementalVariables.end(); it++) {
-            std::string vname = it->first;
-            if (vname.substr(vname.length() - 2, 2) == std::string("_0")) {
-                vname = vname.substr(0, vname.length() - 2);
-                std::array<double, 4> v_old;
-                v_old[0] = mElementalVariables.at(vname + "_0")[axialQuad];
-                v_old[1] = mElementalVariables.at(vname + "_1")[axialQuad];
-                v_old[2] = mElementalVariables.at(vname + "_2")[axialQuad];
-                v_old[3] = mElementalVariables.at(vname + "_3")[axialQuad];
-                mElementalVariables.at(vname + "_0")[axialQuad] = v_old[Mapping::period0123(0 + axialSide - 3)];
-                mElementalVariables.at(vname + "_1")[axialQuad] = v_old[Mapping::period0123(1 + axialSide - 3)];
-                mElementalVariables.at(vname + "_2")[axialQuad] = v_old[Mapping::period0123(2 + axialSide - 3)];
-                mElementalVariables.at(vname + "_3")[axialQuad] = v_old[Mapping::period0123(3 + axialSide - 3)];
+            // elemental fields
+            for (auto it = mElementalVariables.begin(); it != mElementalVariables.end(); it++) {
+                std::string vname = it->first;
+                if (vname.substr(vname.length() - 2, 2) == std::string("_0")) {
+                    vname = vname.substr(0, vname.length() - 2);
+                    std::array<double, 4> v_old;
+                    v_old[0] = mElementalVariables.at(vname + "_0")[axialQuad];
+                    v_old[1] = mElementalVariables.at(vname + "_1")[axialQuad];
+                    v_old[2] = mElementalVariables.at(vname + "_2")[axialQuad];
+                    v_old[3] = mElementalVariables.at(vname + "_3")[axialQuad];
+                    mElementalVariables.at(vname + "_0")[axialQuad] = v_old[Mapping::period0123(0 + axialSide - 3)];
+                    mElementalVariables.at(vname + "_1")[axialQuad] = v_old[Mapping::period0123(1 + axialSide - 3)];
+                    mElementalVariables.at(vname + "_2")[axialQuad] = v_old[Mapping::period0123(2 + axialSide - 3)];
+                    mElementalVariables.at(vname + "_3")[axialQuad] = v_old[Mapping::period0123(3 + axialSide - 3)];
+                }
             }
-        }
         
-        // side sets
-        for (auto it = mSideSets.begin(); it != mSideSets.end(); it++) {
-            if (it->second[axialQuad] != -1) {
-                it->second[axialQuad] = Mapping::period0123(it->second[axialQuad] - axialSide + 3);
+            // side sets
+            for (auto it = mSideSets.begin(); it != mSideSets.end(); it++) {
+                if (it->second[axialQuad] != -1) {
+                    it->second[axialQuad] = Mapping::period0123(it->second[axialQuad] - axialSide + 3);
+                } 
             } 
-        } 
         
-        // done
-        // mSideSets.at(mSSNameAxis)[axialQuad] = 3;
+            // done
+            // mSideSets.at(mSSNameAxis)[axialQuad] = 3;
+        }
     }
     XTimer::end("Process Exodus Axis", 2);
     
     // find elements that are not axial but neighboring axial elements
     XTimer::begin("Process Exodus Vicinal", 2);
-    std::array<int, 4> data = {-1, -1, -1, -1};
-    mVicinalAxis = std::vector<std::array<int, 4>>(mNumQuads, data);
-    // first find near-axis nodes and axial quads
-    std::vector<bool> nodeNearAxis(mNumNodes, false);
-    std::vector<bool> quadOnAxis(mNumQuads, false);
-    for (int axialQuad = 0; axialQuad < mNumQuads; axialQuad++) {
-        int axialSide = getSideAxis(axialQuad);
-        if (axialSide == -1) continue;
-        nodeNearAxis[mConnectivity[axialQuad][0]] = true;
-        nodeNearAxis[mConnectivity[axialQuad][1]] = true;
-        nodeNearAxis[mConnectivity[axialQuad][2]] = true;
-        nodeNearAxis[mConnectivity[axialQuad][3]] = true;
-        quadOnAxis[axialQuad] = true;
-    }
-    // loop over quads
-    for (int iquad = 0; iquad < mNumQuads; iquad++) {
-        if (quadOnAxis[iquad]) continue;
-        for (int j = 0; j < 4; j++) {
-            int nTag = mConnectivity[iquad][j];
-            if (nodeNearAxis[nTag]) mVicinalAxis[iquad][j] = j;
+    mVicinalAxis = allocShared<std::array<int, 4>>(mNumQuads);
+    if (XMPI::nodeRoot()) {
+        std::array<int, 4> data = {-1, -1, -1, -1};
+        for (int iquad = 0; iquad < mNumQuads; iquad++) mVicinalAxis[iquad] = data;
+        // first find near-axis nodes and axial quads
+        std::vector<bool> nodeNearAxis(mNumNodes, false);
+        std::vector<bool> quadOnAxis(mNumQuads, false);
+        for (int axialQuad = 0; axialQuad < mNumQuads; axialQuad++) {
+            int axialSide = getSideAxis(axialQuad);
+            if (axialSide == -1) continue;
+            nodeNearAxis[mConnectivity[axialQuad][0]] = true;
+            nodeNearAxis[mConnectivity[axialQuad][1]] = true;
+            nodeNearAxis[mConnectivity[axialQuad][2]] = true;
+            nodeNearAxis[mConnectivity[axialQuad][3]] = true;
+            quadOnAxis[axialQuad] = true;
+        }
+        // loop over quads
+        for (int iquad = 0; iquad < mNumQuads; iquad++) {
+            if (quadOnAxis[iquad]) continue;
+            for (int j = 0; j < 4; j++) {
+                int nTag = mConnectivity[iquad][j];
+                if (nodeNearAxis[nTag]) mVicinalAxis[iquad][j] = j;
+            }
         }
     }
+    XMPI::barrierNode();
     XTimer::end("Process Exodus Vicinal", 2);
 
     // check if ocean presents in mesh
@@ -508,7 +549,9 @@ void ExodusModel::buildInparam(ExodusModel *&exModel, const Parameters &par,
     if (exModel) delete exModel;
     std::string exfile = par.getValue<std::string>("MODEL_1D_EXODUS_MESH_FILE");
     exfile = Parameters::sInputDirectory + "/" + exfile;
-    exModel = new ExodusModel(exfile);
+    bool nodeShared = par.getValue<bool>("MODEL_1D_EXODUS_NODE_SHARED");
+    bool readPerNode = par.getValue<bool>("MODEL_1D_EXODUS_READ_PER_NODE");
+    exModel = new ExodusModel(exfile, nodeShared, readPerNode);
     exModel->initialize();
     if (verbose) XMPI::cout << exModel->verbose();
     
@@ -11,6 +11,7 @@
 #include <array>
 #include <vector>
 #include <map>
+#include "SharedArray.h"
 
 class Parameters;
 class AttParameters;
@@ -18,7 +19,8 @@ class AttParameters;
 class ExodusModel {
     
 public:
-    ExodusModel(const std::string &fileName);
+    ExodusModel(const std::string &fileName, bool nodeShared, bool readPerNode);
+    ~ExodusModel();
     void initialize();
     
     // general
@@ -28,8 +30,8 @@ public:
     double getDistTolerance() const {return mDistTolerance;};
     double getROuter() const {return mROuter;};
     bool isCartesian() const {return mCartesian;};
-    const std::vector<std::array<int, 4>> &getConnectivity() const {return mConnectivity;};
-    const std::map<std::string, std::vector<double>> &getElementalVariables() const {return mElementalVariables;};
+    const SharedArray<std::array<int, 4>> &getConnectivity() const {return mConnectivity;};
+    const std::map<std::string, SharedArray<double>> &getElementalVariables() const {return mElementalVariables;};
     
     // Node-wise
     double getNodalS(int nodeTag) const {return mNodalS[nodeTag];};
@@ -58,8 +60,16 @@ private:
     void formStructured();
     void finishReading();
     
+    // allocate in node-shared memory
+    template<typename Type>
+    SharedArray<Type> allocShared(int size);
+    
     // file name
     std::string mExodusFileName;
+    
+    // one copy per node, read by node roots
+    bool mNodeShared;
+    bool mReadPerNode;
 
     // file properties
     std::string mExodusTitle;
@@ -108,28 +118,29 @@ private:
     double *mRawEllipData = 0;
     
     ///////////////////////////////////// structured /////////////////////////////////////
+    // large arrays are in node-shared memory, written by node roots only
     // global variables (dt)
     std::map<std::string, double> mGlobalVariables;
     std::map<std::string, std::string> mGlobalRecords;
     
     // connectivity
-    std::vector<std::array<int, 4>> mConnectivity;
-    std::vector<double> mNodalS;
-    std::vector<double> mNodalZ;
+    SharedArray<std::array<int, 4>> mConnectivity;
+    SharedArray<double> mNodalS;
+    SharedArray<double> mNodalZ;
     
     // elemental variables
-    std::map<std::string, std::vector<double>> mElementalVariables;
+    std::map<std::string, SharedArray<double>> mElementalVariables;
     
     // side sets
-    std::map<std::string, std::vector<int>> mSideSets;
+    std::map<std::string, SharedArray<int>> mSideSets;
     
     // others
     double mDistTolerance;
     double mROuter;
     
     // for Nr map
-    std::vector<double> mAveGLLSpacing;
-    std::vector<std::array<int, 4>> mVicinalAxis; 
+    SharedArray<double> mAveGLLSpacing;
+    SharedArray<std::array<int, 4>> mVicinalAxis; 
     
     bool mCartesian = false;
     std::string mSSNameAxis = "t0";
@@ -137,6 +148,9 @@ private:
     
     std::vector<double> mEllipKnots;
     std::vector<double> mEllipCoeffs;
+    
+    // node-shared memory blocks
+    std::vector<void *> mSharedBlocks;
 };
 
 
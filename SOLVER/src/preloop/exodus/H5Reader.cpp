@@ -4,6 +4,7 @@
 
 #include "H5Reader.h"
 #include <stdexcept>
+#include <vector>
 
 // extern "C" {
 #include "hdf5.h"
@@ -82,6 +83,35 @@ void H5Reader::getIntData(int fid, const char *key, int &num, int &len, int *&da
     hdf5Error(H5Dclose(dset_id), "H5Dclose");
 }
 
+bool H5Reader::hasDataset(int fid, const char *key) {
+    return H5Lexists(fid, key, H5P_DEFAULT) > 0;
+}
+
+void H5Reader::getDimensions(int fid, const char *key, int rank, int *dims) {
+    hid_t dset_id = H5Dopen(fid, key, H5P_DEFAULT);
+    hid_t dspace_id = H5Dget_space(dset_id);
+    if (H5Sget_simple_extent_ndims(dspace_id) != rank) throw std::runtime_error("H5Reader::getDimensions || "
+        "Inconsistent rank of dataset: " + std::string(key));
+    std::vector<hsize_t> hdims(rank);
+    hdf5Error(H5Sget_simple_extent_dims(dspace_id, hdims.data(), NULL), "H5Sget_simple_extent_dims");
+    for (int i = 0; i < rank; i++) dims[i] = hdims[i];
+    hdf5Error(H5Sclose(dspace_id), "H5Sclose");
+    hdf5Error(H5Dclose(dset_id), "H5Dclose");
+}
+
+void H5Reader::getDoubleSlab(int fid, const char *key, int rank, const int *start, const int *count, double *data) {
+    hid_t dset_id = H5Dopen(fid, key, H5P_DEFAULT);
+    hid_t dspace_id = H5Dget_space(dset_id);
+    std::vector<hsize_t> hstart(start, start + rank), hcount(count, count + rank);
+    hdf5Error(H5Sselect_hyperslab(dspace_id, H5S_SELECT_SET, hstart.data(), NULL, hcount.data(), NULL), 
+        "H5Sselect_hyperslab");
+    hid_t mspace_id = H5Screate_simple(rank, hcount.data(), NULL);
+    hdf5Error(H5Dread(dset_id, H5T_NATIVE_DOUBLE, mspace_id, dspace_id, H5P_DEFAULT, data), "H5Dread");
+    hdf5Error(H5Sclose(mspace_id), "H5Sclose");
+    hdf5Error(H5Sclose(dspace_id), "H5Sclose");
+    hdf5Error(H5Dclose(dset_id), "H5Dclose");
+}
+
 void H5Reader::hdf5Error(const int retval, const std::string &func_name) {
     if (retval < 0) throw std::runtime_error("H5Reader::hdf5Error || "
         "Error in exodus function: " + func_name);
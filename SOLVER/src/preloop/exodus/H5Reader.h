@@ -13,6 +13,10 @@ public:
     static void getStringData(int fid, const char *key, int &num, int &len, char *&data, bool alloc = true);
     static void getDoubleData(int fid, const char *key, int &row, int &col, double *&data, bool alloc = true);
     static void getIntData(int fid, const char *key, int &row, int &col, int *&data, bool alloc = true);
+    static bool hasDataset(int fid, const char *key);
+    static void getDimensions(int fid, const char *key, int rank, int *dims);
+    // read a hyperslab of a double dataset into row-major data
+    static void getDoubleSlab(int fid, const char *key, int rank, const int *start, const int *count, double *data);
     static void hdf5Error(const int retval, const std::string &func_name);
 };
 
@@ -5,8 +5,8 @@
 #pragma once
 
 #include <eigenp.h>
-typedef Eigen::Matrix<int, 1, 4> IRow4;
-typedef Eigen::Matrix<int, 1, 2> IRow2; // ipol, jpol
+#include <array>
+#include "SharedArray.h"
 
 struct DecomposeOption;
 struct MessagingInfo; 
@@ -15,7 +15,7 @@ class Connectivity {
     
 public:    
     // constructor using exodus connectivity 
-    Connectivity(const std::vector<std::array<int, 4>> &excon);
+    Connectivity(const SharedArray<std::array<int, 4>> &excon);
     
     // constructor of a subset
     Connectivity(const Connectivity &super, const IColX &mask);
@@ -23,8 +23,11 @@ public:
     // size, nelem
     int size() const {return mGlobalQuadID.rows();};
     
-    // domain decomposition
-    void decompose(const DecomposeOption &option, 
+    // partition by metis
+    void partition(const DecomposeOption &option, IColX &elemToProc) const;
+    
+    // domain decomposition with a given partition
+    void decompose(const IColX &elemToProc, 
         int &nlocalGLL, std::vector<IMatPP> &localElemToGLL, 
         MessagingInfo &msg, IColX &procMask) const;
     
@@ -34,15 +37,7 @@ private:
     
 private:
     // form element-to-gll mapping 
-    void formElemToGLL(int &ngll, std::vector<IMatPP> &elemToGLL, std::vector<IColX> &neighbours) const;
-    static void get_shared_DOF_quad(const IRow4 &connectivity1, const IRow4 &connectivity2, 
-        std::vector<IRow2> &map1, std::vector<IRow2> &map2, int ielem);
-    static void common_nodes(const IRow4 &a, const IRow4 &b, 
-        int &ncommon, int &aindex, int &bindex);
-    static void formNodeEdge();
-    static std::array<std::vector<IRow2>, 4> sNodeIJPol;
-    static std::array<std::vector<IRow2>, 4> sEdgeIJPol;
+    void formElemToGLL(int &ngll, std::vector<IMatPP> &elemToGLL) const;
     static bool onEdge(int ipol, int jpol);
 };
 
-
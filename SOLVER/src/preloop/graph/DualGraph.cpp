@@ -9,27 +9,6 @@
 #include <limits>
 #include <numeric>
 
-void DualGraph::formNeighbourhood(const IMatX4 &connectivity, int ncommon, 
-    std::vector<IColX> &neighbours) {
-    // form graph
-    int *xadj, *adjncy;
-    formAdjacency(connectivity, ncommon, xadj, adjncy);
-    
-    // convert CRS format to neighbours
-    int nelem = connectivity.rows();
-    neighbours.clear();
-    neighbours.reserve(nelem);
-    for (int i = 0; i < nelem; i++) {
-        int nNeighb = xadj[i + 1] - xadj[i];
-        IColX neighb(nNeighb);
-        for (int j = 0; j < nNeighb; j++) neighb(j) = adjncy[xadj[i] + j];
-        neighbours.push_back(neighb);
-    }
-
-    // delete graph 
-    freeAdjacency(xadj, adjncy);
-}
-
 void DualGraph::decompose(const IMatX4 &connectivity, const DecomposeOption &option, int nproc, 
     IColX &elemToProc) {
     int nelem = connectivity.rows();    
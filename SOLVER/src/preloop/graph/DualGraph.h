@@ -46,10 +46,6 @@ struct DecomposeOption {
 class DualGraph {
     
 public:    
-    // form neighbourhood of connectivity
-    static void formNeighbourhood(const IMatX4 &connectivity, int ncommon, 
-        std::vector<IColX> &neighbours);
-    
     // domain decomposition
     static void decompose(const IMatX4 &connectivity, const DecomposeOption &option, int nproc, 
         IColX &elemToProc);
@@ -0,0 +1,113 @@
+// PartitionCache.cpp
+// created by agent on 19-Oct-2026
+// cache of element-to-processor partitions and tuned options
+
+#include "PartitionCache.h"
+#include "XMPI.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <unistd.h>
+
+PartitionCache::PartitionCache(const std::string &directory): mDirectory(directory) {
+    resetKey();
+    if (XMPI::root()) XMPI::mkdir(mDirectory);
+}
+
+void PartitionCache::resetKey() {
+    // FNV-1a offset basis
+    mHash = 14695981039346656037ULL;
+}
+
+void PartitionCache::addToKey(const std::string &str) {
+    addToKey(str.data(), str.size());
+}
+
+void PartitionCache::addToKey(const void *data, std::size_t nbytes) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < nbytes; i++) {
+        mHash ^= bytes[i];
+        mHash *= 1099511628211ULL;
+    }
+}
+
+std::string PartitionCache::getKey() const {
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << mHash;
+    return ss.str();
+}
+
+std::string PartitionCache::fileName(const std::string &prefix) const {
+    return mDirectory + "/" + prefix + "_" + getKey() + ".txt";
+}
+
+bool PartitionCache::read(int nelem, IColX &elemToProc) const {
+    int found = 0;
+    if (XMPI::root()) {
+        std::fstream fs(fileName("partition"), std::fstream::in);
+        if (fs) {
+            // header
+            std::string key;
+            int nproc = -1, nelemFile = -1;
+            fs >> key >> nproc >> nelemFile;
+            if (key == getKey() && nproc == XMPI::nproc() && nelemFile == nelem) {
+                elemToProc = IColX::Constant(nelem, -1);
+                int ielem = 0;
+                while (ielem < nelem && fs >> elemToProc(ielem)) ielem++;
+                // a truncated or corrupted file is treated as a miss
+                if (ielem == nelem && elemToProc.minCoeff() >= 0 && elemToProc.maxCoeff() < nproc)
+                    found = 1;
+            }
+            fs.close();
+        }
+    }
+    XMPI::bcast(found);
+    if (found) XMPI::bcastEigen(elemToProc);
+    return found;
+}
+
+void PartitionCache::write(const IColX &elemToProc) const {
+    if (!XMPI::root()) return;
+    // write to a temp file and rename, so that concurrent runs never see a partial file
+    std::string fname = fileName("partition");
+    std::string ftemp = fname + ".tmp" + std::to_string(getpid());
+    std::fstream fs(ftemp, std::fstream::out);
+    if (!fs) throw std::runtime_error("PartitionCache::write || "
+        "Error opening partition cache file: ||" + ftemp);
+    fs << getKey() << " " << XMPI::nproc() << " " << elemToProc.rows() << std::endl;
+    for (int i = 0; i < elemToProc.rows(); i++) fs << elemToProc(i) << std::endl;
+    fs.close();
+    std::rename(ftemp.c_str(), fname.c_str());
+}
+
+bool PartitionCache::readOptions(bool &balanceEP, bool &commVol) const {
+    int found = 0;
+    int options[2];
+    if (XMPI::root()) {
+        std::fstream fs(fileName("options"), std::fstream::in);
+        if (fs) {
+            std::string key;
+            fs >> key >> options[0] >> options[1];
+            if (fs && key == getKey()) found = 1;
+            fs.close();
+        }
+    }
+    XMPI::bcast(found);
+    if (!found) return false;
+    XMPI::bcast(options, 2);
+    balanceEP = options[0];
+    commVol = options[1];
+    return true;
+}
+
+void PartitionCache::writeOptions(bool balanceEP, bool commVol) const {
+    if (!XMPI::root()) return;
+    std::string fname = fileName("options");
+    std::fstream fs(fname, std::fstream::out);
+    if (!fs) throw std::runtime_error("PartitionCache::writeOptions || "
+        "Error opening partition cache file: ||" + fname);
+    fs << getKey() << " " << (int)balanceEP << " " << (int)commVol << std::endl;
+    fs.close();
+}
+
@@ -0,0 +1,43 @@
+// PartitionCache.h
+// created by agent on 19-Oct-2026
+// cache of element-to-processor partitions and tuned options
+
+#pragma once
+
+#include "eigenp.h"
+#include <cstdint>
+
+class PartitionCache {
+public:
+    PartitionCache(const std::string &directory);
+
+    // feed key
+    void addToKey(const std::string &str);
+    void addToKey(const void *data, std::size_t nbytes);
+    template<typename Type>
+    void addToKey(const Type &value) {addToKey(&value, sizeof(Type));};
+
+    // key as hex string
+    std::string getKey() const;
+    
+    // restart key from empty
+    void resetKey();
+
+    // read and write, all procs must call
+    bool read(int nelem, IColX &elemToProc) const;
+    void write(const IColX &elemToProc) const;
+    
+    // tuned decomposition options, all procs must call
+    bool readOptions(bool &balanceEP, bool &commVol) const;
+    void writeOptions(bool balanceEP, bool commVol) const;
+
+private:
+    std::string fileName(const std::string &prefix) const;
+
+    // cache directory
+    std::string mDirectory;
+
+    // 64-bit FNV-1a hash
+    uint64_t mHash;
+};
+
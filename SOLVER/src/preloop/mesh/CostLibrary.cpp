@@ -0,0 +1,236 @@
+// CostLibrary.cpp
+// created by agent on 19-Oct-2026
+// persistent library of measured element and point costs
+// keyed by machine and build, with an analytic fallback
+
+#include "CostLibrary.h"
+#include "XMPI.h"
+#include "global.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <unistd.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+CostLibrary::CostLibrary(const std::string &directory) {
+    // machine key of root and file lines
+    std::vector<std::string> lines;
+    if (XMPI::root()) {
+        XMPI::mkdir(directory);
+        mMachineKey = machineKey();
+        std::stringstream ss;
+        ss << directory << "/costs_" << std::hex << std::hash<std::string>()(mMachineKey) << ".txt";
+        mFileName = ss.str();
+        std::fstream fs(mFileName, std::fstream::in);
+        if (fs) {
+            std::string line;
+            while (getline(fs, line)) lines.push_back(line);
+            fs.close();
+        }
+        // a hash collision or a foreign file is treated as empty
+        if (lines.size() == 0 || lines[0] != "# " + mMachineKey) lines.clear();
+    }
+    XMPI::bcast(mMachineKey);
+    XMPI::bcast(mFileName);
+    XMPI::bcast(lines);
+
+    // parse, format of each row -- E/P signature cost
+    for (int i = 1; i < lines.size(); i++) {
+        std::vector<std::string> strs;
+        std::string line = boost::trim_copy(lines[i]);
+        boost::split(strs, line, boost::is_any_of("\t "), boost::token_compress_on);
+        if (strs.size() != 3) continue;
+        double cost = 0.;
+        try {
+            cost = boost::lexical_cast<double>(strs[2]);
+        } catch (...) {
+            continue;
+        }
+        if (strs[0] == "E") mElementCosts[strs[1]] = cost;
+        if (strs[0] == "P") mPointCosts[strs[1]] = cost;
+    }
+    computeAnalyticScales();
+}
+
+double CostLibrary::getElementCost(const std::string &signature) const {
+    auto it = mElementCosts.find(signature);
+    if (it != mElementCosts.end()) return it->second;
+    return analyticElement(signature) * mScaleElement;
+}
+
+double CostLibrary::getPointCost(const std::string &signature) const {
+    auto it = mPointCosts.find(signature);
+    if (it != mPointCosts.end()) return it->second;
+    return analyticPoint(signature) * mScalePoint;
+}
+
+void CostLibrary::addElementCosts(const std::map<std::string, double> &measured) {
+    for (auto it = measured.begin(); it != measured.end(); it++) {
+        auto res = mElementCosts.insert(*it);
+        if (!res.second) res.first->second = std::min(res.first->second, it->second);
+    }
+    computeAnalyticScales();
+}
+
+void CostLibrary::addPointCosts(const std::map<std::string, double> &measured) {
+    for (auto it = measured.begin(); it != measured.end(); it++) {
+        auto res = mPointCosts.insert(*it);
+        if (!res.second) res.first->second = std::min(res.first->second, it->second);
+    }
+    computeAnalyticScales();
+}
+
+void CostLibrary::write() const {
+    if (!XMPI::root()) return;
+    // write to a temp file and rename, so that concurrent runs never see a partial file
+    std::string ftemp = mFileName + ".tmp" + std::to_string(getpid());
+    std::fstream fs(ftemp, std::fstream::out);
+    if (!fs) throw std::runtime_error("CostLibrary::write || "
+        "Error opening cost library file: ||" + ftemp);
+    fs << "# " << mMachineKey << std::endl;
+    fs << std::scientific << std::setprecision(10);
+    for (auto it = mElementCosts.begin(); it != mElementCosts.end(); it++)
+        fs << "E " << it->first << " " << it->second << std::endl;
+    for (auto it = mPointCosts.begin(); it != mPointCosts.end(); it++)
+        fs << "P " << it->first << " " << it->second << std::endl;
+    fs.close();
+    std::rename(ftemp.c_str(), mFileName.c_str());
+}
+
+std::string CostLibrary::contentSignature() const {
+    std::stringstream ss;
+    ss << std::scientific << std::setprecision(10);
+    for (auto it = mElementCosts.begin(); it != mElementCosts.end(); it++)
+        ss << it->first << "=" << it->second << ";";
+    for (auto it = mPointCosts.begin(); it != mPointCosts.end(); it++)
+        ss << it->first << "=" << it->second << ";";
+    return ss.str();
+}
+
+std::string CostLibrary::machineKey() {
+    // cpu model
+    std::string cpu = "UnknownCPU";
+    std::fstream fs("/proc/cpuinfo", std::fstream::in);
+    if (fs) {
+        std::string line;
+        while (getline(fs, line)) {
+            if (boost::starts_with(line, "model name")) {
+                cpu = boost::trim_copy(line.substr(line.find(':') + 1));
+                break;
+            }
+        }
+        fs.close();
+    }
+
+    // build
+    std::stringstream ss;
+    ss << cpu << "$nPol=" << nPol << "$Real=" << sizeof(Real) * 8 << "bit";
+    #ifdef __VERSION__
+        ss << "$Compiler=" << __VERSION__;
+    #endif
+    #ifdef __OPTIMIZE__
+        ss << "$Optimized";
+    #endif
+    #ifdef __AVX512F__
+        ss << "$AVX512";
+    #elif defined(__AVX2__)
+        ss << "$AVX2";
+    #elif defined(__AVX__)
+        ss << "$AVX";
+    #endif
+    return ss.str();
+}
+
+// relative weights of signature components in the analytic model
+// a rough operation count; only ratios matter once scaled to measurements
+namespace {
+    const std::map<std::string, double> sAnalyticWeights = {
+        // elements
+        {"SolidElement", 1.0},
+        {"FluidElement", .3},
+        {"Isotropic1D", .4},
+        {"TransverselyIsotropic1D", .6},
+        {"Isotropic3D", 1.2},
+        {"TransverselyIsotropic3D", 1.8},
+        {"Isotropic3X", 1.5},
+        {"TransverselyIsotropic3X", 2.2},
+        {"Acoustic1D", .1},
+        {"Acoustic3X", .3},
+        {"Attenuation1D_CG4", .3},
+        {"Attenuation1D_Full", .8},
+        {"Attenuation3D_CG4", .5},
+        {"Attenuation3D_Full", 1.2},
+        // points
+        {"SolidPoint", .3},
+        {"FluidPoint", .1},
+        {"SolidFluidPoint", .1},
+        {"Mass1D", .1},
+        {"Mass3D", .2},
+        {"MassOcean1D", .2},
+        {"MassOcean3D", .4},
+        {"SFCoupling1D", .1},
+        {"SFCoupling3D", .2}
+    };
+
+    // sum of weights and Nr of a signature
+    void parseSignature(const std::string &signature, double &weight, int &nr, bool &axial) {
+        std::vector<std::string> strs;
+        boost::split(strs, signature, boost::is_any_of("$"), boost::token_compress_on);
+        weight = 0.;
+        nr = 1;
+        axial = false;
+        for (const std::string &str: strs) {
+            if (boost::starts_with(str, "DimAzimuth=")) {
+                nr = boost::lexical_cast<int>(str.substr(11));
+            } else if (str == "Axial=T") {
+                axial = true;
+            } else {
+                auto it = sAnalyticWeights.find(str);
+                if (it != sAnalyticWeights.end()) weight += it->second;
+            }
+        }
+    }
+}
+
+double CostLibrary::analyticElement(const std::string &signature) {
+    double weight;
+    int nr;
+    bool axial;
+    parseSignature(signature, weight, nr, axial);
+    // linear in Nr for constitutive relations, Nr log(Nr) for FFT
+    double cost = weight * nr * (1. + std::log2(std::max(nr, 2)) / 8.);
+    if (axial) cost *= 1.2;
+    return cost;
+}
+
+double CostLibrary::analyticPoint(const std::string &signature) {
+    double weight;
+    int nr;
+    bool axial;
+    parseSignature(signature, weight, nr, axial);
+    return weight * nr;
+}
+
+void CostLibrary::computeAnalyticScales() {
+    // ratio of measured to analytic, 1 if nothing measured
+    double sumMeasure = 0., sumModel = 0.;
+    for (auto it = mElementCosts.begin(); it != mElementCosts.end(); it++) {
+        sumMeasure += it->second;
+        sumModel += analyticElement(it->first);
+    }
+    mScaleElement = (sumModel > 0. && sumMeasure > 0.) ? sumMeasure / sumModel : 1.;
+    sumMeasure = sumModel = 0.;
+    for (auto it = mPointCosts.begin(); it != mPointCosts.end(); it++) {
+        sumMeasure += it->second;
+        sumModel += analyticPoint(it->first);
+    }
+    mScalePoint = (sumModel > 0. && sumMeasure > 0.) ? sumMeasure / sumModel : 1.;
+    // point model has no absolute unit, tie it to elements if not measured
+    if (mPointCosts.size() == 0 && mElementCosts.size() > 0) mScalePoint = mScaleElement;
+}
+
@@ -0,0 +1,54 @@
+// CostLibrary.h
+// created by agent on 19-Oct-2026
+// persistent library of measured element and point costs
+// keyed by machine and build, with an analytic fallback
+
+#pragma once
+
+#include <string>
+#include <map>
+
+class CostLibrary {
+public:
+    // read library of this machine from directory, all procs must call
+    CostLibrary(const std::string &directory);
+
+    // known signature
+    bool knowsElement(const std::string &signature) const {
+        return mElementCosts.find(signature) != mElementCosts.end();};
+    bool knowsPoint(const std::string &signature) const {
+        return mPointCosts.find(signature) != mPointCosts.end();};
+
+    // cost of a signature, analytic if never measured
+    double getElementCost(const std::string &signature) const;
+    double getPointCost(const std::string &signature) const;
+
+    // add new measurements, keeping the minimum if existent
+    void addElementCosts(const std::map<std::string, double> &measured);
+    void addPointCosts(const std::map<std::string, double> &measured);
+
+    // write to file, root only
+    void write() const;
+
+    // library content as a single string, for partition cache key
+    std::string contentSignature() const;
+
+    // machine and build
+    const std::string &getMachineKey() const {return mMachineKey;};
+    static std::string machineKey();
+
+private:
+    // analytic cost model, up to a machine-dependent scale
+    static double analyticElement(const std::string &signature);
+    static double analyticPoint(const std::string &signature);
+    // scale analytic model to measured library
+    void computeAnalyticScales();
+
+    std::string mMachineKey;
+    std::string mFileName;
+    std::map<std::string, double> mElementCosts;
+    std::map<std::string, double> mPointCosts;
+    double mScaleElement;
+    double mScalePoint;
+};
+
@@ -125,6 +125,45 @@ int GLLPoint::release(Domain &domain) const {
     } 
 }
 
+std::string GLLPoint::costSignature() const {
+    // same choices as release
+    bool isSolid = mMassSolid.norm() > tinyDouble;
+    bool isFluid = mMassFluid.norm() > tinyDouble; 
+    std::string massSolid, massFluid;
+    if (isSolid) {
+        if (mOceanDepth.array().abs().maxCoeff() > tinyDouble) {
+            if (XMath::equalRows(mMassSolid) && XMath::equalRows(mOceanDepth) && XMath::equalRows(mSurfNormal)) 
+                massSolid = "MassOcean1D";
+            else 
+                massSolid = "MassOcean3D";
+        } else {
+            massSolid = XMath::equalRows(mMassSolid) ? "Mass1D" : "Mass3D";
+        }
+    }
+    if (isFluid) massFluid = XMath::equalRows(mMassFluid) ? "Mass1D" : "Mass3D";
+    std::stringstream ss;
+    if (isSolid && isFluid) {
+        bool couple1D = XMath::equalRows(mSFNormal_assmble) && XMath::equalRows(mMassFluid);
+        ss << "SolidFluidPoint$" << massSolid << "$" << massFluid << "$" << (couple1D ? "SFCoupling1D" : "SFCoupling3D");
+    } else if (isSolid) {
+        ss << "SolidPoint$" << massSolid;
+    } else if (isFluid) {
+        ss << "FluidPoint$" << massFluid;
+    } else {
+        throw std::runtime_error("GLLPoint::costSignature || Point is in neither solid nor fluid domain.");
+    }
+    ss << "$DimAzimuth=" << mNr << "$Axial=" << (mIsAxial ? "T" : "F");
+    return ss.str();
+}
+
+int GLLPoint::sizeComm() const {
+    // solid: 3 components, fluid: 1, for each order
+    int size = 0;
+    if (mMassSolid.norm() > tinyDouble) size += (mNr / 2 + 1) * 3;
+    if (mMassFluid.norm() > tinyDouble) size += mNr / 2 + 1;
+    return size;
+}
+
 void GLLPoint::feedBuffer(RDMatXX &buffer, int col) {
     int nr = mSFNormal_assmble.rows();
     buffer.block(0, col, nr, 1) = mMassSolid;
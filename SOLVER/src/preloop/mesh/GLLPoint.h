@@ -28,6 +28,11 @@ public:
     // release to domain
     int release(Domain &domain) const;
     
+    // cost signature and communication size of the point to be released, 
+    // as in Point::costSignature and Point::sizeComm
+    std::string costSignature() const;
+    int sizeComm() const;
+    
     // gets 
     int getNr() const {return mNr;};
     int getReferenceCount() const {return mReferenceCount;};
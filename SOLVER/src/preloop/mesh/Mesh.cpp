@@ -18,15 +18,26 @@
 #include "XMath.h"
 #include "Geometric3D.h"
 #include "NuWisdom.h"
+#include "NrField.h"
+#include "Volumetric3D.h"
+#include "OceanLoad3D.h"
+#include "PartitionCache.h"
+#include "CostLibrary.h"
+#include "QuadIndex.h"
 
 #include "XTimer.h"
 #include "SlicePlot.h"
 #include <fstream>
+#include <sstream>
+#include <exception>
+#include <cstdint>
 
 Mesh::~Mesh() {
     destroy(); // local build
     delete mDDPar;
     delete mLearnPar;
+    if (mPartitionCache) delete mPartitionCache;
+    if (mCostLibrary) delete mCostLibrary;
     for (const auto &sp: mSlicePlots) delete sp;    
 }
 
@@ -35,9 +46,19 @@ Mesh::Mesh(const ExodusModel *exModel, const NrField *nrf,
 mExModel(exModel), mNrField(nrf), mSrcLat(srcLat), mSrcLon(srcLon), mSrcDep(srcDep) {
     mAttBuilder = 0;
     mMsgInfo = 0;
+    mQuadIndex = 0;
     mOceanLoad3D = 0;
     mDDPar = new DDParameters(par);
     mLearnPar = new LearnParameters(par);
+    mPartitionCache = 0;
+    mPartitionFromCache = false;
+    // also used to store tuned options
+    if (mDDPar->mCachePartition || mDDPar->mTuneSteps > 0) 
+        mPartitionCache = new PartitionCache(mDDPar->mCacheDirectory);
+    mStreamRelease = par.getValue<bool>("OPTION_STREAM_RELEASE");
+    mCostLibrary = 0;
+    if (mDDPar->mCostLibrary) 
+        mCostLibrary = new CostLibrary(mDDPar->mCacheDirectory);
     
     // 2D mode
     mUse2D = par.getValue<bool>("MODEL_2D_MODE");
@@ -63,7 +84,7 @@ mExModel(exModel), mNrField(nrf), mSrcLat(srcLat), mSrcLon(srcLon), mSrcDep(srcD
             fs << exModel->getNodalS(i) << " " << exModel->getNodalZ(i) << std::endl; 
         fs.close();
         // element connectivity
-        const std::vector<std::array<int, 4>> &con = exModel->getConnectivity();
+        const SharedArray<std::array<int, 4>> &con = exModel->getConnectivity();
         fs.open(Parameters::sOutputDirectory + "/plots/mesh_connectivity.txt", std::fstream::out);
         for (int i = 0; i < exModel->getNumQuads(); i++) 
             fs << con[i][0] << " " << con[i][1] << " " << con[i][2] << " " << con[i][3] << std::endl;
@@ -73,6 +94,28 @@ mExModel(exModel), mNrField(nrf), mSrcLat(srcLat), mSrcLon(srcLon), mSrcDep(srcD
 
 void Mesh::buildUnweighted() {
     int nElemGlobal = mExModel->getNumQuads(); 
+    
+    // try partition cache
+    // the cached elemToProc already came from a weighted build under a key 
+    // that covers all cost inputs, so it is used right now and buildWeighted 
+    // will then be skipped
+    if (mPartitionCache) formPartitionKey(*mPartitionCache);
+    if (mDDPar->mCachePartition) {
+        XTimer::begin("Read Partition Cache", 1);
+        IColX elemToProc;
+        mPartitionFromCache = mPartitionCache->read(nElemGlobal, elemToProc);
+        XTimer::end("Read Partition Cache", 1);
+        if (mPartitionFromCache) {
+            XTimer::begin("Build Local", 1);
+            buildLocal(elemToProc);
+            XTimer::end("Build Local", 1);
+            XTimer::begin("Plot at Unweighted Phase", 1);
+            for (const auto &sp: mSlicePlots) sp->plotUnweighted();
+            XTimer::end("Plot at Unweighted Phase", 1);
+            return;
+        }
+    }
+    
     // balance solid and fluid separately
     DecomposeOption option(nElemGlobal, true, 0., 1, mDDPar->mNPartMetis, false);
     for (int iquad = 0; iquad < nElemGlobal; iquad++) {
@@ -102,30 +145,77 @@ void Mesh::setAttBuilder(const AttBuilder *attBuild) {
 }
 
 void Mesh::buildWeighted() {
-    DecomposeOption measured;
-    XTimer::begin("Measure", 1);
-    measure(measured);
-    XTimer::end("Measure", 1);
-    
-    XTimer::begin("Build Local", 1);
-    buildLocal(measured);
-    XTimer::end("Build Local", 1);
+    if (!mPartitionFromCache) {
+        DecomposeOption measured;
+        XTimer::begin("Measure", 1);
+        measure(measured);
+        // key the cache by the library state actually used for the weights, 
+        // which is also what the next run will find before measuring
+        if (mPartitionCache && mCostLibrary) {
+            mPartitionCache->resetKey();
+            formPartitionKey(*mPartitionCache);
+        }
+        XTimer::end("Measure", 1);
+        
+        // tune decomposition options by trial runs
+        bool balanceEP = mDDPar->mBalanceEP;
+        bool commVol = mDDPar->mCommVolMetis;
+        if (mDDPar->mTuneSteps > 0) {
+            XTimer::begin("Tune Decomposition", 1);
+            if (!mPartitionCache->readOptions(balanceEP, commVol)) {
+                tune(measured, balanceEP, commVol);
+                mPartitionCache->writeOptions(balanceEP, commVol);
+            }
+            XTimer::end("Tune Decomposition", 1);
+        }
+        DecomposeOption weighted = formWeightedOption(measured, balanceEP, commVol);
+        
+        XTimer::begin("Build Local", 1);
+        buildLocal(weighted);
+        XTimer::end("Build Local", 1);
+        
+        // rebalance by a rehearsal of the time loop
+        if (mDDPar->mRebalanceSteps > 0) {
+            XTimer::begin("Rebalance", 1);
+            rebalance(weighted);
+            buildLocal(weighted);
+            XTimer::end("Rebalance", 1);
+        }
+        
+        // save partition
+        if (mDDPar->mCachePartition) {
+            XTimer::begin("Write Partition Cache", 1);
+            mPartitionCache->write(mElemToProc);
+            XTimer::end("Write Partition Cache", 1);
+        }
+    }
     // slice plots
     XTimer::begin("Plot at Weighted Phase", 1);
     for (const auto &sp: mSlicePlots) sp->plotWeighted();
     XTimer::end("Plot at Weighted Phase", 1);
 }
 
-void Mesh::release(Domain &domain) {
+void Mesh::release(Domain &domain, bool streaming) {
     XTimer::begin("Release Points", 2);
-    for (const auto &point: mGLLPoints) point->release(domain);
+    for (auto &point: mGLLPoints) {
+        point->release(domain);
+        if (streaming) {
+            delete point;
+            point = 0;
+        }
+    }
+    if (streaming) std::vector<GLLPoint *>().swap(mGLLPoints);
     XTimer::end("Release Points", 2);
     
     XTimer::begin("Release Elements", 2);
     for (int iloc = 0; iloc < getNumQuads(); iloc++) {
         int etag = mQuads[iloc]->release(domain, mLocalElemToGLL[iloc], mAttBuilder);
         mQuads[iloc]->setElementTag(etag);
+        // source can only be located in axial solid Quads
+        if (streaming) 
+            mQuads[iloc]->freeAfterRelease(mQuads[iloc]->isAxial() && !mQuads[iloc]->isFluid());
     }
+    if (streaming) std::vector<IMatPP>().swap(mLocalElemToGLL);
     XTimer::end("Release Elements", 2);
     
     // set messaging 
@@ -147,48 +237,107 @@ void Mesh::release(Domain &domain) {
     domain.setLearnParameters(new LearnParameters(*mLearnPar));
 }
 
+void Mesh::findQuads(double s, double z, std::vector<int> &locs) const {
+    locs.clear();
+    if (mQuadIndex) mQuadIndex->query(s, z, locs);
+}
+
 double Mesh::computeRadiusRef(double depth, double lat, double lon) const {
-    // geocentric 
-    double theta = XMath::lat2Theta(lat, depth);
-    double phi = XMath::lon2Phi(lon);
+    RDColX radius;
+    computeRadiusRef(RDColX::Constant(1, depth), RDColX::Constant(1, lat), 
+        RDColX::Constant(1, lon), radius);
+    return radius(0);
+}
+
+void Mesh::computeRadiusRef(const RDColX &depth, const RDColX &lat, const RDColX &lon, 
+    RDColX &radius) const {
+    int npnt = depth.rows();
     double router = mExModel->getROuter();
+    radius = RDColX::Constant(npnt, router);
     
-    // 2D mode
-    if (mUse2D) {
-        RDCol3 rtpG, rtpS;
-        rtpG(0) = 1.;
-        rtpG(1) = theta;
-        rtpG(2) = phi;
-        rtpS = XMath::rotateGlob2Src(rtpG, mSrcLat, mSrcLon, mSrcDep);
-        // enforced azimuth
-        rtpS(2) = mPhi2D;
-        rtpG = XMath::rotateSrc2Glob(rtpS, mSrcLat, mSrcLon, mSrcDep);
-        theta = rtpG(1);
-        phi = rtpG(2);
+    // geocentric, surface receivers excluded
+    std::vector<int> active;
+    std::vector<double> vtheta, vphi;
+    for (int i = 0; i < npnt; i++) {
+        // surface receivers
+        if (depth(i) < tinyDouble) continue;
+        double theta = XMath::lat2Theta(lat(i), depth(i));
+        double phi = XMath::lon2Phi(lon(i));
+        // 2D mode
+        if (mUse2D) {
+            RDCol3 rtpG, rtpS;
+            rtpG(0) = 1.;
+            rtpG(1) = theta;
+            rtpG(2) = phi;
+            rtpS = XMath::rotateGlob2Src(rtpG, mSrcLat, mSrcLon, mSrcDep);
+            // enforced azimuth
+            rtpS(2) = mPhi2D;
+            rtpG = XMath::rotateSrc2Glob(rtpS, mSrcLat, mSrcLon, mSrcDep);
+            theta = rtpG(1);
+            phi = rtpG(2);
+        }
+        active.push_back(i);
+        vtheta.push_back(theta);
+        vphi.push_back(phi);
     }
-    
-    // surface receivers
-    if (depth < tinyDouble) return router;
+    int nact = active.size();
+    if (nact == 0) return;
+    RDColX theta = Eigen::Map<RDColX>(vtheta.data(), nact);
+    RDColX phi = Eigen::Map<RDColX>(vphi.data(), nact);
+    RDColX dep(nact);
+    for (int j = 0; j < nact; j++) dep(j) = depth(active[j]);
     
     // target
-    double R = computeRPhysical(router, theta, phi) - depth;
+    RDColX R, R_r;
+    computeRPhysical(RDColX::Constant(nact, router), theta, phi, R, R_r);
+    R -= dep;
     double distTol = std::min((double)tinySingle, mExModel->getDistTolerance() * tinySingle);
     
-    // computeRPhysical is monotonically increasing, so we use Divide-and-Conquer method
+    // computeRPhysical is monotonically increasing, so we use Newton's method
+    // safeguarded by a shrinking bracket, falling back to bisection
+    // whenever a Newton step leaves the bracket
     // initial guess = router - depth
-    double current = router - depth;
-    double upper = router;
-    double lower = 0.;
+    RDColX current = RDColX::Constant(nact, router) - dep;
+    RDColX upper = RDColX::Constant(nact, router);
+    RDColX lower = RDColX::Zero(nact);
     int maxIter = 10000;
     int iter = 0;
     while (iter++ <= maxIter) {
-        double diff = computeRPhysical(current, theta, phi) - R;
-        if (std::abs(diff) < distTol) return current;
-        if (diff > 0.) 
-            upper = current;
-        else 
-            lower = current;
-        current = .5 * (lower + upper);
+        RDColX rPhys, rPhys_r;
+        computeRPhysical(current, theta, phi, rPhys, rPhys_r);
+        // update and compact active set
+        int nnew = 0;
+        for (int j = 0; j < nact; j++) {
+            double diff = rPhys(j) - R(j);
+            if (std::abs(diff) < distTol) {
+                radius(active[j]) = current(j);
+                continue;
+            }
+            if (diff > 0.) 
+                upper(j) = current(j);
+            else 
+                lower(j) = current(j);
+            double next = current(j) - diff / rPhys_r(j);
+            if (!(rPhys_r(j) > 0. && next > lower(j) && next < upper(j))) 
+                next = .5 * (lower(j) + upper(j));
+            active[nnew] = active[j];
+            theta(nnew) = theta(j);
+            phi(nnew) = phi(j);
+            R(nnew) = R(j);
+            lower(nnew) = lower(j);
+            upper(nnew) = upper(j);
+            current(nnew) = next;
+            nnew++;
+        }
+        nact = nnew;
+        if (nact == 0) return;
+        active.resize(nact);
+        theta.conservativeResize(nact);
+        phi.conservativeResize(nact);
+        R.conservativeResize(nact);
+        lower.conservativeResize(nact);
+        upper.conservativeResize(nact);
+        current.conservativeResize(nact);
     }
     throw std::runtime_error("Mesh::computeRadiusRef || Failed to find reference radius.");
 }
@@ -200,7 +349,36 @@ double Mesh::computeRPhysical(double r, double theta, double phi) const {
     return r + deltaR;
 }
 
+void Mesh::computeRPhysical(const RDColX &r, const RDColX &theta, const RDColX &phi, 
+    RDColX &rPhys, RDColX &rPhys_r) const {
+    RDMatX3 rtp(r.rows(), 3);
+    rtp << r, theta, phi;
+    rPhys = r;
+    rPhys_r = RDColX::Ones(r.rows());
+    for (const auto &g3D: mGeometric3D) {
+        RDColX deltaR, deltaR_r;
+        g3D->getDeltaRBatch(rtp, r, deltaR, deltaR_r);
+        rPhys += deltaR;
+        rPhys_r += deltaR_r;
+    }
+}
+
 void Mesh::buildLocal(const DecomposeOption &option) {
+    // metis partition
+    XTimer::begin("Partition", 2);
+    IColX elemToProc;
+    Connectivity(mExModel->getConnectivity()).partition(option, elemToProc);
+    XTimer::end("Partition", 2);
+    buildLocal(elemToProc);
+}
+
+void Mesh::buildLocal(const IColX &elemToProc) {
+    // reuse Quads of existent build, with evaluated 3D models
+    XTimer::begin("Migrate Quads", 2);
+    std::map<int, Quad *> migrated;
+    migrateQuads(elemToProc, migrated);
+    XTimer::end("Migrate Quads", 2);
+    
     // destroy existent
     destroy();
     
@@ -208,9 +386,10 @@ void Mesh::buildLocal(const DecomposeOption &option) {
     XTimer::begin("Domain Decomposition", 2);
     int nGllLocal;
     IColX procMask;
+    mElemToProc = elemToProc;
     mMsgInfo = new MessagingInfo();
     Connectivity con_global(mExModel->getConnectivity());
-    con_global.decompose(option, nGllLocal, mLocalElemToGLL, *mMsgInfo, procMask);
+    con_global.decompose(mElemToProc, nGllLocal, mLocalElemToGLL, *mMsgInfo, procMask);
     XTimer::end("Domain Decomposition", 2);
     
     // form empty points 
@@ -222,38 +401,89 @@ void Mesh::buildLocal(const DecomposeOption &option) {
     
     // quads 
     XTimer::begin("Generate Quads", 2);
+    std::vector<int> myQuads;
+    myQuads.reserve(mLocalElemToGLL.size());
+    for (int iquad = 0; iquad < mExModel->getNumQuads(); iquad++) 
+        if (procMask(iquad)) myQuads.push_back(iquad);
+    mQuads.assign(myQuads.size(), 0);
+    // local range for 3D models, from nodes of local Quads 
+    double sMinLocal = 1e30, sMaxLocal = -1e30, zMinLocal = 1e30, zMaxLocal = -1e30;
+    for (int iquad: myQuads) {
+        for (int nodeTag: mExModel->getConnectivity()[iquad]) {
+            sMinLocal = std::min(sMinLocal, mExModel->getNodalS(nodeTag));
+            sMaxLocal = std::max(sMaxLocal, mExModel->getNodalS(nodeTag));
+            zMinLocal = std::min(zMinLocal, mExModel->getNodalZ(nodeTag));
+            zMaxLocal = std::max(zMaxLocal, mExModel->getNodalZ(nodeTag));
+        }
+    }
+    for (const auto &m3D: mVolumetric3D) 
+        m3D->setupLocalRange(sMinLocal, sMaxLocal, zMinLocal, zMaxLocal);
+    // 3D models are evaluated independently by each Quad
+    int nQuadLocal = myQuads.size();
+    std::exception_ptr error = nullptr;
+    #pragma omp parallel for schedule(dynamic)
+    for (int iloc = 0; iloc < nQuadLocal; iloc++) {
+        try {
+            int iquad = myQuads[iloc];
+            Quad *quad = 0;
+            auto it = migrated.find(iquad);
+            if (it != migrated.end()) {
+                // migrated Quad
+                quad = it->second;
+            } else {
+                // 1D Quad
+                quad = new Quad(*mExModel, iquad, *mNrField);
+                // 3D model
+                for (int j = 0; j < mVolumetric3D.size(); j++) 
+                    quad->addVolumetric3D(*(mVolumetric3D[j]), mSrcLat, mSrcLon, mSrcDep, mPhi2D);
+                for (int j = 0; j < mGeometric3D.size(); j++) 
+                    quad->addGeometric3D(*(mGeometric3D[j]), mSrcLat, mSrcLon, mSrcDep, mPhi2D);
+                if (mOceanLoad3D != 0) quad->setOceanLoad3D(*mOceanLoad3D, mSrcLat, mSrcLon, mSrcDep, mPhi2D);    
+                quad->finishModel3D();
+            }
+            // add to local build
+            mQuads[iloc] = quad;
+        } catch (...) {
+            #pragma omp critical(preloop_error)
+            if (error == nullptr) error = std::current_exception();
+        }
+    }
+    if (error != nullptr) std::rethrow_exception(error);
+    // spatial range
     double s_max, s_min, z_max, z_min;
     mSMax = mZMax = -1e30;
     mSMin = mZMin = 1e30;
-    mQuads.reserve(mLocalElemToGLL.size());
-    for (int iquad = 0; iquad < mExModel->getNumQuads(); iquad++) {
-        if (procMask(iquad)) {
-            // 1D Quad
-            Quad *quad = new Quad(*mExModel, iquad, *mNrField);
-            // 3D model
-            for (int j = 0; j < mVolumetric3D.size(); j++) 
-                quad->addVolumetric3D(*(mVolumetric3D[j]), mSrcLat, mSrcLon, mSrcDep, mPhi2D);
-            for (int j = 0; j < mGeometric3D.size(); j++) 
-                quad->addGeometric3D(*(mGeometric3D[j]), mSrcLat, mSrcLon, mSrcDep, mPhi2D);
-            if (mOceanLoad3D != 0) quad->setOceanLoad3D(*mOceanLoad3D, mSrcLat, mSrcLon, mSrcDep, mPhi2D);    
-            quad->finishModel3D();
-            // spatial range
-            quad->getSpatialRange(s_max, s_min, z_max, z_min);
-            mSMax = std::max(mSMax, s_max);
-            mSMin = std::min(mSMin, s_min);
-            mZMax = std::max(mZMax, z_max);
-            mZMin = std::min(mZMin, z_min);
-            // add to local build
-            mQuads.push_back(quad);
-        }
+    for (const auto &quad: mQuads) {
+        quad->getSpatialRange(s_max, s_min, z_max, z_min);
+        mSMax = std::max(mSMax, s_max);
+        mSMin = std::min(mSMin, s_min);
+        mZMax = std::max(mZMax, z_max);
+        mZMin = std::min(mZMin, z_min);
     }
+    if (mQuadIndex) delete mQuadIndex;
+    mQuadIndex = new QuadIndex(mQuads);
     XTimer::end("Generate Quads", 2);
     
     // setup GLL points
+    // Quads of the same color share no point, so that each color can be 
+    // processed concurrently and the order of mass summation is fixed
     XTimer::begin("Setup Points", 2);
-    for (int iloc = 0; iloc < mLocalElemToGLL.size(); iloc++) {
-        mQuads[iloc]->setupGLLPoints(mGLLPoints, mLocalElemToGLL[iloc], mExModel->getDistTolerance());
-    } 
+    std::vector<std::vector<int>> colors;
+    colorQuads(nGllLocal, colors);
+    for (const auto &color: colors) {
+        int nQuadColor = color.size();
+        #pragma omp parallel for schedule(dynamic)
+        for (int ic = 0; ic < nQuadColor; ic++) {
+            try {
+                int iloc = color[ic];
+                mQuads[iloc]->setupGLLPoints(mGLLPoints, mLocalElemToGLL[iloc], mExModel->getDistTolerance());
+            } catch (...) {
+                #pragma omp critical(preloop_error)
+                if (error == nullptr) error = std::current_exception();
+            }
+        }
+        if (error != nullptr) std::rethrow_exception(error);
+    }
     XTimer::end("Setup Points", 2);
     
     /////////////////////////////// assemble mass and normal ///////////////////////////////
@@ -309,6 +539,104 @@ void Mesh::buildLocal(const DecomposeOption &option) {
     XTimer::end("Assemble Mass", 2);
 }
 
+void Mesh::migrateQuads(const IColX &elemToProc, std::map<int, Quad *> &quads) {
+    quads.clear();
+    // no existent build
+    if (mElemToProc.rows() != elemToProc.rows()) return;
+    
+    // keep Quads staying here and pack those leaving
+    int myrank = XMPI::rank();
+    int nproc = XMPI::nproc();
+    std::vector<std::vector<double>> bufferPack(nproc);
+    for (const auto &quad: mQuads) {
+        int dest = elemToProc(quad->getQuadTag());
+        if (dest == myrank) {
+            quads.insert(std::make_pair(quad->getQuadTag(), quad));
+        } else {
+            quad->packModel3D(bufferPack[dest]);
+            delete quad;
+        }
+    }
+    // ownership taken, no longer destroyed with the old build
+    mQuads.clear();
+    
+    // Quads arriving here, in ascending order of tag as packed by senders
+    std::vector<std::vector<int>> arriving(nproc);
+    for (int iquad = 0; iquad < elemToProc.rows(); iquad++) 
+        if (elemToProc(iquad) == myrank && mElemToProc(iquad) != myrank) 
+            arriving[mElemToProc(iquad)].push_back(iquad);
+    
+    // procs to communicate with, known by both sides from the two partitions
+    std::vector<int> procSend, procRecv;
+    for (int iproc = 0; iproc < nproc; iproc++) {
+        if (bufferPack[iproc].size() > 0) procSend.push_back(iproc);
+        if (arriving[iproc].size() > 0) procRecv.push_back(iproc);
+    }
+    
+    // buffer sizes
+    std::vector<RDColX> sizeSend(procSend.size()), sizeRecv(procRecv.size());
+    std::vector<MPI_Request> reqSend(procSend.size()), reqRecv(procRecv.size());
+    for (int i = 0; i < procSend.size(); i++) {
+        sizeSend[i] = RDColX::Constant(1, bufferPack[procSend[i]].size());
+        XMPI::isendDouble(procSend[i], sizeSend[i], reqSend[i]);
+    }
+    for (int i = 0; i < procRecv.size(); i++) {
+        sizeRecv[i] = RDColX::Zero(1);
+        XMPI::irecvDouble(procRecv[i], sizeRecv[i], reqRecv[i]);
+    }
+    XMPI::wait_all(reqRecv.size(), reqRecv.data());
+    XMPI::wait_all(reqSend.size(), reqSend.data());
+    
+    // 3D models
+    std::vector<RDColX> bufferSend(procSend.size()), bufferRecv(procRecv.size());
+    for (int i = 0; i < procSend.size(); i++) {
+        std::vector<double> &pack = bufferPack[procSend[i]];
+        bufferSend[i] = Eigen::Map<RDColX>(pack.data(), pack.size());
+        std::vector<double>().swap(pack);
+        XMPI::isendDouble(procSend[i], bufferSend[i], reqSend[i]);
+    }
+    for (int i = 0; i < procRecv.size(); i++) {
+        bufferRecv[i] = RDColX::Zero((int)sizeRecv[i](0));
+        XMPI::irecvDouble(procRecv[i], bufferRecv[i], reqRecv[i]);
+    }
+    XMPI::wait_all(reqRecv.size(), reqRecv.data());
+    
+    // rebuild arriving Quads from Exodus, without evaluating 3D models
+    for (int i = 0; i < procRecv.size(); i++) {
+        int pos = 0;
+        for (int iquad: arriving[procRecv[i]]) {
+            Quad *quad = new Quad(*mExModel, iquad, *mNrField);
+            quad->unpackModel3D(bufferRecv[i], pos);
+            quads.insert(std::make_pair(iquad, quad));
+        }
+        if (pos != bufferRecv[i].size()) 
+            throw std::runtime_error("Mesh::migrateQuads || Inconsistent migration buffer.");
+    }
+    XMPI::wait_all(reqSend.size(), reqSend.data());
+}
+
+void Mesh::colorQuads(int nGllLocal, std::vector<std::vector<int>> &colors) const {
+    // greedy coloring, with colors used by each point as bits
+    std::vector<uint64_t> pointColors(nGllLocal, 0);
+    colors.clear();
+    for (int iloc = 0; iloc < mLocalElemToGLL.size(); iloc++) {
+        const IMatPP &tags = mLocalElemToGLL[iloc];
+        uint64_t used = 0;
+        for (int ipol = 0; ipol <= nPol; ipol++) 
+            for (int jpol = 0; jpol <= nPol; jpol++) 
+                used |= pointColors[tags(ipol, jpol)];
+        int icolor = 0;
+        while (icolor < 64 && (used >> icolor & 1)) icolor++;
+        if (icolor == 64) throw std::runtime_error("Mesh::colorQuads || "
+            "Too many elements sharing a single GLL point.");
+        for (int ipol = 0; ipol <= nPol; ipol++) 
+            for (int jpol = 0; jpol <= nPol; jpol++) 
+                pointColors[tags(ipol, jpol)] |= (uint64_t)1 << icolor;
+        if (icolor == colors.size()) colors.push_back(std::vector<int>());
+        colors[icolor].push_back(iloc);
+    }
+}
+
 void Mesh::destroy() {
     // points
     for (const auto &point: mGLLPoints) delete point;
@@ -316,6 +644,10 @@ void Mesh::destroy() {
     // quads
     for (const auto &quad: mQuads) delete quad;
     mQuads.clear();
+    if (mQuadIndex) {
+        delete mQuadIndex;
+        mQuadIndex = 0;
+    }
     // l2g mapping
     mLocalElemToGLL.clear();
     // message
@@ -326,9 +658,36 @@ void Mesh::destroy() {
 }
 
 void Mesh::measure(DecomposeOption &measured) {
-    // a temp Domain
+    // cost signatures from Quads and GLLPoints
+    int nQuad = getNumQuads();
+    int ngll = mGLLPoints.size();
+    std::vector<std::string> elemSignature(nQuad), pointSignature(ngll);
+    for (int iloc = 0; iloc < nQuad; iloc++) 
+        elemSignature[iloc] = mQuads[iloc]->costSignature(mAttBuilder);
+    for (int ip = 0; ip < ngll; ip++) 
+        pointSignature[ip] = mGLLPoints[ip]->costSignature();
+    
+    // a temp Domain, released only if something is to be measured on this proc
+    // element types for slice plots need the released elements on all procs
+    bool needRelease = !mCostLibrary;
+    for (const auto &sp: mSlicePlots) 
+        if (sp->plotsEleType()) needRelease = true;
+    if (mCostLibrary && mDDPar->mCostLibraryMeasure) {
+        for (int iloc = 0; iloc < nQuad && !needRelease; iloc++) 
+            needRelease = !mCostLibrary->knowsElement(elemSignature[iloc]);
+        for (int ip = 0; ip < ngll && !needRelease; ip++) 
+            needRelease = !mCostLibrary->knowsPoint(pointSignature[ip]);
+    }
     Domain domain;
-    release(domain);
+    if (needRelease) {
+        release(domain, false);
+        for (int iloc = 0; iloc < nQuad; iloc++) 
+            if (domain.getElement(mQuads[iloc]->getElementTag())->costSignature() != elemSignature[iloc]) 
+                throw std::runtime_error("Mesh::measure || Cost signature mismatch between Quad and Element.");
+        for (int ip = 0; ip < ngll; ip++) 
+            if (domain.getPoint(ip)->costSignature() != pointSignature[ip]) 
+                throw std::runtime_error("Mesh::measure || Cost signature mismatch between GLLPoint and Point.");
+    }
     
     // user clock resolution
     double clockFactor = 1e4;
@@ -346,26 +705,26 @@ void Mesh::measure(DecomposeOption &measured) {
     IColX eCommSize = IColX::Zero(nElemGlobal);
     // create library
     std::map<std::string, double> elemCostLibrary;
-    for (int iloc = 0; iloc < getNumQuads(); iloc++) {
-        int elemTag = mQuads[iloc]->getElementTag();
-        Element *elem = domain.getElement(elemTag);
-        // get cost signature
-        std::string coststr = elem->costSignature();
+    for (int iloc = 0; iloc < nQuad; iloc++) {
+        const std::string &coststr = elemSignature[iloc];
+        // skip if known to persistent library or measurement disabled
+        if (mCostLibrary && (mCostLibrary->knowsElement(coststr) || 
+            !mDDPar->mCostLibraryMeasure)) continue;
         // insert to library
         elemCostLibrary.insert(std::pair<std::string, double>(coststr, -1.));
         // perform measurement only if it is new (measure = -1.)
         if (elemCostLibrary.at(coststr) < 0.) {
             // find how may steps are needed to use USER clock
+            Element *elem = domain.getElement(mQuads[iloc]->getElementTag());
             double wall = elem->measure(minStep);
             int nstep = std::max(minStep, (int)(clockResolution * clockFactor / wall) + 1);
             elemCostLibrary.at(coststr) = elem->measure(nstep);
             // find elements with the same signature
             int sameKindFound = 0;
-            for (int jloc = iloc + 1; jloc < getNumQuads(); jloc++) {
-                int elemTagOther = mQuads[jloc]->getElementTag();
-                Element *elemOther = domain.getElement(elemTagOther);
-                if (elemOther->costSignature() == coststr) {
+            for (int jloc = iloc + 1; jloc < nQuad; jloc++) {
+                if (elemSignature[jloc] == coststr) {
                     // use minimum
+                    Element *elemOther = domain.getElement(mQuads[jloc]->getElementTag());
                     elemCostLibrary.at(coststr) = std::min(elemOther->measure(nstep), 
                         elemCostLibrary.at(coststr));
                     if (++sameKindFound == nMeasureSameKind) break;
@@ -388,17 +747,26 @@ void Mesh::measure(DecomposeOption &measured) {
                 elemCostLibraryGlobal.at(it->first));
         }
     }
+    // merge into persistent library
+    if (mCostLibrary) mCostLibrary->addElementCosts(elemCostLibraryGlobal);
     // read library
-    for (int iloc = 0; iloc < getNumQuads(); iloc++) {
-        int elemTag = mQuads[iloc]->getElementTag();
-        Element *elem = domain.getElement(elemTag);
+    for (int iloc = 0; iloc < nQuad; iloc++) {
         // read library
-        double measure = elemCostLibraryGlobal.at(elem->costSignature());
+        double measure = mCostLibrary ? mCostLibrary->getElementCost(elemSignature[iloc]) : 
+            elemCostLibraryGlobal.at(elemSignature[iloc]);
         // assign to element
         int quadTag = mQuads[iloc]->getQuadTag();
         eWgtEle(quadTag) = measure;
-        // commnunication size    
-        eCommSize(quadTag) = elem->sizeComm();
+        // commnunication size, maximum over the four edges as in Element::sizeComm
+        const IMatPP &tags = mLocalElemToGLL[iloc];
+        int size0 = 0, size1 = 0, size2 = 0, size3 = 0;
+        for (int k = 0; k <= nPol; k++) {
+            size0 += mGLLPoints[tags(0, k)]->sizeComm();
+            size1 += mGLLPoints[tags(nPol, k)]->sizeComm();
+            size2 += mGLLPoints[tags(k, 0)]->sizeComm();
+            size3 += mGLLPoints[tags(k, nPol)]->sizeComm();
+        }
+        eCommSize(quadTag) = std::max(size0, std::max(size1, std::max(size2, size3)));
     }
     XTimer::end("Bcast Element Costs", 2);
     
@@ -406,27 +774,28 @@ void Mesh::measure(DecomposeOption &measured) {
     ////////// measure points //////////
     XTimer::begin("Measure Points", 2);
     // initialize with zero weights
-    int ngll = mGLLPoints.size();
     RDColX pWgt = RDColX::Zero(ngll);
     // create library
     std::map<std::string, double> pointCostLibrary;
     for (int ip = 0; ip < ngll; ip++) {
-        Point *point = domain.getPoint(ip);
-        // get cost signature
-        std::string coststr = point->costSignature();
+        const std::string &coststr = pointSignature[ip];
+        // skip if known to persistent library or measurement disabled
+        if (mCostLibrary && (mCostLibrary->knowsPoint(coststr) || 
+            !mDDPar->mCostLibraryMeasure)) continue;
         // insert to library
         pointCostLibrary.insert(std::pair<std::string, double>(coststr, -1.));
         // perform measurement only if it is new (measure = -1.)
         if (pointCostLibrary.at(coststr) < 0.) {
             // find how may steps are needed to use USER clock
+            Point *point = domain.getPoint(ip);
             double wall = point->measure(minStep);
             int nstep = std::max(minStep, (int)(clockResolution * clockFactor / 10. / wall) + 1);
             pointCostLibrary.at(coststr) = point->measure(nstep);
             // find points with the same signature
             int sameKindFound = 0;
             for (int jp = ip + 1; jp < ngll; jp++) {
-                Point *pointOther = domain.getPoint(jp);
-                if (pointOther->costSignature() == coststr) {
+                if (pointSignature[jp] == coststr) {
+                    Point *pointOther = domain.getPoint(jp);
                     pointCostLibrary.at(coststr) = std::min(pointOther->measure(nstep),
                         pointCostLibrary.at(coststr));
                     if (++sameKindFound == nMeasureSameKind) break;
@@ -449,11 +818,16 @@ void Mesh::measure(DecomposeOption &measured) {
                 pointCostLibraryGlobal.at(it->first));
         }
     }
+    // merge into persistent library and save
+    if (mCostLibrary) {
+        mCostLibrary->addPointCosts(pointCostLibraryGlobal);
+        if (elemCostLibraryGlobal.size() + pointCostLibraryGlobal.size() > 0) mCostLibrary->write();
+    }
     // read library
     for (int ip = 0; ip < ngll; ip++) {
-        Point *point = domain.getPoint(ip);
         // read library
-        double measure = pointCostLibraryGlobal.at(point->costSignature());
+        double measure = mCostLibrary ? mCostLibrary->getPointCost(pointSignature[ip]) : 
+            pointCostLibraryGlobal.at(pointSignature[ip]);
         // assign to point
         pWgt(ip) = measure / mGLLPoints[ip]->getReferenceCount();
     }
@@ -474,20 +848,12 @@ void Mesh::measure(DecomposeOption &measured) {
     XMPI::sumEigenDouble(eWgtPnt);
     XMPI::sumEigenInt(eCommSize);
     
-    // create option 
-    if (mDDPar->mBalanceEP) {
-        measured = DecomposeOption(nElemGlobal, true, 0., 0, mDDPar->mNPartMetis, mDDPar->mCommVolMetis);
-        for (int i = 0; i < nElemGlobal; i++) {
-            measured.mElemWeights1[i] = eWgtEle(i);
-            measured.mElemWeights2[i] = eWgtPnt(i);
-            measured.mElemCommSize[i] = eCommSize(i);
-        }
-    } else {
-        measured = DecomposeOption(nElemGlobal, false, 0., 0, mDDPar->mNPartMetis, mDDPar->mCommVolMetis);
-        for (int i = 0; i < nElemGlobal; i++) {
-            measured.mElemWeights1[i] = eWgtEle(i) + eWgtPnt(i);
-            measured.mElemCommSize[i] = eCommSize(i);
-        }
+    // create option with element and point weights kept apart
+    measured = DecomposeOption(nElemGlobal, true, 0., 0, mDDPar->mNPartMetis, mDDPar->mCommVolMetis);
+    for (int i = 0; i < nElemGlobal; i++) {
+        measured.mElemWeights1[i] = eWgtEle(i);
+        measured.mElemWeights2[i] = eWgtPnt(i);
+        measured.mElemCommSize[i] = eCommSize(i);
     }
     
     // report
@@ -517,16 +883,250 @@ void Mesh::measure(DecomposeOption &measured) {
 void Mesh::test() {
     // a temp Domain
     Domain domain;
-    release(domain);
+    release(domain, false);
     domain.test();
 }
 
+void Mesh::rehearse(int nstep, double &timeElem, double &timePoint, 
+    double &timeComm, double &timeStep) {
+    // a temp Domain
+    // NOTE: the rehearsal runs before the wavefield exists, so no point, element 
+    //       or attenuation state has to be migrated to the new owners
+    Domain domain;
+    release(domain, false);
+    domain.initDisplTinyRandom();
+    Real dt = getDeltaT();
+    
+    // rehearse time loop without source and stations
+    // each step starts synchronized; the barrier before the halo exchange 
+    // separates waiting for slower ranks from communication
+    XTimer::begin("Rehearse Time Loop", 2);
+    MyBoostTimer timerElem, timerPoint, timerComm, timerStep;
+    for (int tstep = 0; tstep < nstep; tstep++) {
+        XMPI::barrier();
+        timerStep.resume();
+        timerPoint.resume();
+        domain.updateNewmark(dt);
+        timerPoint.stop();
+        timerElem.resume();
+        domain.computeStiff();
+        timerElem.stop();
+        timerPoint.resume();
+        domain.coupleSolidFluid();
+        timerPoint.stop();
+        XMPI::barrier();
+        timerComm.resume();
+        domain.assembleStiff(-1);
+        domain.assembleStiff(1);
+        timerComm.stop();
+        timerStep.stop();
+    }
+    XMPI::barrier();
+    XTimer::end("Rehearse Time Loop", 2);
+    timeElem = timerElem.elapsed();
+    timePoint = timerPoint.elapsed();
+    timeComm = timerComm.elapsed();
+    timeStep = timerStep.elapsed();
+}
+
+DecomposeOption Mesh::formWeightedOption(const DecomposeOption &measured, 
+    bool balanceEP, bool commVol) const {
+    DecomposeOption option = measured;
+    option.mCommVol = commVol;
+    if (!balanceEP) {
+        option.mDoubleConstrants = false;
+        for (int i = 0; i < option.mElemWeights1.size(); i++) {
+            option.mElemWeights1[i] += option.mElemWeights2[i];
+            option.mElemWeights2[i] = 0.;
+        }
+    }
+    return option;
+}
+
+void Mesh::tune(const DecomposeOption &measured, bool &balanceEP, bool &commVol) {
+    std::stringstream ss;
+    ss << "# balance_element_point, comm_vol_metis, walltime, "
+        "predicted imbalance, measured imbalance, communication time" << std::endl;
+    ss << "# walltime: whole steps including halo exchange and waiting, max over ranks" << std::endl;
+    ss << "# measured imbalance: element + point + communication time, max / mean over ranks" << std::endl;
+    double wallBest = -1.;
+    for (int iEP = 0; iEP < 2; iEP++) {
+        for (int iVol = 0; iVol < 2; iVol++) {
+            // build candidate
+            const DecomposeOption &option = formWeightedOption(measured, iEP, iVol);
+            buildLocal(option);
+            
+            // trial run
+            double timeElem, timePoint, timeComm, timeStep;
+            rehearse(mDDPar->mTuneSteps, timeElem, timePoint, timeComm, timeStep);
+            double wallRank = timeStep;
+            double wall = XMPI::max(wallRank);
+            double workRank = timeElem + timePoint + timeComm;
+            
+            // imbalance = max / mean over ranks
+            double predictRank = 0.;
+            for (int iloc = 0; iloc < getNumQuads(); iloc++) {
+                int quadTag = mQuads[iloc]->getQuadTag();
+                predictRank += measured.mElemWeights1[quadTag] + measured.mElemWeights2[quadTag];
+            }
+            double predictImbalance = XMPI::max(predictRank) / 
+                (XMPI::sum(predictRank) / XMPI::nproc());
+            double measureImbalance = XMPI::max(workRank) / 
+                (XMPI::sum(workRank) / XMPI::nproc());
+            double comm = XMPI::max(timeComm);
+            ss << (iEP ? "true" : "false") << "   " << (iVol ? "true" : "false") << "   " 
+                << wall << "   " << predictImbalance << "   " << measureImbalance << "   " 
+                << comm << std::endl;
+            
+            // use the fastest
+            if (wallBest < 0. || wall < wallBest) {
+                wallBest = wall;
+                balanceEP = iEP;
+                commVol = iVol;
+            }
+        }
+    }
+    
+    // report
+    if (XMPI::root()) {
+        std::string fname = Parameters::sOutputDirectory + "/develop/decomposition_tuning.txt";
+        std::fstream fs(fname, std::fstream::out);
+        fs << ss.str();
+        fs << "# selected: " << (balanceEP ? "true" : "false") << "   " 
+            << (commVol ? "true" : "false") << std::endl;
+        fs.close();
+    }
+}
+
+void Mesh::rebalance(DecomposeOption &option) {
+    double measureElem, measurePoint, measureComm, measureStep;
+    rehearse(mDDPar->mRebalanceSteps, measureElem, measurePoint, measureComm, measureStep);
+    
+    // predicted costs of this rank
+    double predictElem = 0., predictPoint = 0.;
+    for (int iloc = 0; iloc < getNumQuads(); iloc++) {
+        int quadTag = mQuads[iloc]->getQuadTag();
+        predictElem += option.mElemWeights1[quadTag];
+        if (option.mDoubleConstrants) predictPoint += option.mElemWeights2[quadTag];
+    }
+    
+    // correction factors normalized by their mean over ranks, 
+    // so that ranks running slower than predicted receive less work
+    // the step time of this rank includes assembly and halo exchange, but not 
+    // idling for slower ranks, which would unload the fast ones;
+    // halo exchange scales with shared points, so it goes to the point phase
+    double factorElem = 1., factorPoint = 1.;
+    if (option.mDoubleConstrants) {
+        factorElem = predictElem > 0. ? measureElem / predictElem : 1.;
+        factorPoint = predictPoint > 0. ? (measurePoint + measureComm) / predictPoint : 1.;
+        factorElem /= XMPI::sum(factorElem) / XMPI::nproc();
+        factorPoint /= XMPI::sum(factorPoint) / XMPI::nproc();
+    } else {
+        double measureBusy = measureElem + measurePoint + measureComm;
+        factorElem = predictElem > 0. ? measureBusy / predictElem : 1.;
+        factorElem /= XMPI::sum(factorElem) / XMPI::nproc();
+    }
+    
+    // apply to local elements
+    int nElemGlobal = mExModel->getNumQuads();
+    std::vector<double> weights1(nElemGlobal, 0.);
+    std::vector<double> weights2(nElemGlobal, 0.);
+    for (int iloc = 0; iloc < getNumQuads(); iloc++) {
+        int quadTag = mQuads[iloc]->getQuadTag();
+        weights1[quadTag] = option.mElemWeights1[quadTag] * factorElem;
+        if (option.mDoubleConstrants) 
+            weights2[quadTag] = option.mElemWeights2[quadTag] * factorPoint;
+    }
+    XMPI::sumVector(weights1);
+    option.mElemWeights1 = weights1;
+    if (option.mDoubleConstrants) {
+        XMPI::sumVector(weights2);
+        option.mElemWeights2 = weights2;
+    }
+    
+    // report
+    std::stringstream ss;
+    ss << XMPI::rank() << "   " << measureElem << "   " << measurePoint << "   " 
+        << measureComm << "   " << measureStep << "   " 
+        << factorElem << "   " << factorPoint << std::endl;
+    std::vector<std::string> all_ss;
+    XMPI::gather(ss.str(), all_ss, false);
+    if (XMPI::root() && mDDPar->mReportMeasure) {
+        std::string fname = Parameters::sOutputDirectory + "/develop/rebalance_factors.txt";
+        std::fstream fs(fname, std::fstream::out);
+        fs << "# rank, element time, point time, communication time, step time, "
+            "element factor, point factor" << std::endl;
+        for (const auto &str: all_ss) fs << str;
+        fs.close();
+    }
+}
+
 Mesh::DDParameters::DDParameters(const Parameters &par) {
     mBalanceEP = par.getValue<bool>("DD_BALANCE_ELEMENT_POINT");
     mNPartMetis = par.getValue<int>("DD_NPART_METIS");
     mCommVolMetis = par.getValue<bool>("DD_COMM_VOL_METIS");
     mReportMeasure = par.getValue<bool>("DEVELOP_MEASURED_COSTS");
     if (mNPartMetis <= 0) mNPartMetis = 10;
+    mCachePartition = par.getValue<bool>("DD_CACHE_PARTITION");
+    mCacheDirectory = Parameters::sInputDirectory + "/" + 
+        par.getValue<std::string>("DD_CACHE_DIRECTORY");
+    mCostLibrary = par.getValue<bool>("DD_COST_LIBRARY");
+    mCostLibraryMeasure = par.getValue<bool>("DD_COST_LIBRARY_MEASURE");
+    mRebalanceSteps = par.getValue<int>("DD_REBALANCE_STEPS");
+    mTuneSteps = par.getValue<int>("DD_TUNE_STEPS");
+}
+
+void Mesh::formPartitionKey(PartitionCache &cache) const {
+    // NOTE: the source location is excluded on purpose so that a batch of events 
+    //       can share the same partition. A cached partition only affects 
+    //       load balance but never the results.
+    // build and decomposition settings
+    cache.addToKey(XMPI::nproc());
+    cache.addToKey(nPol);
+    cache.addToKey(sizeof(Real));
+    cache.addToKey(mDDPar->mBalanceEP);
+    cache.addToKey(mDDPar->mNPartMetis);
+    cache.addToKey(mDDPar->mCommVolMetis);
+    cache.addToKey(mDDPar->mRebalanceSteps);
+    cache.addToKey(mDDPar->mTuneSteps);
+    cache.addToKey(mUse2D);
+    if (mCostLibrary) {
+        cache.addToKey(mCostLibrary->getMachineKey());
+        cache.addToKey(mCostLibrary->contentSignature());
+    }
+    
+    // exodus mesh
+    int nnode = mExModel->getNumNodes();
+    int nquad = mExModel->getNumQuads();
+    cache.addToKey(nnode);
+    cache.addToKey(nquad);
+    for (int i = 0; i < nnode; i++) {
+        cache.addToKey(mExModel->getNodalS(i));
+        cache.addToKey(mExModel->getNodalZ(i));
+    }
+    const SharedArray<std::array<int, 4>> &con = mExModel->getConnectivity();
+    const SharedArray<double> &fluid = mExModel->getElementalVariables().at("fluid");
+    cache.addToKey(con.data(), con.size() * sizeof(std::array<int, 4>));
+    cache.addToKey(fluid.data(), fluid.size() * sizeof(double));
+    
+    // nr field sampled at nodes and element centers
+    cache.addToKey(mNrField->verbose());
+    RDCol2 sz;
+    for (int i = 0; i < nnode; i++) {
+        sz << mExModel->getNodalS(i), mExModel->getNodalZ(i);
+        cache.addToKey(mNrField->getNrAtPoint(sz));
+    }
+    for (int i = 0; i < nquad; i++) {
+        sz.setZero();
+        for (int j = 0; j < 4; j++) 
+            sz += (RDCol2() << mExModel->getNodalS(con[i][j]), mExModel->getNodalZ(con[i][j])).finished();
+        cache.addToKey(mNrField->getNrAtPoint(sz / 4.));
+    }
+    
+    // 3D models
+    for (const auto &m3D: mVolumetric3D) cache.addToKey(m3D->verbose());
+    for (const auto &g3D: mGeometric3D) cache.addToKey(g3D->verbose());
+    if (mOceanLoad3D) cache.addToKey(mOceanLoad3D->verbose());
 }
 
 int Mesh::getMaxNr() const {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <vector>
+#include <map>
 #include "eigenp.h"
 
 class Parameters;
@@ -22,6 +23,9 @@ struct DecomposeOption;
 struct MessagingInfo;
 struct LearnParameters;
 class SlicePlot;
+class PartitionCache;
+class CostLibrary;
+class QuadIndex;
 
 class Mesh {
     friend class SlicePlot;
@@ -46,7 +50,9 @@ public:
     void buildWeighted();
     
     // step 5: release to domain 
-    void release(Domain &domain);    
+    // in streaming mode, preloop arrays are freed during release,
+    // and only geometry remains available for locating source and receivers
+    void release(Domain &domain) {release(domain, mStreamRelease);};
     
     // optional step: test stiffness and mass
     void test();
@@ -60,12 +66,22 @@ public:
     double computeRadiusRef(double depth, double lat, double lon) const;
     double computeRPhysical(double r, double theta, double phi) const;
     
+    // batch version of computeRadiusRef, one location per row
+    void computeRadiusRef(const RDColX &depth, const RDColX &lat, const RDColX &lon, 
+        RDColX &radius) const;
+    // batch version of computeRPhysical, with radial derivative
+    void computeRPhysical(const RDColX &r, const RDColX &theta, const RDColX &phi, 
+        RDColX &rPhys, RDColX &rPhys_r) const;
+    
     // get spatial ranges
     double sMax() const {return mSMax;};
     double sMin() const {return mSMin;};
     double zMax() const {return mZMax;};
     double zMin() const {return mZMin;};
     
+    // local indices of Quads near (s, z), in ascending order
+    void findQuads(double s, double z, std::vector<int> &locs) const;
+    
     // get max. Nr to initialize solver
     int getMaxNr() const;
     
@@ -73,6 +89,19 @@ private:
     
     // build local
     void buildLocal(const DecomposeOption &option);
+    void buildLocal(const IColX &elemToProc);
+    
+    // move Quads of existent build to their new owners
+    void migrateQuads(const IColX &elemToProc, std::map<int, Quad *> &quads);
+    
+    // group local Quads such that Quads in a group share no GLL point
+    void colorQuads(int nGllLocal, std::vector<std::vector<int>> &colors) const;
+    
+    // release to domain, freeing preloop arrays on the fly if streaming
+    void release(Domain &domain, bool streaming);
+    
+    // key of partition cache
+    void formPartitionKey(PartitionCache &cache) const;
     
     // destroy local
     void destroy();
@@ -80,6 +109,22 @@ private:
     // measure
     void measure(DecomposeOption &measured);
     
+    // time a rehearsal time loop on this rank
+    // timeElem, timePoint, timeComm: element, point and halo-exchange phases
+    // timeStep: whole steps, including waiting for other ranks
+    void rehearse(int nstep, double &timeElem, double &timePoint, 
+        double &timeComm, double &timeStep);
+    
+    // weighted option from measured element and point weights
+    DecomposeOption formWeightedOption(const DecomposeOption &measured, 
+        bool balanceEP, bool commVol) const;
+    
+    // select decomposition options by trial runs
+    void tune(const DecomposeOption &measured, bool &balanceEP, bool &commVol);
+    
+    // correct measured weights by a rehearsal of the time loop
+    void rebalance(DecomposeOption &option);
+    
 private:
     
     /////////////////////// global properties ///////////////////////
@@ -117,12 +162,18 @@ private:
     // message info
     MessagingInfo *mMsgInfo;
     
+    // element-to-processor partition of local build
+    IColX mElemToProc;
+    
     // spatial ranges
     double mSMax;
     double mSMin;
     double mZMax;
     double mZMin;
     
+    // spatial index of Quads
+    QuadIndex *mQuadIndex;
+    
     ////////////////// domain decomposition //////////////////
     struct DDParameters {
         DDParameters(const Parameters &par);
@@ -130,11 +181,28 @@ private:
         int mNPartMetis;
         bool mCommVolMetis;
         bool mReportMeasure;
+        bool mCachePartition;
+        std::string mCacheDirectory;
+        bool mCostLibrary;
+        bool mCostLibraryMeasure;
+        int mRebalanceSteps;
+        int mTuneSteps;
     } *mDDPar;
     
+    // partition cache, non-null only if caching or tuning is enabled
+    PartitionCache *mPartitionCache;
+    // weighted partition read from cache
+    bool mPartitionFromCache;
+    
+    // persistent cost library, non-null only if enabled
+    CostLibrary *mCostLibrary;
+    
     ////////////////// wisdom learning //////////////////
     LearnParameters *mLearnPar;
     
+    ////////////////// streaming release //////////////////
+    bool mStreamRelease;
+    
     ////////////////// 2D in-plane mode //////////////////
     bool mUse2D;
     double mPhi2D;
@@ -166,15 +166,21 @@ Quad::~Quad() {
 
 void Quad::addVolumetric3D(const Volumetric3D &m3D, double srcLat, double srcLon, double srcDep, double phi2D) {
     if (isFluid()) return;
-    mMaterial->addVolumetric3D(m3D, srcLat, srcLon, srcDep, phi2D);
+    formGeocentric(srcLat, srcLon, srcDep, phi2D);
+    mMaterial->addVolumetric3D(m3D);
 }
 
 void Quad::addGeometric3D(const Geometric3D &g3D, double srcLat, double srcLon, double srcDep, double phi2D) {
-    mRelabelling->addUndulation(g3D, srcLat, srcLon, srcDep, phi2D);
+    formGeocentric(srcLat, srcLon, srcDep, phi2D);
+    mRelabelling->addUndulation(g3D);
 }
 
 void Quad::setOceanLoad3D(const OceanLoad3D &o3D, double srcLat, double srcLon, double srcDep, double phi2D) {
     if (!mOnSurface) return;
+    formGeocentric(srcLat, srcLon, srcDep, phi2D);
+    // gather surface points for a batch query
+    std::vector<int> surfacePoints;
+    int nrow = 0;
     for (int ipol = 0; ipol <= nPol; ipol++) {
         for (int jpol = 0; jpol <= nPol; jpol++) {
             bool surface = mOnSurface && (
@@ -183,31 +189,54 @@ void Quad::setOceanLoad3D(const OceanLoad3D &o3D, double srcLat, double srcLon,
                 (mSurfaceSide == 2 && jpol == nPol) ||
                 (mSurfaceSide == 3 && ipol == 0));
             if (surface) {
-                int nr_read = getPointNr(ipol, jpol);
-                int ipnt = ipol * nPntEdge + jpol;
-                const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, mIsAxial);
-                const RDMatX3 &rtpS = computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, nr_read, phi2D);
-                for (int alpha = 0; alpha < nr_read; alpha++) {
-                    double t = rtpS(alpha, 1);
-                    double p = rtpS(alpha, 2);
-                    mOceanDepth[ipnt](alpha) = o3D.getOceanDepth(t, p); 
-                }
+                surfacePoints.push_back(ipol * nPntEdge + jpol);
+                nrow += getPointNr(ipol, jpol);
             }    
         }
     }
+    RDMatX3 rtp(nrow, 3);
+    int row = 0;
+    for (int ipnt: surfacePoints) {
+        int nr_read = mOceanDepth[ipnt].rows();
+        rtp.block(row, 0, nr_read, 3) = mGeocentricMass.block(mGeocentricMassRow(ipnt), 0, nr_read, 3);
+        row += nr_read;
+    }
+    RDColX depth;
+    o3D.getOceanDepthBatch(rtp, depth);
+    row = 0;
+    for (int ipnt: surfacePoints) {
+        int nr_read = mOceanDepth[ipnt].rows();
+        mOceanDepth[ipnt] = depth.segment(row, nr_read);
+        row += nr_read;
+    }
 }
 
 void Quad::finishModel3D() {
+    freeGeocentric();
     if (stiffRelabelling()) mRelabelling->finishUndulation();
     // debug relabelling
     // testRelabelling();
 }
 
+void Quad::packModel3D(std::vector<double> &buffer) const {
+    mMaterial->packModel3D(buffer);
+    mRelabelling->packUndulation(buffer);
+    for (int ipnt = 0; ipnt < nPE; ipnt++) XMath::pack(mOceanDepth[ipnt], buffer);
+}
+
+void Quad::unpackModel3D(const RDColX &buffer, int &pos) {
+    mMaterial->unpackModel3D(buffer, pos);
+    mRelabelling->unpackUndulation(buffer, pos);
+    for (int ipnt = 0; ipnt < nPE; ipnt++) XMath::unpack(mOceanDepth[ipnt], buffer, pos);
+}
+
 bool Quad::massRelabelling() const {
+    if (!mRelabelling) return mMassRelabelling;
     return !mRelabelling->isZeroMass();
 }
 
 bool Quad::stiffRelabelling() const {
+    if (!mRelabelling) return mStiffRelabelling;
     return !mRelabelling->isZeroStiff();
 }
 
@@ -325,6 +354,28 @@ int Quad::releaseFluid(Domain &domain, const IMatPP &myPointTags) const {
     return domain.addElement(elem);
 }
 
+std::string Quad::costSignature(const AttBuilder *attBuild) const {
+    int maxNr = -1;
+    for (int ipol = 0; ipol <= nPol; ipol++) 
+        for (int jpol = 0; jpol <= nPol; jpol++) 
+            maxNr = std::max(maxNr, mPointNr(ipol, jpol));
+    std::stringstream ss;
+    ss << mMaterial->verboseElement(attBuild) << "$DimAzimuth=" << maxNr << "$Axial=" << (mIsAxial ? "T" : "F");
+    return ss.str();
+}
+
+void Quad::freeAfterRelease(bool keepRelabelling) {
+    delete mMaterial;
+    mMaterial = 0;
+    if (!keepRelabelling) {
+        mMassRelabelling = massRelabelling();
+        mStiffRelabelling = stiffRelabelling();
+        delete mRelabelling;
+        mRelabelling = 0;
+    }
+    for (int ipnt = 0; ipnt < nPE; ipnt++) mOceanDepth[ipnt].resize(0);
+}
+
 RDCol2 Quad::mapping(const RDCol2 &xieta) const {
     return mMapping->mapping(mNodalCoords, xieta, mCurvedOuter);
 }
@@ -371,17 +422,61 @@ RDRow4 Quad::computeWeightsCG4() const {
 
 RDMatX3 Quad::computeGeocentricGlobal(double srcLat, double srcLon, double srcDep,
     const RDCol2 &xieta, int npnt, double phi2D) const {
-    RDMatX3 rtpG_Nr(npnt, 3);
-    RDCol3 rtpS;
-    XMath::rtheta(mapping(xieta), rtpS(0), rtpS(1));
+    RDMatX3 rtpS_Nr(npnt, 3);
+    double r, theta;
+    XMath::rtheta(mapping(xieta), r, theta);
     // debug relabelling
-    // rtpS(1) = XMath::theta(mapping(RDCol2::Zero()));
+    // theta = XMath::theta(mapping(RDCol2::Zero()));
     double dphi = 2. * pi / npnt;
     for (int i = 0; i < npnt; i++) {
-        rtpS(2) = phi2D < 0. ? dphi * i : phi2D;
-        rtpG_Nr.row(i) = XMath::rotateSrc2Glob(rtpS, srcLat, srcLon, srcDep).transpose();
+        rtpS_Nr(i, 0) = r;
+        rtpS_Nr(i, 1) = theta;
+        rtpS_Nr(i, 2) = phi2D < 0. ? dphi * i : phi2D;
+    }
+    return XMath::rotateSrc2GlobBatch(rtpS_Nr, srcLat, srcLon, srcDep);
+}
+
+void Quad::formGeocentric(double srcLat, double srcLon, double srcDep, double phi2D) {
+    // formed by a previous 3D model
+    if (mGeocentricStiff.rows() > 0) return;
+    mGeocentricRing = phi2D < 0.;
+    mGeocentricMassRow = IColX::Zero(nPntElem + 1);
+    for (int ipol = 0; ipol <= nPol; ipol++) {
+        for (int jpol = 0; jpol <= nPol; jpol++) {
+            int ipnt = ipol * nPntEdge + jpol;
+            mGeocentricMassRow(ipnt + 1) = mGeocentricMassRow(ipnt) + mPointNr(ipol, jpol);
+        }
     }
-    return rtpG_Nr;
+    mGeocentricStiff = RDMatX3(mNr * nPntElem, 3);
+    mGeocentricMass = RDMatX3(mGeocentricMassRow(nPntElem), 3);
+    for (int ipol = 0; ipol <= nPol; ipol++) {
+        for (int jpol = 0; jpol <= nPol; jpol++) {
+            int ipnt = ipol * nPntEdge + jpol;
+            int nrP = mPointNr(ipol, jpol);
+            const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, mIsAxial);
+            mGeocentricStiff.block(ipnt * mNr, 0, mNr, 3) = 
+                computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, mNr, phi2D);
+            if (nrP == mNr) 
+                mGeocentricMass.block(mGeocentricMassRow(ipnt), 0, nrP, 3) = 
+                    mGeocentricStiff.block(ipnt * mNr, 0, mNr, 3);
+            else 
+                mGeocentricMass.block(mGeocentricMassRow(ipnt), 0, nrP, 3) = 
+                    computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, nrP, phi2D);
+        }
+    }
+}
+
+bool Quad::getSourceRing(int ipnt, double &r, double &theta) const {
+    if (!mGeocentricRing) return false;
+    const RDCol2 &xieta = SpectralConstants::getXiEta(ipnt / nPntEdge, ipnt % nPntEdge, mIsAxial);
+    XMath::rtheta(mapping(xieta), r, theta);
+    return true;
+}
+
+void Quad::freeGeocentric() {
+    mGeocentricStiff.resize(0, 3);
+    mGeocentricMass.resize(0, 3);
+    mGeocentricMassRow.resize(0);
 }
 
 double Quad::computeCenterRadius() const {
@@ -34,6 +34,10 @@ public:
     void addGeometric3D(const Geometric3D &g3D, double srcLat, double srcLon, double srcDep, double phi2D);
     void setOceanLoad3D(const OceanLoad3D &o3D, double srcLat, double srcLon, double srcDep, double phi2D);
     void finishModel3D();
+    // evaluated 3D models in a flat buffer, for migration between procs
+    // unpack replaces add* and finishModel3D on a Quad built from Exodus
+    void packModel3D(std::vector<double> &buffer) const;
+    void unpackModel3D(const RDColX &buffer, int &pos);
     bool massRelabelling() const;
     bool stiffRelabelling() const;
     
@@ -48,6 +52,13 @@ public:
     int releaseSolid(Domain &domain, const IMatPP &myPointTags, const AttBuilder *attBuild) const;
     int releaseFluid(Domain &domain, const IMatPP &myPointTags) const;
     
+    // cost signature of the element to be released, as in Element::costSignature
+    std::string costSignature(const AttBuilder *attBuild) const;
+    
+    // free preloop arrays once released; only geometry and relabelling flags 
+    // remain valid, plus relabelling if kept (needed by source in axial solid Quads)
+    void freeAfterRelease(bool keepRelabelling);
+    
     // mapping interfaces
     RDCol2 mapping(const RDCol2 &xieta) const;
     RDMat22 jacobian(const RDCol2 &xieta) const;
@@ -62,6 +73,16 @@ public:
         const RDCol2 &xieta, int npnt, double phi2D) const;
     double computeCenterRadius() const;
     
+    // geocentric coordinates of all slices, cached across 3D models until finishModel3D
+    // stiffness: row = ipnt * Nr + alpha
+    // mass: row = getGeocentricMassRow(ipnt) + alpha, with point Nr slices
+    const RDMatX3 &getGeocentricStiff() const {return mGeocentricStiff;};
+    const RDMatX3 &getGeocentricMass() const {return mGeocentricMass;};
+    int getGeocentricMassRow(int ipnt) const {return mGeocentricMassRow(ipnt);};
+    // source-centered r/theta of a point whose slices form a full ring in phi
+    // RETURN: false if slices are not a ring, i.e., in 2D mode
+    bool getSourceRing(int ipnt, double &r, double &theta) const;
+    
     // get properties
     int getQuadTag() const {return mQuadTag;};
     int getElementTag() const {return mElementTag;};
@@ -70,6 +91,7 @@ public:
     bool isAxial() const {return mIsAxial;};
     bool onSFBoundary() const {return mOnSFBoundary;};
     bool onSurface() const {return mOnSurface;};
+    int getSurfaceSide() const {return mSurfaceSide;};
     int getNr() const {return mNr;}
     int getNu() const {return mNr / 2;}
     const int &getPointNr(int ipol, int jpol) const {return mPointNr(ipol, jpol);};
@@ -115,6 +137,10 @@ protected:
     // compute normal
     RDMatX3 computeNormal(int side, int ipol, int jpol) const;
     
+    // form and free geocentric coordinates of 3D models
+    void formGeocentric(double srcLat, double srcLon, double srcDep, double phi2D);
+    void freeGeocentric();
+    
     ////////////////////////////////////////////////// Nodal level
     // quad tag in Exodus
     int mQuadTag;
@@ -156,9 +182,18 @@ protected:
     
     // particle relabelling
     Relabelling *mRelabelling;
+    // relabelling flags, valid after relabelling is freed
+    bool mMassRelabelling = false;
+    bool mStiffRelabelling = false;
     
     // Ocean depth
     arPP_RDColX mOceanDepth;
+    
+    // geocentric coordinates of 3D models
+    RDMatX3 mGeocentricStiff;
+    RDMatX3 mGeocentricMass;
+    IColX mGeocentricMassRow;
+    bool mGeocentricRing;
 };
 
 
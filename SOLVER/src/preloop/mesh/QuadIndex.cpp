@@ -0,0 +1,34 @@
+// QuadIndex.cpp
+// created by agent on 19-Oct-2026
+// spatial index of local Quads for locating points
+
+#include "QuadIndex.h"
+#include "Quad.h"
+#include <algorithm>
+
+namespace bgi = boost::geometry::index;
+
+QuadIndex::QuadIndex(const std::vector<Quad *> &quads) {
+    std::vector<QuadIndexValue> values;
+    values.reserve(quads.size());
+    double s_max, s_min, z_max, z_min;
+    for (int iloc = 0; iloc < quads.size(); iloc++) {
+        quads[iloc]->getSpatialRange(s_max, s_min, z_max, z_min);
+        // padded as in Quad::nearMe
+        QuadIndexBox box(QuadIndexPoint(s_min - tinySingle, z_min - tinySingle), 
+            QuadIndexPoint(s_max + tinySingle, z_max + tinySingle));
+        values.push_back(std::make_pair(box, iloc));
+    }
+    // packing algorithm
+    mRTree = bgi::rtree<QuadIndexValue, bgi::quadratic<16>>(values.begin(), values.end());
+}
+
+void QuadIndex::query(double s, double z, std::vector<int> &locs) const {
+    std::vector<QuadIndexValue> found;
+    mRTree.query(bgi::covers(QuadIndexPoint(s, z)), std::back_inserter(found));
+    locs.clear();
+    for (const auto &value: found) locs.push_back(value.second);
+    // keep the order of a linear scan
+    std::sort(locs.begin(), locs.end());
+}
+
@@ -0,0 +1,32 @@
+// QuadIndex.h
+// created by agent on 19-Oct-2026
+// spatial index of local Quads for locating points
+
+#pragma once
+
+#include <vector>
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+class Quad;
+
+typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> QuadIndexPoint;
+typedef boost::geometry::model::box<QuadIndexPoint> QuadIndexBox;
+typedef std::pair<QuadIndexBox, int> QuadIndexValue;
+
+class QuadIndex {
+public:
+    // bulk-loaded from bounding boxes of Quads
+    QuadIndex(const std::vector<Quad *> &quads);
+    
+    // local indices of Quads near (s, z), in ascending order, 
+    // same criterion as Quad::nearMe
+    void query(double s, double z, std::vector<int> &locs) const;
+    
+private:
+    // rtree
+    boost::geometry::index::rtree<QuadIndexValue, boost::geometry::index::quadratic<16>> mRTree;
+};
+
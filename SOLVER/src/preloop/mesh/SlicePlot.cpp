@@ -226,8 +226,12 @@ void SlicePlot::plotRank(bool weighted) const {
     }
 }
 
+bool SlicePlot::plotsEleType() const {
+    return boost::iequals(mParName, "eleType");
+}
+
 void SlicePlot::plotEleType(const Domain &domain) const {
-    if (!boost::iequals(mParName, "eleType")) return;
+    if (!plotsEleType()) return;
     
     // data size
     int nrow = mMesh->mExModel->getNumQuads();
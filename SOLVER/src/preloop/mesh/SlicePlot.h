@@ -23,6 +23,9 @@ public:
     void plotWeighted() const;
     void plotEleType(const Domain &domain) const;
     void plotMeasured(const RDColX &cost) const;
+    
+    // whether plotEleType needs a released domain
+    bool plotsEleType() const;
         
     // build from input parameters
     static void buildInparam(std::vector<SlicePlot *> &splots, 
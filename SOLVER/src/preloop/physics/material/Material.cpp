@@ -81,17 +81,81 @@ Material::Material(const Quad *myQuad, const ExodusModel &exModel): mMyQuad(myQu
     }
 }
 
-void Material::addVolumetric3D(const Volumetric3D &m3D, double srcLat, double srcLon, double srcDep, double phi2D) {
+namespace {
+    // apply a 3D model value to a property
+    inline void applyVolumetric3D(Volumetric3D::ReferenceTypes type, 
+        double &value, double ref, double value3D) {
+        if (type == Volumetric3D::ReferenceTypes::Absolute) {
+            value = value3D;
+        } else if (type == Volumetric3D::ReferenceTypes::Reference1D) {
+            value = ref * (1. + value3D);
+        } else if (type == Volumetric3D::ReferenceTypes::Reference3D) {
+            value *= 1. + value3D;
+        } else {
+            value = (value - ref) * (1. + value3D) + ref;
+        }
+    }
+    
+    // read a 3D model on the slices of each point, rows rowStart(ipnt) to rowStart(ipnt + 1) - 1 
+    // points are synthesized ring by ring if the model supports it, otherwise all rows 
+    // are read in one batch
+    void readVolumetric3D(const Volumetric3D &m3D, const Quad &quad, 
+        const RDMatX3 &rtp, const IColX &rowStart, double rElemCenter,
+        RDMatX5 &prop, IColX &inRange) {
+        prop.resize(rtp.rows(), 5);
+        inRange.resize(rtp.rows());
+        RDMatX5 propRing;
+        IColX inRangeRing;
+        for (int ipnt = 0; ipnt < nPntElem; ipnt++) {
+            int nr = rowStart(ipnt + 1) - rowStart(ipnt);
+            if (nr == 0) continue;
+            double r, theta;
+            if (!quad.getSourceRing(ipnt, r, theta) || 
+                !m3D.get3dPropertiesRing(r, theta, nr, rElemCenter, propRing, inRangeRing)) {
+                m3D.get3dPropertiesBatch(rtp, RDColX::Constant(rtp.rows(), rElemCenter), prop, inRange);
+                return;
+            }
+            prop.block(rowStart(ipnt), 0, nr, 5) = propRing;
+            inRange.segment(rowStart(ipnt), nr) = inRangeRing;
+        }
+    }
+}
+
+void Material::addVolumetric3D(const Volumetric3D &m3D) {
+    Volumetric3D::ReferenceTypes type = m3D.getReferenceType();
+    
     // radius at element center 
     double rElemCenter = mMyQuad->computeCenterRadius();
     
-    // read 3D model
+    // read 3D model on all slices of all points at once
     int Nr = mMyQuad->getNr();
+    const RDMatX3 &rtp = mMyQuad->getGeocentricStiff();
+    IColX stiffRow(nPntElem + 1);
+    for (int ipnt = 0; ipnt <= nPntElem; ipnt++) stiffRow(ipnt) = ipnt * Nr;
+    RDMatX5 prop;
+    IColX inRange;
+    readVolumetric3D(m3D, *mMyQuad, rtp, stiffRow, rElemCenter, prop, inRange);
+    
+    // mass is sampled on the same slices unless point Nr differs
+    const RDMatX3 &rtpMassAll = mMyQuad->getGeocentricMass();
+    IColX massRow = IColX::Zero(nPntElem + 1);
+    for (int ipnt = 0; ipnt < nPntElem; ipnt++) {
+        int NrP = mRhoMass3D[ipnt].rows();
+        massRow(ipnt + 1) = massRow(ipnt) + (NrP == Nr ? 0 : NrP);
+    }
+    RDMatX3 rtpMass(massRow(nPntElem), 3);
+    for (int ipnt = 0; ipnt < nPntElem; ipnt++) {
+        int NrP = massRow(ipnt + 1) - massRow(ipnt);
+        if (NrP > 0) rtpMass.block(massRow(ipnt), 0, NrP, 3) = 
+            rtpMassAll.block(mMyQuad->getGeocentricMassRow(ipnt), 0, NrP, 3);
+    }
+    RDMatX5 propMass;
+    IColX inRangeMass;
+    readVolumetric3D(m3D, *mMyQuad, rtpMass, massRow, rElemCenter, propMass, inRangeMass);
+    
     for (int ipol = 0; ipol <= nPol; ipol++) {
         for (int jpol = 0; jpol <= nPol; jpol++) {
             const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, mMyQuad->isAxial());
-            // geographic oordinates of cardinal points
-            const RDMatX3 &rtp = mMyQuad->computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, Nr, phi2D);
             // 1D reference values
             double vpv_ref = Mapping::interpolate(mVpv1D, xieta);
             double vph_ref = Mapping::interpolate(mVph1D, xieta);
@@ -100,58 +164,47 @@ void Material::addVolumetric3D(const Volumetric3D &m3D, double srcLat, double sr
             double rho_ref = Mapping::interpolate(mRho1D, xieta);
             int ipnt = ipol * nPntEdge + jpol;
             for (int alpha = 0; alpha < Nr; alpha++) {
-                double dvpv, dvph, dvsv, dvsh, drho;
-                if (m3D.get3dProperties(rtp(alpha, 0), rtp(alpha, 1), rtp(alpha, 2), rElemCenter,
-                        dvpv, dvph, dvsv, dvsh, drho)) {
-                    if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Absolute) {
-                        mVpv3D(alpha, ipnt) = dvpv;
-                        mVph3D(alpha, ipnt) = dvph;
-                        mVsv3D(alpha, ipnt) = dvsv;
-                        mVsh3D(alpha, ipnt) = dvsh;
-                        mRho3D(alpha, ipnt) = drho;
-                    } else if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Reference1D) {
-                        mVpv3D(alpha, ipnt) = vpv_ref * (1. + dvpv);
-                        mVph3D(alpha, ipnt) = vph_ref * (1. + dvph);
-                        mVsv3D(alpha, ipnt) = vsv_ref * (1. + dvsv);
-                        mVsh3D(alpha, ipnt) = vsh_ref * (1. + dvsh);
-                        mRho3D(alpha, ipnt) = rho_ref * (1. + drho);
-                    } else if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Reference3D) {
-                        mVpv3D(alpha, ipnt) *= 1. + dvpv;
-                        mVph3D(alpha, ipnt) *= 1. + dvph;
-                        mVsv3D(alpha, ipnt) *= 1. + dvsv;
-                        mVsh3D(alpha, ipnt) *= 1. + dvsh;
-                        mRho3D(alpha, ipnt) *= 1. + drho;
-                    } else {
-                        mVpv3D(alpha, ipnt) = (mVpv3D(alpha, ipnt) - vpv_ref) * (1. + dvpv) + vpv_ref;
-                        mVph3D(alpha, ipnt) = (mVph3D(alpha, ipnt) - vph_ref) * (1. + dvph) + vph_ref;
-                        mVsv3D(alpha, ipnt) = (mVsv3D(alpha, ipnt) - vsv_ref) * (1. + dvsv) + vsv_ref;
-                        mVsh3D(alpha, ipnt) = (mVsh3D(alpha, ipnt) - vsh_ref) * (1. + dvsh) + vsh_ref;
-                        mRho3D(alpha, ipnt) = (mRho3D(alpha, ipnt) - rho_ref) * (1. + drho) + rho_ref;
-                    }
-                } 
+                int row = ipnt * Nr + alpha;
+                if (inRange(row)) {
+                    applyVolumetric3D(type, mVpv3D(alpha, ipnt), vpv_ref, prop(row, 0));
+                    applyVolumetric3D(type, mVph3D(alpha, ipnt), vph_ref, prop(row, 1));
+                    applyVolumetric3D(type, mVsv3D(alpha, ipnt), vsv_ref, prop(row, 2));
+                    applyVolumetric3D(type, mVsh3D(alpha, ipnt), vsh_ref, prop(row, 3));
+                    applyVolumetric3D(type, mRho3D(alpha, ipnt), rho_ref, prop(row, 4));
+                }
             }
             // rho for mass
-            int NrP = mMyQuad->getPointNr(ipol, jpol);
-            const RDMatX3 &rtpM = mMyQuad->computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, NrP, phi2D);
+            int NrP = mRhoMass3D[ipnt].rows();
             for (int alpha = 0; alpha < NrP; alpha++) {
-                double dvpv, dvph, dvsv, dvsh, drho;
-                if (m3D.get3dProperties(rtpM(alpha, 0), rtpM(alpha, 1), rtpM(alpha, 2), rElemCenter,
-                        dvpv, dvph, dvsv, dvsh, drho)) {
-                    if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Absolute) {
-                        mRhoMass3D[ipnt](alpha) = drho;
-                    } else if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Reference1D) {
-                        mRhoMass3D[ipnt](alpha) = rho_ref * (1. + drho);
-                    } else if (m3D.getReferenceType() == Volumetric3D::ReferenceTypes::Reference3D) {
-                        mRhoMass3D[ipnt](alpha) *= 1. + drho;
-                    } else {
-                        mRhoMass3D[ipnt](alpha) = (mRhoMass3D[ipnt](alpha) - vpv_ref) * (1. + drho) + rho_ref;
-                    }
+                bool sameSlices = NrP == Nr;
+                int row = sameSlices ? ipnt * Nr + alpha : massRow(ipnt) + alpha;
+                if (sameSlices ? inRange(row) : inRangeMass(row)) {
+                    double drho = sameSlices ? prop(row, 4) : propMass(row, 4);
+                    applyVolumetric3D(type, mRhoMass3D[ipnt](alpha), rho_ref, drho);
                 }
             }
         }
     }
 }
 
+void Material::packModel3D(std::vector<double> &buffer) const {
+    XMath::pack(mVpv3D, buffer);
+    XMath::pack(mVph3D, buffer);
+    XMath::pack(mVsv3D, buffer);
+    XMath::pack(mVsh3D, buffer);
+    XMath::pack(mRho3D, buffer);
+    for (int ipnt = 0; ipnt < nPE; ipnt++) XMath::pack(mRhoMass3D[ipnt], buffer);
+}
+
+void Material::unpackModel3D(const RDColX &buffer, int &pos) {
+    XMath::unpack(mVpv3D, buffer, pos);
+    XMath::unpack(mVph3D, buffer, pos);
+    XMath::unpack(mVsv3D, buffer, pos);
+    XMath::unpack(mVsh3D, buffer, pos);
+    XMath::unpack(mRho3D, buffer, pos);
+    for (int ipnt = 0; ipnt < nPE; ipnt++) XMath::unpack(mRhoMass3D[ipnt], buffer, pos);
+}
+
 arPP_RDColX Material::computeElementalMass() const {
     arPP_RDColX mass, J;
     // Jacobian of topography
@@ -217,6 +270,20 @@ Elastic *Material::createElastic(const AttBuilder *attBuild) const {
     }
 }
 
+std::string Material::verboseElement(const AttBuilder *attBuild) const {
+    // same choices as createAcoustic and createElastic
+    bool relabel = mMyQuad->stiffRelabelling();
+    if (mMyQuad->isFluid()) 
+        return std::string("FluidElement$") + (relabel ? "Acoustic3X" : "Acoustic1D") + "$NoAttenuation";
+    bool elastic1D = isStiffness1D() && !relabel;
+    std::string elastic = isIsotropic() ? "Isotropic" : "TransverselyIsotropic";
+    elastic += elastic1D ? "1D" : (relabel ? "3X" : "3D");
+    std::string att = "NoAttenuation";
+    if (attBuild) 
+        att = std::string(elastic1D ? "Attenuation1D" : "Attenuation3D") + (attBuild->useCG4() ? "_CG4" : "_Full");
+    return "SolidElement$" + elastic + "$" + att;
+}
+
 double Material::getVMaxRef() const {
     return std::max(mVph1D.maxCoeff(), mVpv1D.maxCoeff());
 }
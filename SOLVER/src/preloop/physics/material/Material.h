@@ -22,8 +22,13 @@ public:
     Material(const Quad *myQuad, const ExodusModel &exModel);
     
     // add 3D
-    void addVolumetric3D(const Volumetric3D &m3D, double srcLat, double srcLon, double srcDep, double phi2D);
+    // on geocentric coordinates cached by Quad
+    void addVolumetric3D(const Volumetric3D &m3D);
         
+    // 3D properties in a flat buffer, for migration between procs
+    void packModel3D(std::vector<double> &buffer) const;
+    void unpackModel3D(const RDColX &buffer, int &pos);
+    
     // Mass
     arPP_RDColX computeElementalMass() const;
     
@@ -32,6 +37,10 @@ public:
     
     // Elastic
     Elastic *createElastic(const AttBuilder *attBuild) const;
+    
+    // class names of the element to be created, as in Element::verbose 
+    // and Element::verboseAttenuation, without creating it
+    std::string verboseElement(const AttBuilder *attBuild) const;
         
     // get v_max to compute dt 
     double getVMaxRef() const;
@@ -50,22 +50,14 @@ bool Relabelling::isZeroMass() const {
     return true;
 }
 
-void Relabelling::addUndulation(const Geometric3D &g3D, double srcLat, double srcLon, double srcDep, double phi2D) {
+void Relabelling::addUndulation(const Geometric3D &g3D) {
     double rElemCenter = mMyQuad->computeCenterRadius();
     int Nr = mMyQuad->getNr();
-    for (int ipol = 0; ipol <= nPol; ipol++) {
-        for (int jpol = 0; jpol <= nPol; jpol++) {
-            int ipnt = ipol * nPntEdge + jpol;
-            const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, mMyQuad->isAxial());
-            const RDMatX3 &rtpS = mMyQuad->computeGeocentricGlobal(srcLat, srcLon, srcDep, xieta, Nr, phi2D);
-            for (int alpha = 0; alpha < Nr; alpha++) {
-                double r = rtpS(alpha, 0);
-                double t = rtpS(alpha, 1);
-                double p = rtpS(alpha, 2);
-                mStiff_dZ(alpha, ipnt) += g3D.getDeltaR(r, t, p, rElemCenter); 
-            }
-        }
-    }
+    const RDMatX3 &rtp = mMyQuad->getGeocentricStiff();
+    RDColX deltaR;
+    g3D.getDeltaRBatch(rtp, RDColX::Constant(rtp.rows(), rElemCenter), deltaR);
+    // row = ipnt * Nr + alpha, same as column-major mStiff_dZ
+    mStiff_dZ += Eigen::Map<const RDMatXN>(deltaR.data(), Nr, nPE);
 }
 
 void Relabelling::finishUndulation() {
@@ -74,6 +66,32 @@ void Relabelling::finishUndulation() {
     formMassUndulation();
 }
 
+void Relabelling::packUndulation(std::vector<double> &buffer) const {
+    XMath::pack(mStiff_dZ, buffer);
+    XMath::pack(mStiff_dZdR, buffer);
+    XMath::pack(mStiff_dZdT, buffer);
+    XMath::pack(mStiff_dZdZ, buffer);
+    for (int i = 0; i < nPE; i++) {
+        XMath::pack(mMass_dZ[i], buffer);
+        XMath::pack(mMass_dZdR[i], buffer);
+        XMath::pack(mMass_dZdT[i], buffer);
+        XMath::pack(mMass_dZdZ[i], buffer);
+    }
+}
+
+void Relabelling::unpackUndulation(const RDColX &buffer, int &pos) {
+    XMath::unpack(mStiff_dZ, buffer, pos);
+    XMath::unpack(mStiff_dZdR, buffer, pos);
+    XMath::unpack(mStiff_dZdT, buffer, pos);
+    XMath::unpack(mStiff_dZdZ, buffer, pos);
+    for (int i = 0; i < nPE; i++) {
+        XMath::unpack(mMass_dZ[i], buffer, pos);
+        XMath::unpack(mMass_dZdR[i], buffer, pos);
+        XMath::unpack(mMass_dZdT[i], buffer, pos);
+        XMath::unpack(mMass_dZdZ[i], buffer, pos);
+    }
+}
+
 void Relabelling::checkHmin() {
     int Nr = mMyQuad->getNr();
     int maxOrder = (Nr + 1) / 2 - 1;
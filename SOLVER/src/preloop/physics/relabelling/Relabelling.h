@@ -19,11 +19,15 @@ public:
     bool isZeroMass() const;
     
     // add deltaR on mass sampling points
-    void addUndulation(const Geometric3D &g3D, double srcLat, double srcLon, double srcDep, double phi2D);
+    void addUndulation(const Geometric3D &g3D);
     
     // finishUndulation
     void finishUndulation();
     
+    // undulation in a flat buffer, for migration between procs
+    void packUndulation(std::vector<double> &buffer) const;
+    void unpackUndulation(const RDColX &buffer, int &pos);
+    
     // stiffness
     RDMatXN getStiffJacobian() const;
     RDMatXN4 getStiffX() const;
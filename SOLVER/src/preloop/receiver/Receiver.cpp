@@ -9,6 +9,7 @@
 #include "RecorderAscii.h"
 #include "RecorderBinary.h"
 #include "Station.h"
+#include "Ring.h"
 #include "Domain.h"
 #include "Mesh.h"
 #include "Quad.h"
@@ -48,7 +49,8 @@ mName(name), mNetwork(network), mDepth(depth) {
 void Receiver::release(Domain &domain, const Mesh &mesh, 
     int recordInterval, int component,
     const std::string &path, bool binary, bool append, int bufferSize,
-    int elemTag, const RDMatPP &interpFact) {
+    int elemTag, const RDMatPP &interpFact, Recorder *recorder, 
+    const std::vector<Recorder *> &stfRecorders) {
                     
     Element *myElem = domain.getElement(elemTag);
                     
@@ -64,25 +66,38 @@ void Receiver::release(Domain &domain, const Mesh &mesh,
     // recorder
     Recorder *rec;
     std::string fname = path + "/" + mNetwork + "_" + mName;
-    if (binary) 
+    if (recorder)
+        rec = recorder;
+    else if (binary) 
         rec = new RecorderBinary(bufferSize, fname, append);
     else 
         rec = new RecorderAscii(bufferSize, fname, append);
     
     // station    
-    domain.addStation(new Station(recordInterval, seis, rec));
+    Station *station = new Station(recordInterval, seis, rec);
+    for (const auto &stfRec: stfRecorders) station->addRecorderSTF(stfRec);
+    domain.addStation(station);
 }
 
-bool Receiver::locate(const Mesh &mesh, int &elemTag, RDMatPP &interpFact) const {
+void Receiver::releaseRing(Domain &domain, int recordInterval, const std::string &path, 
+    int bufferSize, int elemTag, const RDMatPP &interpFact) {
+    Element *myElem = domain.getElement(elemTag);
+    Seismometer *seis = new SeismometerRTZ(0., interpFact.cast<Real>(), myElem, mTheta);
+    domain.addRing(new Ring(recordInterval, seis, mTheta, mDepth, 
+        bufferSize, path + "/" + mName + ".ring"));
+}
+
+bool Receiver::locate(const Mesh &mesh, double radiusRef, int &elemTag, RDMatPP &interpFact) const {
     RDCol2 recCrds, srcXiEta;
-    double r = mesh.computeRadiusRef(mDepth, mLat, mLon);
+    double r = radiusRef;
     recCrds(0) = r * sin(mTheta);
     recCrds(1) = r * cos(mTheta);
     if (recCrds(0) > mesh.sMax() + tinySingle || recCrds(0) < mesh.sMin() - tinySingle) return false;
     if (recCrds(1) > mesh.zMax() + tinySingle || recCrds(1) < mesh.zMin() - tinySingle) return false;
-    for (int iloc = 0; iloc < mesh.getNumQuads(); iloc++) {
+    std::vector<int> locs;
+    mesh.findQuads(recCrds(0), recCrds(1), locs);
+    for (int iloc: locs) {
         const Quad *quad = mesh.getQuad(iloc);
-        if (!quad->nearMe(recCrds(0), recCrds(1))) continue;
         if (quad->invMapping(recCrds, srcXiEta)) {
             if (std::abs(srcXiEta(0)) <= 1.000001 && std::abs(srcXiEta(1)) <= 1.000001) {
                 elemTag = quad->getElementTag();
@@ -5,10 +5,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "eigenp.h"
 
 class Domain;
 class Mesh;
+class Recorder;
 
 class Receiver {
 public:
@@ -20,15 +22,30 @@ public:
     //     int recordInterval, int component,
     //     const std::string &path, bool binary, bool append, int bufferSize); 
         
+    // recorder: if given, used instead of a per-station file
+    // stfRecorders: recorders of seismograms convolved with additional STFs
     void release(Domain &domain, const Mesh &mesh, 
         int recordInterval, int component,
         const std::string &path, bool binary, bool append, int bufferSize,
-        int elemTag, const RDMatPP &interpFact);     
+        int elemTag, const RDMatPP &interpFact, Recorder *recorder, 
+        const std::vector<Recorder *> &stfRecorders);     
     
-    bool locate(const Mesh &mesh, int &elemTag, RDMatPP &interpFact) const;
+    // release as a ring receiver at my (r, theta), recording RTZ
+    void releaseRing(Domain &domain, int recordInterval, const std::string &path, 
+        int bufferSize, int elemTag, const RDMatPP &interpFact);
+    
+    // radiusRef: reference radius from Mesh::computeRadiusRef
+    bool locate(const Mesh &mesh, double radiusRef, int &elemTag, RDMatPP &interpFact) const;
     
     std::string verbose(bool geographic, int wname, int wnet) const;
     
+    const std::string &getName() const {return mName;};
+    const std::string &getNetwork() const {return mNetwork;};
+    double getLat() const {return mLat;};
+    double getLon() const {return mLon;};
+    double getDepth() const {return mDepth;};
+    double getTheta() const {return mTheta;};
+    
 private:
     std::string mName;
     std::string mNetwork;
@@ -12,6 +12,22 @@
 #include <boost/lexical_cast.hpp>
 #include "Parameters.h"
 #include "Domain.h"
+#include "Mesh.h"
+#include "SourceTimeFunction.h"
+#include "StationOutputH5.h"
+#include "RecorderH5.h"
+#include "StationDecimator.h"
+#include "StationConvolver.h"
+#include "RecorderAscii.h"
+#include "RecorderBinary.h"
+#include "RecorderCompressed.h"
+#include "STF.h"
+#include "SurfaceDatabase.h"
+#include "ReciprocalDatabase.h"
+#include "Quad.h"
+#include "SpectralConstants.h"
+#include "XMath.h"
+#include <algorithm>
 
 ReceiverCollection::ReceiverCollection(const std::string &fileRec, bool geographic, 
     double srcLat, double srcLon, double srcDep):
@@ -60,28 +76,245 @@ mInputFile(fileRec), mGeographic(geographic) {
 
 ReceiverCollection::~ReceiverCollection() {
     for (const auto &rec: mReceivers)  delete rec;
+    for (const auto &ring: mRings) delete ring;
 }
 
-void ReceiverCollection::release(Domain &domain, const Mesh &mesh) {
-    std::vector<int> recRank(mReceivers.size(), XMPI::nproc());
-    std::vector<int> recETag(mReceivers.size(), -1);
-    std::vector<RDMatPP> recInterpFact(mReceivers.size(), RDMatPP::Zero());
-    for (int irec = 0; irec < mReceivers.size(); irec++) {
-        bool found = mReceivers[irec]->locate(mesh, recETag[irec], recInterpFact[irec]);
-        if (found) recRank[irec] = XMPI::rank();
+void ReceiverCollection::readRings(const std::string &fileRing, 
+    double srcLat, double srcLon, double srcDep) {
+    std::vector<std::string> name;
+    std::vector<double> theta, depth;
+    if (XMPI::root()) {
+        std::fstream fs(fileRing, std::fstream::in);
+        if (!fs) throw std::runtime_error("ReceiverCollection::readRings || "
+            "Error opening ring data file " + fileRing + ".");
+        std::string line;
+        while (getline(fs, line)) {
+            try {
+                std::vector<std::string> strs;
+                boost::trim_if(line, boost::is_any_of("\t "));
+                boost::split(strs, line, boost::is_any_of("\t "), boost::token_compress_on);
+                if (strs.size() != 3) continue;
+                name.push_back(strs[0]);
+                theta.push_back(boost::lexical_cast<double>(strs[1]));
+                depth.push_back(boost::lexical_cast<double>(strs[2]));
+            } catch(std::exception) {
+                // simply ignore invalid lines
+                continue;
+            }
+        }
+        fs.close();
     }
-    for (int irec = 0; irec < mReceivers.size(); irec++) {
-        int recRankMin = XMPI::min(recRank[irec]);
-        if (recRankMin == XMPI::nproc()) {
-            throw std::runtime_error("ReceiverCollection::release || Error locating receiver " + 
+    XMPI::bcast(name);
+    XMPI::bcast(theta);
+    XMPI::bcast(depth);
+    for (int i = 0; i < name.size(); i++) 
+        mRings.push_back(new Receiver(name[i], "RING", 
+            theta[i], 0., false, depth[i], srcLat, srcLon, srcDep));
+}
+
+void ReceiverCollection::locate(const std::vector<Receiver *> &receivers, const Mesh &mesh, 
+    IColX &recRank, std::vector<int> &recETag, std::vector<RDMatPP> &recInterpFact) const {
+    recRank = IColX::Constant(receivers.size(), XMPI::nproc());
+    recETag = std::vector<int>(receivers.size(), -1);
+    recInterpFact = std::vector<RDMatPP>(receivers.size(), RDMatPP::Zero());
+    
+    // reference radii, computed in one batch with receivers distributed over procs
+    int nrec = receivers.size();
+    std::vector<int> myRecs;
+    for (int irec = XMPI::rank(); irec < nrec; irec += XMPI::nproc()) myRecs.push_back(irec);
+    RDColX myDepth(myRecs.size()), myLat(myRecs.size()), myLon(myRecs.size()), myRadius;
+    for (int i = 0; i < myRecs.size(); i++) {
+        myDepth(i) = receivers[myRecs[i]]->getDepth();
+        myLat(i) = receivers[myRecs[i]]->getLat();
+        myLon(i) = receivers[myRecs[i]]->getLon();
+    }
+    mesh.computeRadiusRef(myDepth, myLat, myLon, myRadius);
+    RDColX radiusRef = RDColX::Zero(nrec);
+    for (int i = 0; i < myRecs.size(); i++) radiusRef(myRecs[i]) = myRadius(i);
+    XMPI::sumEigenDouble(radiusRef);
+    
+    for (int irec = 0; irec < receivers.size(); irec++) {
+        bool found = receivers[irec]->locate(mesh, radiusRef(irec), recETag[irec], recInterpFact[irec]);
+        if (found) recRank(irec) = XMPI::rank();
+    }
+    
+    // owners of all receivers in one collective
+    XMPI::minEigenInt(recRank);
+    for (int irec = 0; irec < receivers.size(); irec++) {
+        if (recRank(irec) == XMPI::nproc()) {
+            throw std::runtime_error("ReceiverCollection::locate || Error locating receiver " + 
                 boost::lexical_cast<std::string>(irec));
         }
-        if (recRankMin == XMPI::rank()) {
+    }
+}
+
+void ReceiverCollection::release(Domain &domain, const Mesh &mesh) {
+    IColX recRank;
+    std::vector<int> recETag;
+    std::vector<RDMatPP> recInterpFact;
+    locate(mReceivers, mesh, recRank, recETag, recInterpFact);
+    int nrec = mReceivers.size();
+    
+    // single-file output, with stations sorted by owner such that 
+    // the stations of each proc form one hyperslab 
+    StationOutputH5 *output = 0;
+    std::vector<StationOutputH5 *> stfOutputs;
+    if (mHDF5) {
+        std::vector<int> order(nrec);
+        for (int irec = 0; irec < nrec; irec++) order[irec] = irec;
+        std::stable_sort(order.begin(), order.end(), 
+            [&recRank](int a, int b) {return recRank(a) < recRank(b);});
+        std::vector<std::string> names;
+        std::vector<double> coords;
+        int offset = 0, count = 0;
+        for (int irec: order) {
+            const Receiver &rec = *mReceivers[irec];
+            names.push_back(rec.getNetwork() + "." + rec.getName());
+            coords.push_back(rec.getLat());
+            coords.push_back(rec.getLon());
+            coords.push_back(rec.getDepth());
+            if (recRank(irec) < XMPI::rank()) offset++;
+            if (recRank(irec) == XMPI::rank()) count++;
+        }
+        int ntime = (domain.getSTF().getSize() - 1) / mRecordInterval + 1;
+        output = new StationOutputH5(mOutputDir + "/stations/axisem3d_synthetics.h5", 
+            nrec, offset, count, ntime, mRecordInterval, mBufferSize);
+        const std::string components[3] = {"RTZ", "ENZ", "SPZ"};
+        output->create(names, coords, components[mComponent]);
+        domain.setStationOutput(output);
+        for (const auto &label: mSTFLabels) {
+            stfOutputs.push_back(new StationOutputH5(mOutputDir + "/stations/axisem3d_synthetics_" + label + ".h5", 
+                nrec, offset, count, ntime, mRecordInterval, mBufferSize));
+            stfOutputs.back()->create(names, coords, components[mComponent]);
+        }
+    }
+    
+    int myIndex = 0;
+    for (int irec = 0; irec < mReceivers.size(); irec++) {
+        if (recRank(irec) == XMPI::rank()) {
+            Recorder *recorder = 0;
+            std::vector<Recorder *> stfRecorders;
+            if (mHDF5) {
+                recorder = new RecorderH5(output, myIndex);
+                for (const auto &stfOutput: stfOutputs) 
+                    stfRecorders.push_back(new RecorderH5(stfOutput, myIndex));
+                myIndex++;
+            } else {
+                const Receiver &rec = *mReceivers[irec];
+                std::string fname = mOutputDir + "/stations/" + rec.getNetwork() + "_" + rec.getName();
+                if (mCompressed) 
+                    recorder = new RecorderCompressed(mBufferSize, fname, mAppend, mTolerance);
+                for (const auto &label: mSTFLabels) {
+                    if (mCompressed) 
+                        stfRecorders.push_back(new RecorderCompressed(mBufferSize, fname + "." + label, mAppend, mTolerance));
+                    else if (mBinary) 
+                        stfRecorders.push_back(new RecorderBinary(mBufferSize, fname + "." + label, mAppend));
+                    else 
+                        stfRecorders.push_back(new RecorderAscii(mBufferSize, fname + "." + label, mAppend));
+                }
+            }
             mReceivers[irec]->release(domain, mesh, mRecordInterval, mComponent, 
                 mOutputDir + "/stations", mBinary, mAppend, mBufferSize, 
-                recETag[irec], recInterpFact[irec]);
+                recETag[irec], recInterpFact[irec], recorder, stfRecorders);
+        }
+    }
+    
+    // anti-alias filter, stopband from the output Nyquist;
+    // a Blackman window of 2 * 20 * factor + 1 taps has a transition 
+    // band of about 0.14 / factor cycles per sample
+    if (mAntiAlias && mRecordInterval > 1) {
+        double cutoff = (.5 - .07) / mRecordInterval;
+        const RDColX &taps = XMath::lowpassFIR(20 * mRecordInterval, cutoff);
+        domain.setStationDecimator(new StationDecimator(mRecordInterval, taps.cast<Real>()));
+    }
+    
+    // additional STFs
+    if (mSTFLabels.size() > 0) 
+        domain.setStationConvolver(new StationConvolver(mSTFKernels.cast<Real>(), 
+            mSTFIntegrate, mRecordInterval), stfOutputs);
+    
+    // rings, recorded at the station interval without filtering
+    locate(mRings, mesh, recRank, recETag, recInterpFact);
+    for (int iring = 0; iring < mRings.size(); iring++) 
+        if (recRank(iring) == XMPI::rank()) 
+            mRings[iring]->releaseRing(domain, mRecordInterval, mOutputDir + "/stations", 
+                mBufferSize, recETag[iring], recInterpFact[iring]);
+    
+    // surface wavefield database
+    if (mSurfaceDatabase) releaseSurface(domain, mesh);
+    
+    // reciprocal strain database
+    if (mReciprocalDatabase) releaseReciprocal(domain, mesh);
+}
+
+void ReceiverCollection::releaseSurface(Domain &domain, const Mesh &mesh) const {
+    std::string dir = mOutputDir + "/surface_database";
+    if (XMPI::root()) XMPI::mkdir(dir);
+    XMPI::barrier();
+    SurfaceDatabase *database = new SurfaceDatabase(mSurfaceInterval, mBufferSize, 
+        mSurfaceTolerance, dir + "/surface_rank" + boost::lexical_cast<std::string>(XMPI::rank()));
+    for (int iquad = 0; iquad < mesh.getNumQuads(); iquad++) {
+        const Quad *quad = mesh.getQuad(iquad);
+        if (!quad->onSurface()) continue;
+        // points along the surface edge
+        int side = quad->getSurfaceSide();
+        std::vector<int> ipnts;
+        std::vector<double> xi, theta;
+        for (int i = 0; i <= nPol; i++) {
+            int ipol = (side == 1) ? nPol : ((side == 3) ? 0 : i);
+            int jpol = (side == 0) ? 0 : ((side == 2) ? nPol : i);
+            const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, quad->isAxial());
+            const RDCol2 &sz = quad->mapping(xieta);
+            ipnts.push_back(ipol * nPntEdge + jpol);
+            xi.push_back((side == 0 || side == 2) ? xieta(0) : xieta(1));
+            theta.push_back(atan2(sz(0), sz(1)));
+        }
+        database->addElement(domain.getElement(quad->getElementTag()), ipnts, xi, theta);
+    }
+    database->open(XMath::lat2Theta(mSrcLat, mSrcDep), XMath::lon2Phi(mSrcLon), 
+        XMath::getFlattening(XMath::getROuter()));
+    domain.setSurfaceDatabase(database);
+}
+
+void ReceiverCollection::releaseReciprocal(Domain &domain, const Mesh &mesh) const {
+    std::string dir = mOutputDir + "/reciprocal_database";
+    if (XMPI::root()) XMPI::mkdir(dir);
+    XMPI::barrier();
+    ReciprocalDatabase *database = new ReciprocalDatabase(mReciprocalInterval, mBufferSize, 
+        mReciprocalTolerance, dir + "/reciprocal_rank" + boost::lexical_cast<std::string>(XMPI::rank()));
+    double router = XMath::getROuter();
+    double rmin = router - mReciprocalDepth[1];
+    double rmax = router - mReciprocalDepth[0];
+    for (int iquad = 0; iquad < mesh.getNumQuads(); iquad++) {
+        const Quad *quad = mesh.getQuad(iquad);
+        if (quad->isFluid()) continue;
+        // all points, ranges covered by this element
+        std::vector<double> xi, eta, s, z;
+        double r0 = router * 2., r1 = 0., t0 = pi, t1 = 0.;
+        for (int ipol = 0; ipol <= nPol; ipol++) {
+            for (int jpol = 0; jpol <= nPol; jpol++) {
+                const RDCol2 &xieta = SpectralConstants::getXiEta(ipol, jpol, quad->isAxial());
+                const RDCol2 &sz = quad->mapping(xieta);
+                s.push_back(sz(0));
+                z.push_back(sz(1));
+                r0 = std::min(r0, sz.norm());
+                r1 = std::max(r1, sz.norm());
+                t0 = std::min(t0, atan2(sz(0), sz(1)));
+                t1 = std::max(t1, atan2(sz(0), sz(1)));
+            }
+            xi.push_back(SpectralConstants::getXiEta(ipol, 0, quad->isAxial())(0));
+            eta.push_back(SpectralConstants::getXiEta(0, ipol, quad->isAxial())(1));
         }
+        if (r1 < rmin || r0 > rmax || t1 < mReciprocalDistance[0] || t0 > mReciprocalDistance[1]) continue;
+        // strain is computed on the reference geometry
+        if (quad->stiffRelabelling()) throw std::runtime_error("ReceiverCollection::releaseReciprocal || "
+            "Reciprocal database is incompatible with particle relabelling, ||"
+            "e.g., topography or ellipticity in the depth and distance range.");
+        database->addElement(domain.getElement(quad->getElementTag()), xi, eta, s, z);
     }
+    database->open(XMath::lat2Theta(mSrcLat, mSrcDep), XMath::lon2Phi(mSrcLon), router, 
+        rmin, rmax, XMath::getFlattening(rmin), XMath::getFlattening(rmax));
+    domain.setReciprocalDatabase(database);
 }
 
 std::string ReceiverCollection::verbose() const {
@@ -89,6 +322,13 @@ std::string ReceiverCollection::verbose() const {
     ss << "\n========================= Receivers ========================" << std::endl;
     ss << "  Number of Receivers   =   " << mReceivers.size() << std::endl;
     ss << "  Coordinate System     =   " << (mGeographic ? "Geographic" : "Source-centered") << std::endl;
+    ss << "  Number of Rings       =   " << mRings.size() << std::endl;
+    ss << "  Surface Database      =   " << (mSurfaceDatabase ? "YES" : "NO") << std::endl;
+    ss << "  Reciprocal Database   =   " << (mReciprocalDatabase ? "YES" : "NO") << std::endl;
+    if (mReciprocalDatabase) {
+        ss << "    Depth (km)          =   " << mReciprocalDepth[0] / 1e3 << " ~ " << mReciprocalDepth[1] / 1e3 << std::endl;
+        ss << "    Distance (deg)      =   " << mReciprocalDistance[0] / degree << " ~ " << mReciprocalDistance[1] / degree << std::endl;
+    }
     if (mReceivers.size() > 0) {
         ss << "  Receiver List: " << std::endl;
         ss << "    " << mReceivers[0]->verbose(mGeographic, mWidthName, mWidthNetwork) << std::endl;
@@ -101,8 +341,8 @@ std::string ReceiverCollection::verbose() const {
     return ss.str();
 }
 
-void ReceiverCollection::buildInparam(ReceiverCollection *&rec, 
-    const Parameters &par, double srcLat, double srcLon, double srcDep, int verbose) {
+void ReceiverCollection::buildInparam(ReceiverCollection *&rec, const Parameters &par, 
+    const STF &stf, double srcLat, double srcLon, double srcDep, int verbose) {
     if (rec) delete rec;
     
     // create from file
@@ -137,12 +377,88 @@ void ReceiverCollection::buildInparam(ReceiverCollection *&rec,
         rec->mBinary = false;
     } else if (boost::iequals(strfmt, "binary")) {
         rec->mBinary = true;
+    } else if (boost::iequals(strfmt, "hdf5")) {
+        rec->mHDF5 = true;
+    } else if (boost::iequals(strfmt, "compressed")) {
+        rec->mCompressed = true;
+        rec->mTolerance = par.getValue<double>("OUT_STATIONS_COMPRESSION_TOLERANCE");
+        if (rec->mTolerance != 0. && (rec->mTolerance < 1e-15 || rec->mTolerance >= .5)) 
+            throw std::runtime_error("ReceiverCollection::buildInparam || "
+            "OUT_STATIONS_COMPRESSION_TOLERANCE must be 0 or in [1e-15, 0.5).");
     } else {
         throw std::runtime_error("ReceiverCollection::buildInparam || Invalid parameter, keyword = OUT_STATIONS_FORMAT.");
     }
     rec->mAppend = false;
     rec->mBufferSize = par.getValue<int>("OUT_STATIONS_DUMP_INTERVAL");
     if (rec->mBufferSize <= 0) rec->mBufferSize = 100;
+    rec->mAntiAlias = par.getValue<bool>("OUT_STATIONS_ANTI_ALIAS");
+    
+    // surface wavefield database
+    rec->mSrcLat = srcLat;
+    rec->mSrcLon = srcLon;
+    rec->mSrcDep = srcDep;
+    rec->mSurfaceDatabase = par.getValue<bool>("OUT_SURFACE_DATABASE");
+    rec->mSurfaceInterval = par.getValue<int>("OUT_SURFACE_DATABASE_INTERVAL");
+    if (rec->mSurfaceInterval <= 0) rec->mSurfaceInterval = 1;
+    rec->mSurfaceTolerance = par.getValue<double>("OUT_SURFACE_DATABASE_TOLERANCE");
+    if (rec->mSurfaceTolerance != 0. && (rec->mSurfaceTolerance < 1e-15 || rec->mSurfaceTolerance >= .5)) 
+        throw std::runtime_error("ReceiverCollection::buildInparam || "
+        "OUT_SURFACE_DATABASE_TOLERANCE must be 0 or in [1e-15, 0.5).");
+    
+    // reciprocal strain database
+    rec->mReciprocalDatabase = par.getValue<bool>("OUT_RECIPROCAL_DATABASE");
+    rec->mReciprocalInterval = par.getValue<int>("OUT_RECIPROCAL_DATABASE_INTERVAL");
+    if (rec->mReciprocalInterval <= 0) rec->mReciprocalInterval = 1;
+    rec->mReciprocalTolerance = par.getValue<double>("OUT_RECIPROCAL_DATABASE_TOLERANCE");
+    if (rec->mReciprocalTolerance != 0. && (rec->mReciprocalTolerance < 1e-15 || rec->mReciprocalTolerance >= .5)) 
+        throw std::runtime_error("ReceiverCollection::buildInparam || "
+        "OUT_RECIPROCAL_DATABASE_TOLERANCE must be 0 or in [1e-15, 0.5).");
+    const std::string rangeKeys[2] = {"OUT_RECIPROCAL_DEPTH_RANGE", "OUT_RECIPROCAL_DISTANCE_RANGE"};
+    double *ranges[2] = {rec->mReciprocalDepth, rec->mReciprocalDistance};
+    const double rangeUnits[2] = {1e3, degree};
+    for (int i = 0; i < 2; i++) {
+        std::string str = par.getValue<std::string>(rangeKeys[i]);
+        std::vector<std::string> strs;
+        boost::trim_if(str, boost::is_any_of("\t "));
+        boost::split(strs, str, boost::is_any_of("$"), boost::token_compress_on);
+        if (strs.size() != 2) throw std::runtime_error("ReceiverCollection::buildInparam || "
+            "Invalid parameter, keyword = " + rangeKeys[i] + ".");
+        ranges[i][0] = boost::lexical_cast<double>(strs[0]) * rangeUnits[i];
+        ranges[i][1] = boost::lexical_cast<double>(strs[1]) * rangeUnits[i];
+        if (ranges[i][0] > ranges[i][1]) throw std::runtime_error("ReceiverCollection::buildInparam || "
+            "Invalid parameter, keyword = " + rangeKeys[i] + ".");
+    }
+    
+    // ring receivers
+    std::string ringFile = par.getValue<std::string>("OUT_RINGS_FILE");
+    if (!boost::iequals(ringFile, "none")) 
+        rec->readRings(Parameters::sInputDirectory + "/" + ringFile, srcLat, srcLon, srcDep);
+    
+    // additional STFs
+    int nstf = par.getValue<int>("OUT_STATIONS_STF_NUM");
+    if (nstf > par.getSize("OUT_STATIONS_STF_LIST")) throw std::runtime_error("ReceiverCollection::buildInparam || "
+        "Not enough STFs provided in OUT_STATIONS_STF_LIST ||"
+        "OUT_STATIONS_STF_NUM = " + par.getValue<std::string>("OUT_STATIONS_STF_NUM") + ".");
+    std::vector<RDColX> kernels;
+    int maxTaps = 1;
+    for (int i = 0; i < nstf; i++) {
+        std::string str = par.getValue<std::string>("OUT_STATIONS_STF_LIST", i);
+        std::vector<std::string> strs;
+        boost::trim_if(str, boost::is_any_of("\t "));
+        boost::split(strs, str, boost::is_any_of("$"), boost::token_compress_on);
+        if (strs.size() != 2) throw std::runtime_error("ReceiverCollection::buildInparam || "
+            "Invalid STF in OUT_STATIONS_STF_LIST: " + str + ".");
+        double hdur = boost::lexical_cast<double>(strs[1]);
+        bool integrate;
+        kernels.push_back(stf.convolutionKernel(strs[0], hdur, rec->mRecordInterval, integrate));
+        rec->mSTFIntegrate.push_back(integrate);
+        rec->mSTFLabels.push_back(boost::to_lower_copy(strs[0]) + "_" + strs[1]);
+        maxTaps = std::max(maxTaps, (int)kernels.back().size());
+    }
+    // kernels centered in columns
+    rec->mSTFKernels = RDMatXX::Zero(maxTaps, nstf);
+    for (int i = 0; i < nstf; i++) 
+        rec->mSTFKernels.block((maxTaps - kernels[i].size()) / 2, i, kernels[i].size(), 1) = kernels[i];
     
     if (verbose) XMPI::cout << rec->verbose();
 }
@@ -6,11 +6,13 @@
 
 #include <vector>
 #include <string>
+#include "eigenp.h"
 
 class Domain;
 class Mesh;
 class Parameters;
 class Receiver;
+class STF;
 
 class ReceiverCollection {
 public:
@@ -23,12 +25,26 @@ public:
     std::string verbose() const;
     
     static void buildInparam(ReceiverCollection *&rec, const Parameters &par, 
-        double srcLat, double srcLon, double srcDep, int verbose);
+        const STF &stf, double srcLat, double srcLon, double srcDep, int verbose);
         
 private:
+    // ring receivers from file, name distance depth per line
+    void readRings(const std::string &fileRing, double srcLat, double srcLon, double srcDep);
+    
+    // surface wavefield database of my surface elements
+    void releaseSurface(Domain &domain, const Mesh &mesh) const;
+    
+    // reciprocal strain database of my solid elements in range
+    void releaseReciprocal(Domain &domain, const Mesh &mesh) const;
+    
+    // locate receivers, all procs must call
+    void locate(const std::vector<Receiver *> &receivers, const Mesh &mesh, 
+        IColX &recRank, std::vector<int> &recETag, std::vector<RDMatPP> &recInterpFact) const;
     
     // receivers
     std::vector<Receiver *> mReceivers;
+    // ring receivers, located at azimuth 0
+    std::vector<Receiver *> mRings;
     
     // input
     std::string mInputFile;
@@ -39,8 +55,34 @@ private:
     int mComponent = 0;
     std::string mOutputDir = "./";
     bool mBinary = false;
+    bool mHDF5 = false;
+    bool mCompressed = false;
+    double mTolerance = 0.;
     bool mAppend = false;
     int mBufferSize = 100;
+    bool mAntiAlias = false;
+    
+    // source location, for surface and reciprocal databases
+    double mSrcLat = 0.;
+    double mSrcLon = 0.;
+    double mSrcDep = 0.;
+    
+    // surface wavefield database
+    bool mSurfaceDatabase = false;
+    int mSurfaceInterval = 1;
+    double mSurfaceTolerance = 0.;
+    
+    // reciprocal strain database, depth in m and distance in rad
+    bool mReciprocalDatabase = false;
+    double mReciprocalDepth[2] = {0., 0.};
+    double mReciprocalDistance[2] = {0., 0.};
+    int mReciprocalInterval = 1;
+    double mReciprocalTolerance = 0.;
+    
+    // additional STFs by convolution
+    std::vector<std::string> mSTFLabels;
+    RDMatXX mSTFKernels;
+    std::vector<bool> mSTFIntegrate;
     
     // for verbose
     int mWidthName;
@@ -67,10 +67,11 @@ bool Source::locate(const Mesh &mesh, int &locTag, RDColP &interpFactZ) const {
     if (srcCrds(0) > mesh.sMax() + tinySingle || srcCrds(0) < mesh.sMin() - tinySingle) return false;
     if (srcCrds(1) > mesh.zMax() + tinySingle || srcCrds(1) < mesh.zMin() - tinySingle) return false;
     RDCol2 srcXiEta;
-    for (int iloc = 0; iloc < mesh.getNumQuads(); iloc++) {
+    std::vector<int> locs;
+    mesh.findQuads(srcCrds(0), srcCrds(1), locs);
+    for (int iloc: locs) {
         const Quad *quad = mesh.getQuad(iloc);
         if (!quad->isAxial() || quad->isFluid()) continue;
-        if (!quad->nearMe(srcCrds(0), srcCrds(1))) continue;
         if (quad->invMapping(srcCrds, srcXiEta)) {
             if (std::abs(srcXiEta(1)) <= 1.000001) {
                 if (std::abs(srcXiEta(0) + 1.) > tinySingle)
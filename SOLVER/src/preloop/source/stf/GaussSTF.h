@@ -10,6 +10,13 @@ class GaussSTF: public STF {
 public:
     GaussSTF(double dt, double length, double hdur, double decay);
     std::string verbose() const;
+    
+protected:
+    void getGaussianShape(int &order, double &hdur, double &decay) const {
+        order = 0;
+        hdur = mHalfDuration;
+        decay = mDecay;
+    };
 
 private:
     double mHalfDuration;
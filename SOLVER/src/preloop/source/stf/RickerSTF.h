@@ -10,6 +10,13 @@ class RickerSTF: public STF {
 public:
     RickerSTF(double dt, double length, double hdur, double decay);
     std::string verbose() const;
+    
+protected:
+    void getGaussianShape(int &order, double &hdur, double &decay) const {
+        order = 2;
+        hdur = mHalfDuration;
+        decay = mDecay;
+    };
 
 private:
     double mHalfDuration;
@@ -5,12 +5,68 @@
 #include "STF.h"
 #include "SourceTimeFunction.h"
 #include "Domain.h"
+#include <cmath>
+#include <boost/algorithm/string.hpp>
 
 void STF::release(Domain &domain) const {
     std::vector<Real> ts(mSTF.begin(), mSTF.end());
     domain.setSTF(new SourceTimeFunction(ts, mDeltaT, mShift));
 }
 
+RDColX STF::convolutionKernel(const std::string &type, double hdur, 
+    int interval, bool &integrate) const {
+    // this STF is c0 * D^order0 g0 and the target c1 * D^order1 g1, 
+    // with g Gaussian and D the time derivative (D^-1 the integral);
+    // as g1 = g0 * gk with hk^2 = hdur^2 - hdur0^2, the kernel is
+    // c1 / c0 * D^(order1 - order0) gk; for Ricker, c = sqrt(pi) * hdur / decay
+    int order0;
+    double hdur0, decay;
+    getGaussianShape(order0, hdur0, decay);
+    int order1;
+    if (boost::iequals(type, "erf")) {
+        order1 = -1;
+    } else if (boost::iequals(type, "gauss")) {
+        order1 = 0;
+    } else if (boost::iequals(type, "ricker")) {
+        order1 = 2;
+    } else {
+        throw std::runtime_error("STF::convolutionKernel || Unknown stf type: " + type);
+    }
+    int order = order1 - order0;
+    if (order < -1) throw std::runtime_error("STF::convolutionKernel || "
+        "Cannot convert to " + type + " by convolution; use a lower-order STF in simulation.");
+    if (hdur < hdur0 * (1. - 1e-6)) throw std::runtime_error("STF::convolutionKernel || "
+        "Half duration of output STF is smaller than that used in simulation.");
+    double c0 = (order0 == 2) ? sqrt(pi) * hdur0 / decay : 1.;
+    double c1 = (order1 == 2) ? sqrt(pi) * hdur / decay : 1.;
+    
+    // discrete Gaussian of unit area; a delta if narrower than a sample
+    double dt = mDeltaT * interval;
+    double hk = sqrt(std::max(hdur * hdur - hdur0 * hdur0, 0.));
+    int nderiv = std::max(order, 0);
+    int half = (int)ceil(4. * hk / decay / dt) + nderiv;
+    RDColX kernel = RDColX::Zero(2 * half + 1);
+    for (int i = 0; i <= 2 * half; i++) {
+        double t = (i - half) * dt;
+        kernel(i) = (hk > 0.) ? exp(-pow(decay / hk * t, 2)) : 0.;
+    }
+    if (kernel.sum() < 1e-3) kernel(half) = 1.;
+    kernel *= c1 / c0 / (kernel.sum() * dt);
+    
+    // central differences
+    for (int ideriv = 0; ideriv < nderiv; ideriv++) {
+        RDColX diff = RDColX::Zero(2 * half + 1);
+        for (int i = 1; i < 2 * half; i++) 
+            diff(i) = (kernel(i + 1) - kernel(i - 1)) / (2. * dt);
+        kernel = diff;
+    }
+    // weights of discrete convolution; integration is a running sum 
+    // applied after convolution, with its dt also included here
+    integrate = (order == -1);
+    kernel *= integrate ? dt * dt : dt;
+    return kernel;
+}
+
 #include "XMPI.h"
 #include "Parameters.h"
 #include "ErfSTF.h"
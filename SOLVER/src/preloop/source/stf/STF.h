@@ -6,7 +6,9 @@
 
 #include <vector>
 #include <string>
+#include <stdexcept>
 #include "global.h"
+#include "eigenp.h"
 
 class Domain;
 class Parameters;
@@ -18,10 +20,23 @@ public:
     void release(Domain &domain) const;
 
     virtual std::string verbose() const = 0;
+    
+    // kernel converting seismograms of this STF to those of another 
+    // STF (erf, gauss or ricker), sampled every interval steps, 
+    // centered at its middle; integrate: the result must be integrated
+    RDColX convolutionKernel(const std::string &type, double hdur, 
+        int interval, bool &integrate) const;
 
     static void buildInparam(STF *&stf, const Parameters &par, double dt, int verbose);
 
 protected:
+    // a Gaussian exp(-(decay / hdur * t) ^ 2), differentiated order times,
+    // order = -1 for integration
+    virtual void getGaussianShape(int &order, double &hdur, double &decay) const {
+        throw std::runtime_error("STF::getGaussianShape || "
+            "Convolution is not supported for this type of STF.");
+    };
+    
     double mDeltaT;
     double mShift;
     std::vector<double> mSTF;
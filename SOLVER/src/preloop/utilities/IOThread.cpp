@@ -0,0 +1,99 @@
+// IOThread.cpp
+// created by agent on 19-Oct-2026
+// per-rank background thread for file output
+
+#include "IOThread.h"
+
+std::thread IOThread::sThread;
+std::mutex IOThread::sMutex;
+std::condition_variable IOThread::sCondQueue;
+std::condition_variable IOThread::sCondDone;
+std::deque<std::function<void()>> IOThread::sQueue;
+int IOThread::sMaxQueue = 0;
+bool IOThread::sRunning = false;
+uint64_t IOThread::sSubmitted = 0;
+uint64_t IOThread::sFinished = 0;
+std::exception_ptr IOThread::sError;
+
+void IOThread::initialize(int maxQueue) {
+    finalize();
+    sMaxQueue = maxQueue;
+    if (sMaxQueue <= 0) return;
+    sRunning = true;
+    sThread = std::thread(run);
+}
+
+void IOThread::finalize() {
+    if (sThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            sRunning = false;
+        }
+        sCondQueue.notify_all();
+        sThread.join();
+    }
+    sMaxQueue = 0;
+    rethrow();
+}
+
+uint64_t IOThread::submit(const std::function<void()> &job) {
+    if (sMaxQueue <= 0) {
+        job();
+        sFinished = ++sSubmitted;
+        return sSubmitted;
+    }
+    std::unique_lock<std::mutex> lock(sMutex);
+    // back-pressure
+    sCondDone.wait(lock, [] {return (int)sQueue.size() < sMaxQueue || sError;});
+    lock.unlock();
+    rethrow();
+    lock.lock();
+    sQueue.push_back(job);
+    uint64_t ticket = ++sSubmitted;
+    lock.unlock();
+    sCondQueue.notify_one();
+    return ticket;
+}
+
+void IOThread::wait(uint64_t ticket) {
+    if (sMaxQueue > 0) {
+        std::unique_lock<std::mutex> lock(sMutex);
+        sCondDone.wait(lock, [ticket] {return sFinished >= ticket || sError;});
+    }
+    rethrow();
+}
+
+void IOThread::run() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(sMutex);
+            // drain the queue before stopping
+            sCondQueue.wait(lock, [] {return !sQueue.empty() || !sRunning;});
+            if (sQueue.empty()) return;
+            job = sQueue.front();
+        }
+        try {
+            job();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(sMutex);
+            if (!sError) sError = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            sQueue.pop_front();
+            sFinished++;
+        }
+        sCondDone.notify_all();
+    }
+}
+
+void IOThread::rethrow() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        error = sError;
+        sError = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,47 @@
+// IOThread.h
+// created by agent on 19-Oct-2026
+// per-rank background thread for file output
+
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+
+class IOThread {
+public:
+    // start thread; with maxQueue <= 0, jobs run synchronously on submit
+    static void initialize(int maxQueue);
+    // finish all jobs and join
+    static void finalize();
+    
+    // queue a job, blocking while the queue is full
+    // jobs run in submission order and must not call MPI
+    // RETURN: ticket to wait for
+    static uint64_t submit(const std::function<void()> &job);
+    
+    // wait until the job with ticket has finished
+    static void wait(uint64_t ticket);
+    // wait until all jobs have finished
+    static void flush() {wait(sSubmitted);};
+    
+private:
+    static void run();
+    // rethrow an exception caught in a job
+    static void rethrow();
+    
+    static std::thread sThread;
+    static std::mutex sMutex;
+    static std::condition_variable sCondQueue;
+    static std::condition_variable sCondDone;
+    static std::deque<std::function<void()>> sQueue;
+    static int sMaxQueue;
+    static bool sRunning;
+    static uint64_t sSubmitted;
+    static uint64_t sFinished;
+    static std::exception_ptr sError;
+};
@@ -0,0 +1,201 @@
+// ModelCache.cpp
+// created by agent on 19-Oct-2026
+// binary cache of post-processed 3D model data, memory-mapped on read
+
+#include "ModelCache.h"
+#include "XMPI.h"
+#include "Parameters.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool ModelCache::sEnabled = false;
+std::string ModelCache::sDirectory = "";
+
+namespace {
+    // file layout: header, entries, then data of all arrays
+    const uint64_t sMagic = 0x4843414333534158ULL; // "XAS3CACH"
+    // bump whenever the file layout or the post-processing of any 
+    // cached model changes, so that stale caches are never mapped
+    const int sFormatVersion = 1;
+    const int sNameLength = 32;
+    struct Header {
+        uint64_t mMagic;
+        uint64_t mHash;
+        int64_t mNumArrays;
+    };
+    struct FileEntry {
+        char mName[sNameLength];
+        int64_t mRows;
+        int64_t mCols;
+        int64_t mOffset;
+    };
+}
+
+ModelCache::ModelCache(const std::string &prefix): mPrefix(prefix) {
+    // FNV-1a offset basis
+    mHash = 14695981039346656037ULL;
+    addToKey(sFormatVersion);
+    addToKey(prefix);
+}
+
+ModelCache::~ModelCache() {
+    if (mMapped != 0) munmap(mMapped, mMappedSize);
+}
+
+void ModelCache::addToKey(const std::string &str) {
+    addToKey(str.data(), str.size());
+}
+
+void ModelCache::addToKey(const void *data, std::size_t nbytes) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < nbytes; i++) {
+        mHash ^= bytes[i];
+        mHash *= 1099511628211ULL;
+    }
+}
+
+void ModelCache::addFileToKey(const std::string &fname) {
+    // a missing file is keyed as such; reading it will fail later
+    double stamp[3] = {-1., -1., -1.};
+    if (XMPI::root()) {
+        struct stat info;
+        if (stat(fname.c_str(), &info) == 0) {
+            stamp[0] = (double)info.st_size;
+            stamp[1] = (double)info.st_mtim.tv_sec;
+            stamp[2] = (double)info.st_mtim.tv_nsec;
+        }
+    }
+    XMPI::bcast(stamp, 3);
+    addToKey(fname);
+    addToKey(stamp, sizeof(stamp));
+}
+
+std::string ModelCache::fileName() const {
+    std::stringstream ss;
+    ss << sDirectory << "/" << mPrefix << "_" << std::hex << std::setw(16) << std::setfill('0') << mHash << ".bin";
+    return ss.str();
+}
+
+bool ModelCache::load() {
+    if (!sEnabled) return false;
+    // all procs must map the file, e.g., on a shared file system
+    int found = map(fileName());
+    found = XMPI::min(found);
+    if (!found && mMapped != 0) {
+        munmap(mMapped, mMappedSize);
+        mMapped = 0;
+        mEntries.clear();
+    }
+    return found;
+}
+
+void ModelCache::addArray(const std::string &name, const RDMatXX &array) {
+    if (name.size() >= sNameLength) throw std::runtime_error("ModelCache::addArray || "
+        "Array name too long: " + name);
+    mOwned[name] = array;
+}
+
+void ModelCache::store() {
+    if (sEnabled) {
+        int written = 0;
+        if (XMPI::root()) {
+            XMPI::mkdir(sDirectory);
+            written = write(fileName());
+        }
+        XMPI::bcast(written);
+        if (written && load()) {
+            mOwned.clear();
+            return;
+        }
+    }
+    // broadcast
+    std::vector<std::string> names;
+    for (const auto &it: mOwned) names.push_back(it.first);
+    XMPI::bcast(names);
+    for (const auto &name: names) XMPI::bcastEigen(mOwned[name]);
+    for (const auto &it: mOwned) 
+        mEntries[it.first] = {it.second.data(), (int)it.second.rows(), (int)it.second.cols()};
+}
+
+void ModelCache::mapArray(const std::string &name, Eigen::Map<const RDMatXX> &view) const {
+    auto it = mEntries.find(name);
+    if (it == mEntries.end()) throw std::runtime_error("ModelCache::mapArray || "
+        "Array not found in model cache: " + name);
+    // re-seat the map
+    new (&view) Eigen::Map<const RDMatXX>(it->second.mData, it->second.mRows, it->second.mCols);
+}
+
+void ModelCache::setup(const Parameters &par) {
+    sEnabled = par.getValue<bool>("MODEL_3D_CACHE");
+    sDirectory = Parameters::sInputDirectory + "/" + 
+        par.getValue<std::string>("MODEL_3D_CACHE_DIRECTORY");
+}
+
+bool ModelCache::write(const std::string &fname) const {
+    // write to a temp file and rename, so that concurrent runs never see a partial file
+    std::string ftemp = fname + ".tmp" + std::to_string(getpid());
+    std::fstream fs(ftemp, std::fstream::out | std::fstream::binary);
+    if (!fs) return false;
+    Header header = {sMagic, mHash, (int64_t)mOwned.size()};
+    fs.write((const char *)&header, sizeof(Header));
+    int64_t offset = 0;
+    for (const auto &it: mOwned) {
+        FileEntry entry;
+        memset(entry.mName, 0, sNameLength);
+        strncpy(entry.mName, it.first.c_str(), sNameLength - 1);
+        entry.mRows = it.second.rows();
+        entry.mCols = it.second.cols();
+        entry.mOffset = offset;
+        offset += it.second.size();
+        fs.write((const char *)&entry, sizeof(FileEntry));
+    }
+    for (const auto &it: mOwned) 
+        fs.write((const char *)it.second.data(), it.second.size() * sizeof(double));
+    fs.close();
+    if (!fs) {
+        std::remove(ftemp.c_str());
+        return false;
+    }
+    return std::rename(ftemp.c_str(), fname.c_str()) == 0;
+}
+
+bool ModelCache::map(const std::string &fname) {
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    // pages are shared by all ranks on a node through the page cache
+    void *mapped = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    mMapped = mapped;
+    mMappedSize = st.st_size;
+    
+    // verify header and entries
+    const char *bytes = static_cast<const char *>(mapped);
+    const Header *header = reinterpret_cast<const Header *>(bytes);
+    if (header->mMagic != sMagic || header->mHash != mHash || header->mNumArrays < 0) return false;
+    std::size_t dataStart = sizeof(Header) + header->mNumArrays * sizeof(FileEntry);
+    if (dataStart > mMappedSize) return false;
+    const FileEntry *entries = reinterpret_cast<const FileEntry *>(bytes + sizeof(Header));
+    const double *data = reinterpret_cast<const double *>(bytes + dataStart);
+    std::size_t ndouble = (mMappedSize - dataStart) / sizeof(double);
+    for (int i = 0; i < header->mNumArrays; i++) {
+        const FileEntry &entry = entries[i];
+        if (entry.mRows < 0 || entry.mCols < 0 || entry.mOffset < 0 || 
+            entry.mOffset + entry.mRows * entry.mCols > ndouble) return false;
+        std::string name(entry.mName, strnlen(entry.mName, sNameLength));
+        mEntries[name] = {data + entry.mOffset, (int)entry.mRows, (int)entry.mCols};
+    }
+    return true;
+}
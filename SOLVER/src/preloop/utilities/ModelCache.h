@@ -0,0 +1,72 @@
+// ModelCache.h
+// created by agent on 19-Oct-2026
+// binary cache of post-processed 3D model data, memory-mapped on read
+
+#pragma once
+
+#include "eigenp.h"
+#include <cstdint>
+#include <map>
+
+class Parameters;
+
+class ModelCache {
+public:
+    ModelCache(const std::string &prefix);
+    ~ModelCache();
+    
+    // feed key
+    void addToKey(const std::string &str);
+    void addToKey(const void *data, std::size_t nbytes);
+    template<typename Type>
+    void addToKey(const Type &value) {addToKey(&value, sizeof(Type));};
+    // size and modification time of a raw input file, taken on root
+    void addFileToKey(const std::string &fname);
+    
+    // map cached arrays, all procs must call
+    // RETURN: false if not cached
+    bool load();
+    
+    // add an array to be stored, only root needs to call
+    void addArray(const std::string &name, const RDMatXX &array);
+    
+    // write arrays to disk and map them, all procs must call
+    // arrays are broadcast from root if the cache is disabled or not writable
+    void store();
+    
+    // view of an array
+    void mapArray(const std::string &name, Eigen::Map<const RDMatXX> &view) const;
+    
+    // settings
+    static void setup(const Parameters &par);
+    
+private:
+    std::string fileName() const;
+    bool write(const std::string &fname) const;
+    bool map(const std::string &fname);
+    
+    // file prefix
+    std::string mPrefix;
+    
+    // 64-bit FNV-1a hash
+    uint64_t mHash;
+    
+    // arrays by name
+    struct Entry {
+        const double *mData;
+        int mRows;
+        int mCols;
+    };
+    std::map<std::string, Entry> mEntries;
+    
+    // mapped file
+    void *mMapped = 0;
+    std::size_t mMappedSize = 0;
+    
+    // arrays owned when not mapped
+    std::map<std::string, RDMatXX> mOwned;
+    
+    // settings
+    static bool sEnabled;
+    static std::string sDirectory;
+};
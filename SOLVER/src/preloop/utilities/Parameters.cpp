@@ -74,20 +74,45 @@ void Parameters::registerAll() {
     registerPar("OUT_STATIONS_FILE");
     registerPar("OUT_STATIONS_SYSTEM");
     registerPar("OUT_STATIONS_FORMAT");
+    registerPar("OUT_STATIONS_COMPRESSION_TOLERANCE");
     registerPar("OUT_STATIONS_COMPONENTS");
     registerPar("OUT_STATIONS_RECORD_INTERVAL");
+    registerPar("OUT_STATIONS_ANTI_ALIAS");
+    registerPar("OUT_STATIONS_STF_NUM");
+    registerPar("OUT_STATIONS_STF_LIST");
     registerPar("OUT_STATIONS_DUMP_INTERVAL");
+    registerPar("OUT_RINGS_FILE");
+    registerPar("OUT_SURFACE_DATABASE");
+    registerPar("OUT_SURFACE_DATABASE_INTERVAL");
+    registerPar("OUT_SURFACE_DATABASE_TOLERANCE");
+    registerPar("OUT_RECIPROCAL_DATABASE");
+    registerPar("OUT_RECIPROCAL_DEPTH_RANGE");
+    registerPar("OUT_RECIPROCAL_DISTANCE_RANGE");
+    registerPar("OUT_RECIPROCAL_DATABASE_INTERVAL");
+    registerPar("OUT_RECIPROCAL_DATABASE_TOLERANCE");
     
     // inparam.advanced
     registerPar("ATTENUATION_CG4");
     registerPar("ATTENUATION_SPECFEM_LEGACY");
     registerPar("ATTENUATION_QKAPPA");
+    registerPar("MODEL_1D_EXODUS_NODE_SHARED");
+    registerPar("MODEL_1D_EXODUS_READ_PER_NODE");
+    registerPar("MODEL_3D_CACHE");
+    registerPar("MODEL_3D_CACHE_DIRECTORY");
     registerPar("DD_BALANCE_ELEMENT_POINT");
     registerPar("DD_NPART_METIS");
     registerPar("DD_COMM_VOL_METIS");
+    registerPar("DD_CACHE_PARTITION");
+    registerPar("DD_CACHE_DIRECTORY");
+    registerPar("DD_COST_LIBRARY");
+    registerPar("DD_COST_LIBRARY_MEASURE");
+    registerPar("DD_REBALANCE_STEPS");
+    registerPar("DD_TUNE_STEPS");
     registerPar("OPTION_VERBOSE_LEVEL");
     registerPar("OPTION_STABILITY_INTERVAL");
     registerPar("OPTION_LOOP_INFO_INTERVAL");
+    registerPar("OPTION_STREAM_RELEASE");
+    registerPar("OPTION_IO_QUEUE_DEPTH");
     registerPar("DEVELOP_MAX_TIME_STEPS");
     registerPar("DEVELOP_NON_SOURCE_MODE");
     registerPar("DEVELOP_DIAGNOSE_PRELOOP");
@@ -4,41 +4,67 @@
 
 #include "PreloopFFTW.h"
 
-int PreloopFFTW::sNmax = 0;
-std::vector<fftw_plan> PreloopFFTW::sR2CPlans;
-std::vector<fftw_plan> PreloopFFTW::sC2RPlans;
-std::vector<RDColX> PreloopFFTW::sR2C_RMats;
-std::vector<CDColX> PreloopFFTW::sR2C_CMats;
-std::vector<RDColX> PreloopFFTW::sC2R_RMats;
-std::vector<CDColX> PreloopFFTW::sC2R_CMats;
+thread_local int PreloopFFTW::sNmax = 0;
+thread_local std::vector<fftw_plan> PreloopFFTW::sR2CPlans;
+thread_local std::vector<fftw_plan> PreloopFFTW::sC2RPlans;
+thread_local std::vector<RDColX> PreloopFFTW::sR2C_RMats;
+thread_local std::vector<CDColX> PreloopFFTW::sR2C_CMats;
+thread_local std::vector<RDColX> PreloopFFTW::sC2R_RMats;
+thread_local std::vector<CDColX> PreloopFFTW::sC2R_CMats;
 
 void PreloopFFTW::checkAndInit(int nr) {
-    if (nr <= sNmax) return;
+    if (nr > sNmax) {
+        // plans are created on demand, so that a few large sizes
+        // (e.g., dense resampling) do not imply plans for all sizes below
+        sR2CPlans.resize(nr, 0);
+        sC2RPlans.resize(nr, 0);
+        sR2C_RMats.resize(nr);
+        sR2C_CMats.resize(nr);
+        sC2R_RMats.resize(nr);
+        sC2R_CMats.resize(nr);
+        sNmax = nr;
+    }
+    if (sR2CPlans[nr - 1]) return;
     int xx = 1;
-    for (int NR = sNmax + 1; NR <= nr; NR++) {
-        int NC = NR / 2 + 1;
-        int n[] = {NR};
-        sR2C_RMats.push_back(RDColX(NR, 1));
-        sR2C_CMats.push_back(CDColX(NC, 1));
-        sC2R_RMats.push_back(RDColX(NR, 1));
-        sC2R_CMats.push_back(CDColX(NC, 1));
+    int NR = nr;
+    int NC = NR / 2 + 1;
+    int n[] = {NR};
+    sR2C_RMats[NR - 1] = RDColX(NR, 1);
+    sR2C_CMats[NR - 1] = CDColX(NC, 1);
+    sC2R_RMats[NR - 1] = RDColX(NR, 1);
+    sC2R_CMats[NR - 1] = CDColX(NC, 1);
+    // fftw planner is not thread-safe
+    #pragma omp critical(fftw_planner)
+    {
         double *r2c_r = &(sR2C_RMats[NR - 1](0, 0));
         ComplexD *r2c_c = &(sR2C_CMats[NR - 1](0, 0));
-        sR2CPlans.push_back(fftw_plan_many_dft_r2c(
-            1, n, xx, r2c_r, n, 1, NR, reinterpret_cast<fftw_complex*>(r2c_c), n, 1, NC, FFTW_ESTIMATE));   
+        sR2CPlans[NR - 1] = fftw_plan_many_dft_r2c(
+            1, n, xx, r2c_r, n, 1, NR, reinterpret_cast<fftw_complex*>(r2c_c), n, 1, NC, FFTW_ESTIMATE);   
         double *c2r_r = &(sC2R_RMats[NR - 1](0, 0));
         ComplexD *c2r_c = &(sC2R_CMats[NR - 1](0, 0));
-        sC2RPlans.push_back(fftw_plan_many_dft_c2r(
-            1, n, xx, reinterpret_cast<fftw_complex*>(c2r_c), n, 1, NC, c2r_r, n, 1, NR, FFTW_ESTIMATE)); 
+        sC2RPlans[NR - 1] = fftw_plan_many_dft_c2r(
+            1, n, xx, reinterpret_cast<fftw_complex*>(c2r_c), n, 1, NC, c2r_r, n, 1, NR, FFTW_ESTIMATE); 
     }
-    sNmax = nr;
 }
 
 void PreloopFFTW::finalize() {
+    // plans of all threads in the pool
+    #pragma omp parallel
+    finalizeThread();
+}
+
+void PreloopFFTW::finalizeThread() {
+    #pragma omp critical(fftw_planner)
     for (int i = 0; i < sNmax; i++) {
-        fftw_destroy_plan(sR2CPlans[i]);
-        fftw_destroy_plan(sC2RPlans[i]);
+        if (sR2CPlans[i]) fftw_destroy_plan(sR2CPlans[i]);
+        if (sC2RPlans[i]) fftw_destroy_plan(sC2RPlans[i]);
     }
+    sR2CPlans.clear();
+    sC2RPlans.clear();
+    sR2C_RMats.clear();
+    sR2C_CMats.clear();
+    sC2R_RMats.clear();
+    sC2R_CMats.clear();
     sNmax = 0;
 }
 
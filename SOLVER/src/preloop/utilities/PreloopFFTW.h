@@ -27,11 +27,15 @@ public:
     static void computeC2R(int nr);
     
 private:
-    static int sNmax;
-    static std::vector<fftw_plan> sR2CPlans;
-    static std::vector<fftw_plan> sC2RPlans;
-    static std::vector<RDColX> sR2C_RMats;
-    static std::vector<CDColX> sR2C_CMats;
-    static std::vector<RDColX> sC2R_RMats;
-    static std::vector<CDColX> sC2R_CMats;
+    // finalize plans of calling thread
+    static void finalizeThread();
+    
+    // plans and buffers are per thread in a threaded preloop
+    static thread_local int sNmax;
+    static thread_local std::vector<fftw_plan> sR2CPlans;
+    static thread_local std::vector<fftw_plan> sC2RPlans;
+    static thread_local std::vector<RDColX> sR2C_RMats;
+    static thread_local std::vector<CDColX> sR2C_CMats;
+    static thread_local std::vector<RDColX> sC2R_RMats;
+    static thread_local std::vector<CDColX> sC2R_CMats;
 };
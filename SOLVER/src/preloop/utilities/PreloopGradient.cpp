@@ -14,7 +14,8 @@ mInv_s(inv_s), mAxial(axial) {
 }
 
 void PreloopGradient::gradScalar(const vec_CDMatPP &u, vec_ar3_CDMatPP &u_i, int Nu, int nyquist) const {
-    static CDMatPP GU, UG;
+    // locals: called concurrently from the threaded local build
+    CDMatPP GU, UG;
     for (int alpha = 0; alpha <= Nu - nyquist; alpha++) {
         ComplexD iialpha = (double)alpha * iid;
         GU = (mAxial ? sGT_GLJ : sGT_GLL) * u[alpha];  
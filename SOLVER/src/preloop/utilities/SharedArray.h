@@ -0,0 +1,26 @@
+// SharedArray.h
+// created by agent on 19-Oct-2026
+// view of an array in node-shared memory
+
+#pragma once
+
+template<typename Type>
+class SharedArray {
+public:
+    SharedArray(Type *data = 0, int size = 0): mData(data), mSize(size) {};
+    
+    // element access
+    const Type &operator[](int index) const {return mData[index];};
+    Type &operator[](int index) {return mData[index];};
+    
+    // raw
+    int size() const {return mSize;};
+    const Type *data() const {return mData;};
+    Type *data() {return mData;};
+    
+private:
+    // memory owned by allocator
+    Type *mData;
+    int mSize;
+};
+
@@ -9,6 +9,13 @@
 
 XMPI::root_cout XMPI::cout;
 std::string XMPI::endl = "\n";
+bool XMPI::sThreadFunneled = true;
+
+#ifndef _SERIAL_BUILD
+    MPI_Comm XMPI::sCommNode = MPI_COMM_NULL;
+    MPI_Comm XMPI::sCommNodeRoots = MPI_COMM_NULL;
+    std::map<void *, MPI_Win> XMPI::sWindows;
+#endif
 
 extern "C" {
     #include <sys/types.h>
@@ -31,7 +38,11 @@ void XMPI::mkdir(const std::string &path) {
 
 void XMPI::initialize(int argc, char *argv[]) {
     #ifndef _SERIAL_BUILD
-        MPI_Init(NULL, NULL);
+        // IOThread never calls MPI
+        int provided;
+        MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
+        // but it must be allowed to exist
+        sThreadFunneled = provided >= MPI_THREAD_FUNNELED;
     #endif
     std::string argv0(argv[0]);
     std::string execDirectory = argv0.substr(0, argv0.length() - 9);
@@ -51,6 +62,8 @@ void XMPI::initialize(int argc, char *argv[]) {
 
 void XMPI::finalize() {
     #ifndef _SERIAL_BUILD
+        if (sCommNode != MPI_COMM_NULL) MPI_Comm_free(&sCommNode);
+        if (sCommNodeRoots != MPI_COMM_NULL) MPI_Comm_free(&sCommNodeRoots);
         MPI_Finalize();
     #endif
 }
@@ -358,3 +371,92 @@ void XMPI::gather(const std::vector<std::string> &buf,
     }
 }
 
+void XMPI::setupNodeShared(bool shared) {
+    #ifndef _SERIAL_BUILD
+        if (sWindows.size() > 0) throw std::runtime_error("XMPI::setupNodeShared || "
+            "Cannot change node communicators with shared memory in use.");
+        if (sCommNode != MPI_COMM_NULL) MPI_Comm_free(&sCommNode);
+        if (sCommNodeRoots != MPI_COMM_NULL) MPI_Comm_free(&sCommNodeRoots);
+        // ranks sharing memory; keyed by world rank so that world root is a node root
+        if (shared) 
+            MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank(), MPI_INFO_NULL, &sCommNode);
+        else 
+            MPI_Comm_split(MPI_COMM_WORLD, rank(), 0, &sCommNode);
+        // node roots
+        int nodeRank;
+        MPI_Comm_rank(sCommNode, &nodeRank);
+        MPI_Comm_split(MPI_COMM_WORLD, nodeRank == 0 ? 0 : MPI_UNDEFINED, rank(), &sCommNodeRoots);
+    #endif
+}
+
+bool XMPI::nodeRoot() {
+    #ifndef _SERIAL_BUILD
+        if (sCommNode == MPI_COMM_NULL) return true;
+        int nodeRank;
+        MPI_Comm_rank(sCommNode, &nodeRank);
+        return nodeRank == 0;
+    #else
+        return true;
+    #endif
+}
+
+void XMPI::barrierNode() {
+    #ifndef _SERIAL_BUILD
+        if (sCommNode == MPI_COMM_NULL) return;
+        // make writes of node root visible
+        for (auto it = sWindows.begin(); it != sWindows.end(); it++) MPI_Win_sync(it->second);
+        MPI_Barrier(sCommNode);
+        for (auto it = sWindows.begin(); it != sWindows.end(); it++) MPI_Win_sync(it->second);
+    #endif
+}
+
+void *XMPI::allocNodeShared(std::size_t nbytes) {
+    #ifndef _SERIAL_BUILD
+        if (sCommNode == MPI_COMM_NULL) setupNodeShared(false);
+        // at least one byte to get a distinct address
+        MPI_Aint size = nodeRoot() ? std::max(nbytes, (std::size_t)1) : 0;
+        void *ptr = 0;
+        MPI_Win win;
+        MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, sCommNode, &ptr, &win);
+        // address of node root
+        MPI_Aint sizeRoot;
+        int dispUnit;
+        MPI_Win_shared_query(win, 0, &sizeRoot, &dispUnit, &ptr);
+        // passive epoch for MPI_Win_sync
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+        sWindows.insert(std::make_pair(ptr, win));
+        return ptr;
+    #else
+        return new char[std::max(nbytes, (std::size_t)1)];
+    #endif
+}
+
+void XMPI::freeNodeShared(void *ptr) {
+    #ifndef _SERIAL_BUILD
+        auto it = sWindows.find(ptr);
+        if (it == sWindows.end()) throw std::runtime_error("XMPI::freeNodeShared || "
+            "Memory not allocated by allocNodeShared.");
+        MPI_Win win = it->second;
+        sWindows.erase(it);
+        MPI_Win_unlock_all(win);
+        MPI_Win_free(&win);
+    #else
+        delete [] static_cast<char *>(ptr);
+    #endif
+}
+
+void XMPI::bcastNodeRoots(int *buffer, int size) {
+    #ifndef _SERIAL_BUILD
+        // every rank is a node root before setup
+        MPI_Comm comm = (sCommNode == MPI_COMM_NULL) ? MPI_COMM_WORLD : sCommNodeRoots;
+        MPI_Bcast(buffer, size, MPI_INT, 0, comm);
+    #endif
+}
+
+void XMPI::bcastNodeRoots(double *buffer, int size) {
+    #ifndef _SERIAL_BUILD
+        // every rank is a node root before setup
+        MPI_Comm comm = (sCommNode == MPI_COMM_NULL) ? MPI_COMM_WORLD : sCommNodeRoots;
+        MPI_Bcast(buffer, size, MPI_DOUBLE, 0, comm);
+    #endif
+}
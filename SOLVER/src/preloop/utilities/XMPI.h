@@ -50,6 +50,9 @@ public:
     
     static bool root() {return rank() == 0;};
     
+    // whether a non-MPI thread may run beside the main thread
+    static bool threadFunneled() {return sThreadFunneled;};
+    
     // barrier
     static void barrier() {
         #ifndef _SERIAL_BUILD
@@ -281,6 +284,16 @@ public:
             value = total;
         #endif
     };
+    
+    // min Eigen::Matrix
+    template<typename Type>
+    static void minEigenInt(Type &value) {
+        #ifndef _SERIAL_BUILD
+            Type total(value);
+            MPI_Allreduce(value.data(), total.data(), value.size(), MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+            value = total;
+        #endif
+    };
         
     ////////////////////////////// stream on root //////////////////////////////
     struct root_cout {
@@ -299,10 +312,37 @@ public:
     static root_cout cout;
     static std::string endl;
     
+    ////////////////////////////// node-shared memory //////////////////////////////
+    // ranks on a node share one copy of large read-only data
+    // with shared = false, every rank is a node of its own
+    static void setupNodeShared(bool shared);
+    static bool nodeRoot();
+    static void barrierNode();
+    
+    // allocate on node root and map on the other ranks of the node
+    // collective on node; free before finalize
+    static void *allocNodeShared(std::size_t nbytes);
+    static void freeNodeShared(void *ptr);
+    
+    // bcast from world root to node roots, only node roots may call
+    static void bcastNodeRoots(int *buffer, int size);
+    static void bcastNodeRoots(double *buffer, int size);
+    
     ////////////////////////////// dir utils //////////////////////////////
     static bool dirExists(const std::string &path);
     static void mkdir(const std::string &path);
     
+private:
+    // thread support provided by MPI
+    static bool sThreadFunneled;
+    
+    #ifndef _SERIAL_BUILD
+        // node and node-root communicators
+        static MPI_Comm sCommNode;
+        static MPI_Comm sCommNodeRoots;
+        // shared windows
+        static std::map<void *, MPI_Win> sWindows;
+    #endif
 };
 
 // message info
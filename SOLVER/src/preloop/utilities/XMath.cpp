@@ -126,6 +126,18 @@ RDCol3 XMath::rotateSrc2Glob(const RDCol3 &rtpS, double srclat, double srclon, d
     return rtpG;
 }
 
+RDMatX3 XMath::rotateSrc2GlobBatch(const RDMatX3 &rtpS, double srclat, double srclon, double srcdep) {
+    const RDMat33 &rot = rotationMatrix(lat2Theta(srclat, srcdep), lon2Phi(srclon));
+    RDMatX3 rtpG(rtpS.rows(), 3);
+    for (int i = 0; i < rtpS.rows(); i++) {
+        const RDCol3 &xyzG = rot * toCartesian(rtpS.row(i).transpose());
+        bool defined;
+        rtpG.row(i) = toSpherical(xyzG, defined).transpose();
+        if (!defined) rtpG(i, 2) = rtpS(i, 2);
+    }
+    return rtpG;
+}
+
 RDCol3 XMath::rotateGlob2Src(const RDCol3 &rtpG, double srclat, double srclon, double srcdep) {
     const RDCol3 &xyzG = toCartesian(rtpG);
     const RDCol3 &xyzS = rotationMatrix(lat2Theta(srclat, srcdep), lon2Phi(srclon)).transpose() * xyzG;
@@ -197,35 +209,47 @@ void XMath::interpLagrange(double target, int nbases, const double *bases, doubl
 
 void XMath::gaussianSmoothing(RDColX &data, int order, double dev, bool period) {
     if (order <= 0) return;
-    order = std::min(order, (int)((data.size() + 1) / 2 - 1));
+    int nsize = data.size();
+    order = std::min(order, (int)((nsize + 1) / 2 - 1));
+    if (order <= 0) return;
     dev *= order;
     
-    // gaussian kernel
-    RDColX gaussian(order * 2 + 1);
-    for (int i = 0; i <= order; i++) {
-        gaussian(order + i) = exp(- .5 * i * i / (dev * dev));
-        gaussian(order - i) = gaussian(order + i);
+    // circular convolution by spectral multiplication;
+    // fixed padding of the ends is realized by extending the data
+    // with edge values, which avoids wraparound of the kernel
+    int nfft = period ? nsize : nextLuckyNumber(nsize + 2 * order);
+    int shift = period ? 0 : order;
+    
+    // spectrum of gaussian kernel, reused for identical calls
+    thread_local int lastSize = -1, lastOrder = -1;
+    thread_local double lastDev = -1.;
+    thread_local RDColX kernelSpec;
+    if (nfft != lastSize || order != lastOrder || dev != lastDev) {
+        RDColX &kernel = PreloopFFTW::getR2C_RMat(nfft);
+        kernel.setZero();
+        for (int i = -order; i <= order; i++) 
+            kernel((i + nfft) % nfft) += exp(- .5 * i * i / (dev * dev));
+        kernel /= kernel.sum();
+        PreloopFFTW::computeR2C(nfft);
+        // symmetric kernel, real spectrum
+        kernelSpec = PreloopFFTW::getR2C_CMat(nfft).real() * (double)nfft;
+        lastSize = nfft;
+        lastOrder = order;
+        lastDev = dev;
     }
-    gaussian /= gaussian.sum();
     
     // convolve
-    RDColX result = RDColX::Zero(data.size());
-    for (int i = 0; i < data.size(); i++) {
-        for (int j = -order; j <= order; j++) {
-            int k = i + j;
-            if (period) {
-                while (k < 0) k += data.size();
-                while (k > data.size() - 1) k -= data.size();
-            } else {
-                // using fixed padding
-                if (k < 0) k = 0;
-                if (k > data.size() - 1) k = data.size() - 1;
-            }
-            result(i) += gaussian(j + order) * data(k);
-        }
-    }
+    RDColX &input = PreloopFFTW::getR2C_RMat(nfft);
+    input.setConstant(data(nsize - 1));
+    input.topRows(shift).setConstant(data(0));
+    input.segment(shift, nsize) = data;
+    PreloopFFTW::computeR2C(nfft);
+    PreloopFFTW::getC2R_CMat(nfft) = PreloopFFTW::getR2C_CMat(nfft).cwiseProduct(
+        kernelSpec.cast<ComplexD>());
+    PreloopFFTW::computeC2R(nfft);
+    
     // assign
-    data = result;
+    data = PreloopFFTW::getC2R_RMat(nfft).segment(shift, nsize);
 }
 
 void XMath::gaussianSmoothing(RDMatXX &data, 
@@ -299,21 +323,23 @@ RDColX XMath::trigonResampling(int newSize, const RDColX &original) {
     // fft
     PreloopFFTW::getR2C_RMat(nslices) = original;
     PreloopFFTW::computeR2C(nslices);
-    CDColX &fourier = PreloopFFTW::getR2C_CMat(nslices);
+    const CDColX &fourier = PreloopFFTW::getR2C_CMat(nslices);
     
-    // densed sampling
-    double dphi = 2. * pi / newSize;
-    RDColX densed(newSize);
-    for (int islice = 0; islice < newSize; islice++) {
-        double phi = islice * dphi;
-        double value_phi = fourier(0).real();
-        for (int alpha = 1; alpha < fourier.size(); alpha++) {
-            double factor = (nslices % 2 == 0 && alpha == fourier.size() - 1) ? 1. : 2.;
-            value_phi += factor * (fourier(alpha) * exp(alpha * phi * iid)).real();
-        }
-        densed(islice) = value_phi;
+    // fold the series onto the newSize discrete frequencies, 
+    // i.e., zero padding for upsampling and aliasing for downsampling
+    CDColX spectrum = CDColX::Zero(newSize);
+    spectrum(0) += fourier(0).real();
+    for (int alpha = 1; alpha < fourier.size(); alpha++) {
+        double factor = (nslices % 2 == 0 && alpha == fourier.size() - 1) ? .5 : 1.;
+        spectrum(alpha % newSize) += factor * fourier(alpha);
+        spectrum((newSize - alpha % newSize) % newSize) += factor * std::conj(fourier(alpha));
     }
-    return densed; 
+    
+    // densed sampling by inverse fft
+    CDColX &half = PreloopFFTW::getC2R_CMat(newSize);
+    half = spectrum.topRows(newSize / 2 + 1);
+    PreloopFFTW::computeC2R(newSize);
+    return PreloopFFTW::getC2R_RMat(newSize); 
 }
 
 RDColX XMath::linearResampling(int newSize, const RDColX &original) {
@@ -336,6 +362,19 @@ RDColX XMath::linearResampling(int newSize, const RDColX &original) {
     return densed; 
 }
 
+RDColX XMath::lowpassFIR(int halfLength, double cutoff) {
+    int len = 2 * halfLength + 1;
+    RDColX taps(len);
+    for (int i = 0; i < len; i++) {
+        double x = i - halfLength;
+        double sinc = (i == halfLength) ? 2. * cutoff : sin(2. * pi * cutoff * x) / (pi * x);
+        double w = 2. * pi * i / (len - 1);
+        double blackman = .42 - .5 * cos(w) + .08 * cos(2. * w);
+        taps(i) = sinc * blackman;
+    }
+    return taps / taps.sum();
+}
+
 RDRowN XMath::computeFourierAtPhi(const RDMatXN &data, double phi) {
     int nslices = data.rows();
     RDRowN result;
@@ -371,13 +410,20 @@ void XMath::setEllipticity(double flattening, double router,
 }
 
 double XMath::getFlattening(double r) {
+    double dfdr;
+    return getFlattening(r, dfdr);
+}
+
+double XMath::getFlattening(double r, double &dfdr) {
     double f = 1.;
+    dfdr = 0.;
     double r1 = r / sROuter;
     int nknots = sEllipKnots.size();
     for (int i = 1; i < nknots; i++) {
         if (r1 <= sEllipKnots(i)) {
-            f = (sEllipCoeffs(i) - sEllipCoeffs(i - 1)) / (sEllipKnots(i) - sEllipKnots(i - 1))
-                * (r1 - sEllipKnots(i - 1)) + sEllipCoeffs(i - 1);
+            double slope = (sEllipCoeffs(i) - sEllipCoeffs(i - 1)) / (sEllipKnots(i) - sEllipKnots(i - 1));
+            f = slope * (r1 - sEllipKnots(i - 1)) + sEllipCoeffs(i - 1);
+            dfdr = slope / sROuter * sFlattening;
             break;
         }
     }
@@ -34,6 +34,8 @@ public:
     static double phi2Lon(double lon);
     // source-centered to globe
     static RDCol3 rotateSrc2Glob(const RDCol3 &rtpS, double srclat, double srclon, double srcdep);
+    // source-centered to globe, one point per row, rotation matrix formed once
+    static RDMatX3 rotateSrc2GlobBatch(const RDMatX3 &rtpS, double srclat, double srclon, double srcdep);
     // globe to source-centered
     static RDCol3 rotateGlob2Src(const RDCol3 &rtpG, double srclat, double srclon, double srcdep);
     // compute back azimuth (copied from specfem)
@@ -49,7 +51,7 @@ public:
     // Lagrange interpolation
     static void interpLagrange(double target, int nbases, const double *bases, double *results);
     
-    // Gaussian smoothing
+    // Gaussian smoothing, by spectral multiplication
     static void gaussianSmoothing(RDColX &data, int order, double dev, bool period);
     static void gaussianSmoothing(RDMatXX &data, 
         IColX orderRow, RDColX devRow, bool periodRow, 
@@ -86,13 +88,32 @@ public:
         return equal;
     };
     
-    // resampling
+    // resampling, trigonometric by zero-padded inverse FFT
     static RDColX trigonResampling(int newSize, const RDColX &original);
     static RDColX linearResampling(int newSize, const RDColX &original);
     
+    // linear-phase lowpass FIR, Blackman-windowed sinc with unit DC gain
+    // cutoff in cycles per sample; 2 * halfLength + 1 symmetric taps
+    static RDColX lowpassFIR(int halfLength, double cutoff);
+    
     // Fourier
     static RDRowN computeFourierAtPhi(const RDMatXN &data, double phi);
     
+    /////////////// flat buffer ////////////////
+    // append to and extract from a flat buffer
+    // matrix sizes must be known by both sides
+    template<class TMat>
+    static void pack(const TMat &mat, std::vector<double> &buffer) {
+        buffer.insert(buffer.end(), mat.data(), mat.data() + mat.size());
+    };
+    template<class TMat>
+    static void unpack(TMat &mat, const RDColX &buffer, int &pos) {
+        if (pos + mat.size() > buffer.size()) 
+            throw std::runtime_error("XMath::unpack || Buffer underflow.");
+        mat = Eigen::Map<const TMat>(buffer.data() + pos, mat.rows(), mat.cols());
+        pos += mat.size();
+    };
+    
     /////////////// string cast ////////////////
     template<typename parType>
     static void castValue(parType &result, const std::string &val_in, const std::string &source) {
@@ -116,6 +137,8 @@ public:
         const std::vector<double> &ellip_knots, 
         const std::vector<double> &ellip_coeffs);
     static double getFlattening(double r);
+    // with radial derivative
+    static double getFlattening(double r, double &dfdr);
     static double getFlattening() {return sFlattening;};
     static double getROuter() {return sROuter;};
 private: